@@ -111,6 +111,9 @@ static const int ANIM_ENTRY_NAME_MAX = ANIM_PATH_MAX + 1;
 static const int MAX_CHECK_EXIT_INTERVAL_US = 50000;
 static constexpr size_t TEXT_POS_LEN_MAX = 16;
 static const int DYNAMIC_COLOR_COUNT = 4;
+// Frames are decoded on this many threads, at most this many frames ahead of the one shown.
+static const size_t FRAME_DECODE_THREAD_COUNT = 2;
+static const size_t FRAME_DECODE_AHEAD_COUNT = 3;
 static const char U_TEXTURE[] = "uTexture";
 static const char U_FADE[] = "uFade";
 static const char U_CROP_AREA[] = "uCropArea";
@@ -345,32 +348,58 @@ status_t BootAnimation::initTexture(Texture* texture, AssetManager& assets,
     return NO_ERROR;
 }
 
-status_t BootAnimation::initTexture(FileMap* map, int* width, int* height,
-    bool premultiplyAlpha) {
+static_assert(RAW_FRAME_FORMAT_RGBA_8888 == ANDROID_BITMAP_FORMAT_RGBA_8888);
+static_assert(RAW_FRAME_FORMAT_RGB_565 == ANDROID_BITMAP_FORMAT_RGB_565);
+
+static bool decodeFrame(FileMap* map, bool premultiplyAlpha, DecodedFrame* out) {
     ATRACE_CALL();
+    if (isRawFrame(map->getDataPtr(), map->getDataLength())) {
+        // Raw frames are stored with alpha unpremultiplied, so "premultiplyAlpha" is ignored.
+        return parseRawFrame(map->getDataPtr(), map->getDataLength(), out);
+    }
+
     AndroidBitmapInfo bitmapInfo;
     void* pixels = decodeImage(map->getDataPtr(), map->getDataLength(), &bitmapInfo,
         premultiplyAlpha);
-    auto pixelDeleter = std::unique_ptr<void, decltype(free)*>{ pixels, free };
+    if (!pixels) {
+        return false;
+    }
+    out->width = bitmapInfo.width;
+    out->height = bitmapInfo.height;
+    out->stride = bitmapInfo.stride;
+    out->format = bitmapInfo.format;
+    out->pixels = pixels;
+    out->buffer.reset(pixels);
+    return true;
+}
+
+status_t BootAnimation::initTexture(FileMap* map, int* width, int* height,
+    bool premultiplyAlpha) {
+    ATRACE_CALL();
+    DecodedFrame frame;
+    const bool decoded = decodeFrame(map, premultiplyAlpha, &frame);
+    const status_t result = decoded ? initTexture(frame, width, height) : NO_INIT;
 
     // FileMap memory is never released until application exit.
     // Release it now as the texture is already loaded and the memory used for
     // the packed resource can be released.
     delete map;
 
-    if (!pixels) {
-        return NO_INIT;
-    }
+    return result;
+}
 
-    const int w = bitmapInfo.width;
-    const int h = bitmapInfo.height;
+status_t BootAnimation::initTexture(const DecodedFrame& frame, int* width, int* height) {
+    ATRACE_CALL();
+    const void* pixels = frame.pixels;
+    const int w = frame.width;
+    const int h = frame.height;
 
     int tw = 1 << (31 - __builtin_clz(w));
     int th = 1 << (31 - __builtin_clz(h));
     if (tw < w) tw <<= 1;
     if (th < h) th <<= 1;
 
-    switch (bitmapInfo.format) {
+    switch (frame.format) {
         case ANDROID_BITMAP_FORMAT_RGBA_8888:
             if (!mUseNpotTextures && (tw != w || th != h)) {
                 glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tw, th, 0, GL_RGBA,
@@ -1473,7 +1502,18 @@ bool BootAnimation::movie() {
         initDynamicColors();
     }
 
+    std::vector<const Animation::Frame*> frames;
+    collectFramesToDecode(*mAnimation, &frames);
+    mFrameDecoder = std::make_unique<FrameDecoder>(frames.size(),
+            [frames](size_t index, DecodedFrame* out) {
+                // Set decoding option to alpha unpremultiplied so that the R, G, B channels
+                // of transparent pixels are preserved.
+                return decodeFrame(frames[index]->map, false /* don't premultiply alpha */, out);
+            },
+            FRAME_DECODE_THREAD_COUNT, FRAME_DECODE_AHEAD_COUNT);
+
     playAnimation(*mAnimation);
+    mFrameDecoder.reset();
 
     if (mTimeCheckThread != nullptr) {
         mTimeCheckThread->requestExit();
@@ -1652,9 +1692,13 @@ bool BootAnimation::playAnimation(const Animation& animation) {
                         glBindTexture(GL_TEXTURE_2D, frame.tid);
                     }
                     int w, h;
-                    // Set decoding option to alpha unpremultiplied so that the R, G, B channels
-                    // of transparent pixels are preserved.
-                    initTexture(frame.map, &w, &h, false /* don't premultiply alpha */);
+                    DecodedFrame decoded;
+                    if (mFrameDecoder->take(frame.decodeIndex, &decoded)) {
+                        initTexture(decoded, &w, &h);
+                    }
+                    // Frames are taken in the order they are decoded, so no decoder thread is
+                    // still reading this one.
+                    delete frame.map;
                 }
 
                 const int trimWidth = frame.trimWidth * ratio_w;
@@ -1769,6 +1813,24 @@ bool BootAnimation::playAnimation(const Animation& animation) {
     return true;
 }
 
+// Lists the frames that playAnimation() decodes, in the order it decodes them: each frame of
+// each part, including those of nested animations, when the part is first played.
+void BootAnimation::collectFramesToDecode(Animation& animation,
+        std::vector<const Animation::Frame*>* frames) const {
+    for (size_t i = 0; i < animation.parts.size(); i++) {
+        Animation::Part& part(animation.parts.editItemAt(i));
+        if (part.animation != nullptr) {
+            collectFramesToDecode(*part.animation, frames);
+            continue;
+        }
+        for (size_t j = 0; j < part.frames.size(); j++) {
+            Animation::Frame& frame(part.frames.editItemAt(j));
+            frame.decodeIndex = frames->size();
+            frames->push_back(&frame);
+        }
+    }
+}
+
 void BootAnimation::processDisplayEvents() {
     ATRACE_CALL();
     // This will poll mDisplayEventReceiver and if there are new events it'll call
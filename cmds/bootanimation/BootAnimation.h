@@ -32,6 +32,8 @@
 
 #include <ui/Rotation.h>
 
+#include "FrameDecoder.h"
+
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
 
@@ -69,6 +71,7 @@ public:
             int trimY;
             int trimWidth;
             int trimHeight;
+            int decodeIndex = -1;  // the position of the frame in the order frames are decoded
             mutable GLuint tid;
             bool operator < (const Frame& rhs) const {
                 return name < rhs.name;
@@ -179,6 +182,7 @@ private:
         bool premultiplyAlpha = true);
     status_t initTexture(FileMap* map, int* width, int* height,
         bool premultiplyAlpha = true);
+    status_t initTexture(const DecodedFrame& frame, int* width, int* height);
     status_t initFont(Font* font, const char* fallback);
     void initShaders();
     bool android();
@@ -192,6 +196,8 @@ private:
     bool validClock(const Animation::Part& part);
     Animation* loadAnimation(const String8&);
     bool playAnimation(const Animation&);
+    void collectFramesToDecode(Animation& animation,
+        std::vector<const Animation::Frame*>* frames) const;
     void releaseAnimation(Animation*) const;
     bool parseAnimationDesc(Animation&);
     bool preloadZip(Animation &animation);
@@ -240,6 +246,7 @@ private:
     sp<TimeCheckThread> mTimeCheckThread = nullptr;
     sp<Callbacks> mCallbacks;
     Animation* mAnimation = nullptr;
+    std::unique_ptr<FrameDecoder> mFrameDecoder;
     GLuint mImageShader;
     GLuint mTextShader;
     GLuint mImageFadeLocation;
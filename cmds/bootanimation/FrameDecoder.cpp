@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameDecoder.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace android {
+
+static uint32_t readLittleEndian32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+bool isRawFrame(const void* data, size_t length) {
+    return length >= RAW_FRAME_HEADER_SIZE &&
+            memcmp(data, RAW_FRAME_MAGIC, sizeof(RAW_FRAME_MAGIC)) == 0;
+}
+
+bool parseRawFrame(const void* data, size_t length, DecodedFrame* out) {
+    if (!isRawFrame(data, length)) {
+        return false;
+    }
+    const uint8_t* header = static_cast<const uint8_t*>(data);
+    const uint32_t width = readLittleEndian32(header + 4);
+    const uint32_t height = readLittleEndian32(header + 8);
+    const int32_t format = readLittleEndian32(header + 12);
+
+    uint64_t bytesPerPixel;
+    switch (format) {
+        case RAW_FRAME_FORMAT_RGBA_8888:
+            bytesPerPixel = 4;
+            break;
+        case RAW_FRAME_FORMAT_RGB_565:
+            bytesPerPixel = 2;
+            break;
+        default:
+            return false;
+    }
+    // Rows are padded to 4 bytes, which is what GL expects by default.
+    const uint64_t stride = (width * bytesPerPixel + 3) & ~3ull;
+    if (width == 0 || height == 0 || stride * height > length - RAW_FRAME_HEADER_SIZE) {
+        return false;
+    }
+
+    out->width = width;
+    out->height = height;
+    out->stride = stride;
+    out->format = format;
+    out->pixels = header + RAW_FRAME_HEADER_SIZE;
+    out->buffer.reset();
+    return true;
+}
+
+FrameDecoder::FrameDecoder(size_t frameCount, DecodeFunction decode, size_t threadCount,
+        size_t capacity)
+      : mFrameCount(frameCount), mDecode(std::move(decode)), mSlots(std::max<size_t>(capacity, 1)) {
+    threadCount = std::min(std::max<size_t>(threadCount, 1), mSlots.size());
+    for (size_t i = 0; i < threadCount; i++) {
+        mThreads.emplace_back(&FrameDecoder::threadLoop, this);
+    }
+}
+
+FrameDecoder::~FrameDecoder() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopping = true;
+    }
+    mCondition.notify_all();
+    for (std::thread& thread : mThreads) {
+        thread.join();
+    }
+}
+
+bool FrameDecoder::take(size_t index, DecodedFrame* out) {
+    std::unique_lock<std::mutex> lock(mLock);
+    if (index < mNextToTake || index >= mFrameCount) {
+        return false;
+    }
+    if (index > mNextToTake) {
+        // Drop what was decoded for the frames passed over, and skip those not started yet.
+        for (Slot& slot : mSlots) {
+            if (slot.ready && slot.index < index) {
+                slot.ready = false;
+                slot.frame = DecodedFrame();
+            }
+        }
+        mNextToTake = index;
+        mNextToDecode = std::max(mNextToDecode, index);
+        mCondition.notify_all();
+    }
+
+    Slot& slot = mSlots[index % mSlots.size()];
+    mCondition.wait(lock, [&slot, index] { return slot.ready && slot.index == index; });
+    *out = std::move(slot.frame);
+    slot.ready = false;
+    mNextToTake = index + 1;
+    mCondition.notify_all();
+    return slot.decoded;
+}
+
+void FrameDecoder::threadLoop() {
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true) {
+        mCondition.wait(lock, [this] {
+            return mStopping || mNextToDecode >= mFrameCount ||
+                    mNextToDecode < mNextToTake + mSlots.size();
+        });
+        if (mStopping || mNextToDecode >= mFrameCount) {
+            return;
+        }
+        const size_t index = mNextToDecode++;
+
+        lock.unlock();
+        DecodedFrame frame;
+        const bool decoded = mDecode(index, &frame);
+        lock.lock();
+
+        if (index < mNextToTake) {
+            continue;  // passed over while it was being decoded
+        }
+        Slot& slot = mSlots[index % mSlots.size()];
+        slot.index = index;
+        slot.ready = true;
+        slot.decoded = decoded;
+        slot.frame = std::move(frame);
+        mCondition.notify_all();
+    }
+}
+
+}; // namespace android
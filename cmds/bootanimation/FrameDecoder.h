@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_BOOTANIMATION_FRAMEDECODER_H
+#define ANDROID_BOOTANIMATION_FRAMEDECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace android {
+
+// The pixels of a frame, ready to be uploaded.
+struct DecodedFrame {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t stride = 0;  // bytes from one row to the next
+    int32_t format = 0;   // an ANDROID_BITMAP_FORMAT_* value
+    const void* pixels = nullptr;
+    // Owns the pixels if they were decoded, rather than found in a raw frame.
+    std::unique_ptr<void, decltype(free)*> buffer{nullptr, free};
+};
+
+// Pre-decoded frames, see FORMAT.md.
+static constexpr char RAW_FRAME_MAGIC[4] = {'B', 'R', 'A', 'W'};
+static constexpr size_t RAW_FRAME_HEADER_SIZE = 16;
+static constexpr int32_t RAW_FRAME_FORMAT_RGBA_8888 = 1;
+static constexpr int32_t RAW_FRAME_FORMAT_RGB_565 = 4;
+
+bool isRawFrame(const void* data, size_t length);
+
+// Points "out" at the pixels of the raw frame in "data", which must outlive it. Returns false if
+// it is not a well formed raw frame.
+bool parseRawFrame(const void* data, size_t length, DecodedFrame* out);
+
+// Decodes the frames of an animation on worker threads, in the order they are played, into a
+// ring of at most "capacity" frames ahead of the one being shown, so that decoding a frame does
+// not have to fit in the time between showing it and the one before.
+class FrameDecoder {
+public:
+    // Decodes frame "index" into "out", returning false if it cannot be decoded. Called on the
+    // worker threads.
+    using DecodeFunction = std::function<bool(size_t index, DecodedFrame* out)>;
+
+    FrameDecoder(size_t frameCount, DecodeFunction decode, size_t threadCount, size_t capacity);
+    ~FrameDecoder();
+
+    // Waits for frame "index" to be decoded and moves it into "out". Frames must be taken in
+    // increasing order; frames that are passed over are dropped, and no longer decoded.
+    // Returns false if the frame could not be decoded, or was passed over already.
+    bool take(size_t index, DecodedFrame* out);
+
+private:
+    struct Slot {
+        size_t index = 0;
+        bool ready = false;
+        bool decoded = false;
+        DecodedFrame frame;
+    };
+
+    void threadLoop();
+
+    const size_t mFrameCount;
+    const DecodeFunction mDecode;
+
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    std::vector<Slot> mSlots;  // frame i goes into mSlots[i % mSlots.size()]
+    size_t mNextToDecode = 0;
+    size_t mNextToTake = 0;
+    bool mStopping = false;
+
+    std::vector<std::thread> mThreads;
+};
+
+}; // namespace android
+
+#endif // ANDROID_BOOTANIMATION_FRAMEDECODER_H
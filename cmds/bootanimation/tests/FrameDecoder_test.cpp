@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameDecoder.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace android {
+
+namespace {
+
+// Stands in for decoding a PNG: takes "delay", then produces one pixel holding the index.
+class FakeDecoder {
+public:
+    explicit FakeDecoder(std::chrono::milliseconds delay) : mDelay(delay) {}
+
+    FrameDecoder::DecodeFunction function() {
+        return [this](size_t index, DecodedFrame* out) {
+            const int inFlight = ++mInFlight;
+            int maxInFlight = mMaxInFlight;
+            while (inFlight > maxInFlight && !mMaxInFlight.compare_exchange_weak(maxInFlight,
+                                                                                  inFlight)) {
+            }
+            std::this_thread::sleep_for(mDelay);
+            mDecoded++;
+            mInFlight--;
+            if (index == mFailingIndex) {
+                return false;
+            }
+            uint32_t* pixel = static_cast<uint32_t*>(malloc(sizeof(uint32_t)));
+            *pixel = index;
+            out->width = out->height = 1;
+            out->stride = sizeof(uint32_t);
+            out->format = RAW_FRAME_FORMAT_RGBA_8888;
+            out->pixels = pixel;
+            out->buffer.reset(pixel);
+            return true;
+        };
+    }
+
+    std::chrono::milliseconds mDelay;
+    size_t mFailingIndex = SIZE_MAX;
+    std::atomic<int> mInFlight = 0;
+    std::atomic<int> mMaxInFlight = 0;
+    std::atomic<int> mDecoded = 0;
+};
+
+uint32_t pixelOf(const DecodedFrame& frame) {
+    return *static_cast<const uint32_t*>(frame.pixels);
+}
+
+std::string makeRawFrame(uint32_t width, uint32_t height, int32_t format, size_t pixelBytes) {
+    std::string data(RAW_FRAME_MAGIC, sizeof(RAW_FRAME_MAGIC));
+    for (uint32_t value : {width, height, static_cast<uint32_t>(format)}) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            data.push_back(static_cast<char>(value >> shift));
+        }
+    }
+    data.append(pixelBytes, '\x7f');
+    return data;
+}
+
+} // namespace
+
+TEST(FrameDecoderTest, TakesFramesInOrder) {
+    FakeDecoder decoder(0ms);
+    FrameDecoder frames(20, decoder.function(), 3, 4);
+    for (size_t i = 0; i < 20; i++) {
+        DecodedFrame frame;
+        ASSERT_TRUE(frames.take(i, &frame));
+        EXPECT_EQ(i, pixelOf(frame));
+    }
+    DecodedFrame frame;
+    EXPECT_FALSE(frames.take(20, &frame));
+}
+
+TEST(FrameDecoderTest, DecodesAtMostCapacityAhead) {
+    FakeDecoder decoder(5ms);
+    FrameDecoder frames(30, decoder.function(), 4, 3);
+    std::this_thread::sleep_for(50ms);
+    // Nothing was taken, so only the first frames fit.
+    EXPECT_EQ(3, decoder.mDecoded);
+    EXPECT_LE(decoder.mMaxInFlight, 3);
+
+    DecodedFrame frame;
+    ASSERT_TRUE(frames.take(0, &frame));
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(4, decoder.mDecoded);
+}
+
+TEST(FrameDecoderTest, DecodesInParallelAheadOfTheFrameShown) {
+    // Each frame takes twice the frame time to decode, which two threads keep up with once
+    // they are ahead.
+    constexpr auto kFrameTime = 10ms;
+    FakeDecoder decoder(2 * kFrameTime);
+    FrameDecoder frames(24, decoder.function(), 2, 4);
+    std::this_thread::sleep_for(4 * kFrameTime);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < 24; i++) {
+        DecodedFrame frame;
+        ASSERT_TRUE(frames.take(i, &frame));
+        EXPECT_EQ(i, pixelOf(frame));
+        std::this_thread::sleep_for(kFrameTime);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(2, decoder.mMaxInFlight);
+    // Decoding on the thread showing the frames would take 24 * 3 frame times.
+    EXPECT_LT(elapsed, 24 * 2 * kFrameTime);
+}
+
+TEST(FrameDecoderTest, DropsFramesPassedOver) {
+    FakeDecoder decoder(1ms);
+    FrameDecoder frames(100, decoder.function(), 2, 4);
+    DecodedFrame frame;
+    ASSERT_TRUE(frames.take(0, &frame));
+    ASSERT_TRUE(frames.take(50, &frame));
+    EXPECT_EQ(50u, pixelOf(frame));
+    ASSERT_TRUE(frames.take(51, &frame));
+    EXPECT_EQ(51u, pixelOf(frame));
+    // Frames can't be taken again, or out of order.
+    EXPECT_FALSE(frames.take(10, &frame));
+    EXPECT_LT(decoder.mDecoded, 20);
+}
+
+TEST(FrameDecoderTest, ReportsFramesThatFailToDecode) {
+    FakeDecoder decoder(0ms);
+    decoder.mFailingIndex = 1;
+    FrameDecoder frames(3, decoder.function(), 1, 2);
+    DecodedFrame frame;
+    EXPECT_TRUE(frames.take(0, &frame));
+    EXPECT_FALSE(frames.take(1, &frame));
+    EXPECT_TRUE(frames.take(2, &frame));
+    EXPECT_EQ(2u, pixelOf(frame));
+}
+
+TEST(FrameDecoderTest, StopsWithFramesLeft) {
+    FakeDecoder decoder(1ms);
+    {
+        FrameDecoder frames(1000, decoder.function(), 2, 4);
+        DecodedFrame frame;
+        ASSERT_TRUE(frames.take(0, &frame));
+    }
+    EXPECT_LT(decoder.mDecoded, 10);
+}
+
+TEST(FrameDecoderTest, ParsesRawFrames) {
+    // Rows of three RGB_565 pixels are padded from 6 to 8 bytes.
+    const std::string raw = makeRawFrame(3, 2, RAW_FRAME_FORMAT_RGB_565, 16);
+    ASSERT_TRUE(isRawFrame(raw.data(), raw.size()));
+    DecodedFrame frame;
+    ASSERT_TRUE(parseRawFrame(raw.data(), raw.size(), &frame));
+    EXPECT_EQ(3u, frame.width);
+    EXPECT_EQ(2u, frame.height);
+    EXPECT_EQ(8u, frame.stride);
+    EXPECT_EQ(RAW_FRAME_FORMAT_RGB_565, frame.format);
+    EXPECT_EQ(raw.data() + RAW_FRAME_HEADER_SIZE, frame.pixels);
+    EXPECT_EQ(nullptr, frame.buffer);
+
+    const std::string rgba = makeRawFrame(2, 2, RAW_FRAME_FORMAT_RGBA_8888, 16);
+    EXPECT_TRUE(parseRawFrame(rgba.data(), rgba.size(), &frame));
+    EXPECT_EQ(8u, frame.stride);
+}
+
+TEST(FrameDecoderTest, RejectsMalformedRawFrames) {
+    DecodedFrame frame;
+    const std::string png = "\x89PNG\r\n\x1a\n0123456789";
+    EXPECT_FALSE(isRawFrame(png.data(), png.size()));
+    EXPECT_FALSE(parseRawFrame(png.data(), png.size(), &frame));
+
+    const std::string truncated = makeRawFrame(4, 4, RAW_FRAME_FORMAT_RGBA_8888, 63);
+    EXPECT_FALSE(parseRawFrame(truncated.data(), truncated.size(), &frame));
+    const std::string badFormat = makeRawFrame(1, 1, 2, 4);
+    EXPECT_FALSE(parseRawFrame(badFormat.data(), badFormat.size(), &frame));
+    const std::string empty = makeRawFrame(0, 1, RAW_FRAME_FORMAT_RGBA_8888, 0);
+    EXPECT_FALSE(parseRawFrame(empty.data(), empty.size(), &frame));
+    // Sizes that overflow 32 bits are rejected too.
+    const std::string huge = makeRawFrame(0x10000, 0x10000, RAW_FRAME_FORMAT_RGBA_8888, 16);
+    EXPECT_FALSE(parseRawFrame(huge.data(), huge.size(), &frame));
+}
+
+}; // namespace android
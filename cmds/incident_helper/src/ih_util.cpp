@@ -273,24 +273,40 @@ bool Reader::ok(std::string* error) {
 
 // ==============================================================================
 Table::Table(const char* names[], const uint64_t ids[], const int count)
-        :mEnums(),
-         mEnumValuesByName()
+        :Table(names, ids, count, nullptr)
 {
-    std::map<std::string, uint64_t> fields;
     for (int i = 0; i < count; i++) {
-        fields[names[i]] = ids[i];
+        mFields[names[i]] = ids[i];
     }
-    mFields = fields;
+}
+
+Table::Table(const char* names[], const uint64_t ids[], const int count, field_lookup_t lookup)
+        :mNames(names),
+         mIds(ids),
+         mCount(count),
+         mLookup(lookup),
+         mFields(),
+         mEnums(),
+         mEnumValuesByName()
+{
 }
 
 Table::~Table()
 {
 }
 
+uint64_t
+Table::findField(const std::string& name) const
+{
+    if (mLookup != nullptr) return mLookup(name.c_str(), name.size());
+    auto it = mFields.find(name);
+    return it == mFields.end() ? 0 : it->second;
+}
+
 void
 Table::addEnumTypeMap(const char* field, const char* enumNames[], const int enumValues[], const int enumSize)
 {
-    if (mFields.find(field) == mFields.end()) {
+    if (findField(field) == 0) {
         fprintf(stderr, "Field '%s' not found", field);
         return;
     }
@@ -311,9 +327,9 @@ Table::addEnumNameToValue(const char* enumName, const int enumValue)
 bool
 Table::insertField(ProtoOutputStream* proto, const std::string& name, const std::string& value)
 {
-    if (mFields.find(name) == mFields.end()) return false;
+    uint64_t found = findField(name);
+    if (found == 0) return false;
 
-    uint64_t found = mFields[name];
     record_t repeats; // used for repeated fields
     switch ((found & FIELD_COUNT_MASK) | (found & FIELD_TYPE_MASK)) {
         case FIELD_COUNT_SINGLE | FIELD_TYPE_DOUBLE:
@@ -399,9 +415,9 @@ Message::~Message()
 void
 Message::addSubMessage(uint64_t fieldId, Message* fieldMsg)
 {
-    for (auto iter = mTable->mFields.begin(); iter != mTable->mFields.end(); iter++) {
-        if (iter->second == fieldId) {
-            mSubMessages[iter->first] = fieldMsg;
+    for (int i = 0; i < mTable->mCount; i++) {
+        if (mTable->mIds[i] == fieldId) {
+            mSubMessages[mTable->mNames[i]] = fieldMsg;
             return;
         }
     }
@@ -411,7 +427,7 @@ bool
 Message::insertField(ProtoOutputStream* proto, const std::string& name, const std::string& value)
 {
     // If the field name can be found, it means the name is a primitive field.
-    if (mTable->mFields.find(name) != mTable->mFields.end()) {
+    if (mTable->findField(name) != 0) {
         endSession(proto);
         // The only edge case is for example ro.hardware itself is a message, so a field called "value"
         // would be defined in proto Ro::Hardware and it must be the first field.
@@ -444,7 +460,7 @@ Message::insertField(ProtoOutputStream* proto, const std::string& name, const st
 void
 Message::startSession(ProtoOutputStream* proto, const std::string& name)
 {
-    uint64_t fieldId = mTable->mFields[name];
+    uint64_t fieldId = mTable->findField(name);
     uint64_t token = proto->start(fieldId);
     mPreviousField = name;
     mTokens.push(token);
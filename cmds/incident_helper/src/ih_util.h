@@ -137,7 +137,14 @@ class Table
 {
 friend class Message;
 public:
+    // Finds the id of a field by its name, or returns 0, as the _FIELD_ID function generated with
+    // the arrays does.
+    typedef uint64_t (*field_lookup_t)(const char* name, size_t size);
+
     Table(const char* names[], const uint64_t ids[], const int count);
+    // Finds the fields with the perfect hash table generated for the message, rather than a map
+    // built here.
+    Table(const char* names[], const uint64_t ids[], const int count, field_lookup_t lookup);
     ~Table();
 
     // Add enum names to values for parsing purpose.
@@ -151,7 +158,14 @@ public:
     // Return false if the given name can't be found.
     bool insertField(ProtoOutputStream* proto, const std::string& name, const std::string& value);
 private:
-    std::map<std::string, uint64_t> mFields;
+    // Returns the id of the field called name, or 0 if there is none.
+    uint64_t findField(const std::string& name) const;
+
+    const char** mNames;
+    const uint64_t* mIds;
+    int mCount;
+    field_lookup_t mLookup;
+    std::map<std::string, uint64_t> mFields; // only without mLookup
     std::map<std::string, std::map<std::string, int>> mEnums;
     std::map<std::string, int> mEnumValuesByName;
 };
@@ -54,7 +54,10 @@ CpuInfoParser::Parse(const int in, const int out) const
     bool nextToUsage = false;
 
     ProtoOutputStream proto;
-    Table table(CpuInfoProto::Task::_FIELD_NAMES, CpuInfoProto::Task::_FIELD_IDS, CpuInfoProto::Task::_FIELD_COUNT);
+    Table table(CpuInfoProto::Task::_FIELD_NAMES,
+            CpuInfoProto::Task::_FIELD_IDS,
+            CpuInfoProto::Task::_FIELD_COUNT,
+            CpuInfoProto::Task::_FIELD_ID);
     table.addEnumTypeMap("s", CpuInfoProto::Task::_ENUM_STATUS_NAMES,
             CpuInfoProto::Task::_ENUM_STATUS_VALUES, CpuInfoProto::Task::_ENUM_STATUS_COUNT);
     table.addEnumTypeMap("pcy", CpuInfoProto::Task::_ENUM_POLICY_NAMES,
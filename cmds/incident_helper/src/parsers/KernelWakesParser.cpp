@@ -35,7 +35,8 @@ KernelWakesParser::Parse(const int in, const int out) const
     ProtoOutputStream proto;
     Table table(KernelWakeSourcesProto::WakeupSource::_FIELD_NAMES,
             KernelWakeSourcesProto::WakeupSource::_FIELD_IDS,
-            KernelWakeSourcesProto::WakeupSource::_FIELD_COUNT);
+            KernelWakeSourcesProto::WakeupSource::_FIELD_COUNT,
+            KernelWakeSourcesProto::WakeupSource::_FIELD_ID);
 
     // parse line by line
     while (reader.readLine(&line)) {
@@ -35,7 +35,8 @@ PageTypeInfoParser::Parse(const int in, const int out) const
     ProtoOutputStream proto;
     Table table(PageTypeInfoProto::Block::_FIELD_NAMES,
             PageTypeInfoProto::Block::_FIELD_IDS,
-            PageTypeInfoProto::Block::_FIELD_COUNT);
+            PageTypeInfoProto::Block::_FIELD_COUNT,
+            PageTypeInfoProto::Block::_FIELD_ID);
 
     while (reader.readLine(&line)) {
         if (line.empty()) {
@@ -33,7 +33,10 @@ ProcrankParser::Parse(const int in, const int out) const
     int nline = 0;
 
     ProtoOutputStream proto;
-    Table table(ProcrankProto::Process::_FIELD_NAMES, ProcrankProto::Process::_FIELD_IDS, ProcrankProto::Process::_FIELD_COUNT);
+    Table table(ProcrankProto::Process::_FIELD_NAMES,
+            ProcrankProto::Process::_FIELD_IDS,
+            ProcrankProto::Process::_FIELD_COUNT,
+            ProcrankProto::Process::_FIELD_ID);
     string zram, ram, total;
 
     // parse line by line
@@ -33,7 +33,10 @@ status_t PsParser::Parse(const int in, const int out) const {
     int diff = 0;
 
     ProtoOutputStream proto;
-    Table table(PsProto::Process::_FIELD_NAMES, PsProto::Process::_FIELD_IDS, PsProto::Process::_FIELD_COUNT);
+    Table table(PsProto::Process::_FIELD_NAMES,
+            PsProto::Process::_FIELD_IDS,
+            PsProto::Process::_FIELD_COUNT,
+            PsProto::Process::_FIELD_ID);
     const char* pcyNames[] = { "fg", "bg", "ta" };
     const int pcyValues[] = {PsProto::Process::POLICY_FG, PsProto::Process::POLICY_BG, PsProto::Process::POLICY_TA};
     table.addEnumTypeMap("pcy", pcyNames, pcyValues, 3);
@@ -50,36 +50,42 @@ SystemPropertiesParser::Parse(const int in, const int out) const
 
     Table sysPropTable(SystemPropertiesProto::_FIELD_NAMES,
                 SystemPropertiesProto::_FIELD_IDS,
-                SystemPropertiesProto::_FIELD_COUNT);
+                SystemPropertiesProto::_FIELD_COUNT,
+                SystemPropertiesProto::_FIELD_ID);
     Message sysProp(&sysPropTable);
 
     Table aacDrcTable(SystemPropertiesProto::AacDrc::_FIELD_NAMES,
             SystemPropertiesProto::AacDrc::_FIELD_IDS,
-            SystemPropertiesProto::AacDrc::_FIELD_COUNT);
+            SystemPropertiesProto::AacDrc::_FIELD_COUNT,
+            SystemPropertiesProto::AacDrc::_FIELD_ID);
     Message aacDrc(&aacDrcTable);
     sysProp.addSubMessage(SystemPropertiesProto::AAC_DRC, &aacDrc);
 
     Table aaudioTable(SystemPropertiesProto::Aaudio::_FIELD_NAMES,
             SystemPropertiesProto::Aaudio::_FIELD_IDS,
-            SystemPropertiesProto::Aaudio::_FIELD_COUNT);
+            SystemPropertiesProto::Aaudio::_FIELD_COUNT,
+            SystemPropertiesProto::Aaudio::_FIELD_ID);
     Message aaudio(&aaudioTable);
     sysProp.addSubMessage(SystemPropertiesProto::AAUDIO, &aaudio);
 
     Table cameraTable(SystemPropertiesProto::Camera::_FIELD_NAMES,
             SystemPropertiesProto::Camera::_FIELD_IDS,
-            SystemPropertiesProto::Camera::_FIELD_COUNT);
+            SystemPropertiesProto::Camera::_FIELD_COUNT,
+            SystemPropertiesProto::Camera::_FIELD_ID);
     Message camera(&cameraTable);
     sysProp.addSubMessage(SystemPropertiesProto::CAMERA, &camera);
 
     Table dalvikVmTable(SystemPropertiesProto::DalvikVm::_FIELD_NAMES,
             SystemPropertiesProto::DalvikVm::_FIELD_IDS,
-            SystemPropertiesProto::DalvikVm::_FIELD_COUNT);
+            SystemPropertiesProto::DalvikVm::_FIELD_COUNT,
+            SystemPropertiesProto::DalvikVm::_FIELD_ID);
     Message dalvikVm(&dalvikVmTable);
     sysProp.addSubMessage(SystemPropertiesProto::DALVIK_VM, &dalvikVm);
 
     Table initSvcTable(SystemPropertiesProto::InitSvc::_FIELD_NAMES,
             SystemPropertiesProto::InitSvc::_FIELD_IDS,
-            SystemPropertiesProto::InitSvc::_FIELD_COUNT);
+            SystemPropertiesProto::InitSvc::_FIELD_COUNT,
+            SystemPropertiesProto::InitSvc::_FIELD_ID);
     initSvcTable.addEnumNameToValue("running", SystemPropertiesProto::InitSvc::STATUS_RUNNING);
     initSvcTable.addEnumNameToValue("stopped", SystemPropertiesProto::InitSvc::STATUS_STOPPED);
     Message initSvc(&initSvcTable);
@@ -87,84 +93,98 @@ SystemPropertiesParser::Parse(const int in, const int out) const
 
     Table logTable(SystemPropertiesProto::Log::_FIELD_NAMES,
             SystemPropertiesProto::Log::_FIELD_IDS,
-            SystemPropertiesProto::Log::_FIELD_COUNT);
+            SystemPropertiesProto::Log::_FIELD_COUNT,
+            SystemPropertiesProto::Log::_FIELD_ID);
     Message logMsg(&logTable);
     sysProp.addSubMessage(SystemPropertiesProto::LOG, &logMsg);
 
     Table persistTable(SystemPropertiesProto::Persist::_FIELD_NAMES,
             SystemPropertiesProto::Persist::_FIELD_IDS,
-            SystemPropertiesProto::Persist::_FIELD_COUNT);
+            SystemPropertiesProto::Persist::_FIELD_COUNT,
+            SystemPropertiesProto::Persist::_FIELD_ID);
     Message persist(&persistTable);
     sysProp.addSubMessage(SystemPropertiesProto::PERSIST, &persist);
 
     Table pmDexoptTable(SystemPropertiesProto::PmDexopt::_FIELD_NAMES,
             SystemPropertiesProto::PmDexopt::_FIELD_IDS,
-            SystemPropertiesProto::PmDexopt::_FIELD_COUNT);
+            SystemPropertiesProto::PmDexopt::_FIELD_COUNT,
+            SystemPropertiesProto::PmDexopt::_FIELD_ID);
     Message pmDexopt(&pmDexoptTable);
     sysProp.addSubMessage(SystemPropertiesProto::PM_DEXOPT, &pmDexopt);
 
     Table roTable(SystemPropertiesProto::Ro::_FIELD_NAMES,
             SystemPropertiesProto::Ro::_FIELD_IDS,
-            SystemPropertiesProto::Ro::_FIELD_COUNT);
+            SystemPropertiesProto::Ro::_FIELD_COUNT,
+            SystemPropertiesProto::Ro::_FIELD_ID);
     Message ro(&roTable);
 
     Table bootTable(SystemPropertiesProto::Ro::Boot::_FIELD_NAMES,
             SystemPropertiesProto::Ro::Boot::_FIELD_IDS,
-            SystemPropertiesProto::Ro::Boot::_FIELD_COUNT);
+            SystemPropertiesProto::Ro::Boot::_FIELD_COUNT,
+            SystemPropertiesProto::Ro::Boot::_FIELD_ID);
     Message boot(&bootTable);
     ro.addSubMessage(SystemPropertiesProto::Ro::BOOT, &boot);
 
     Table bootimageTable(SystemPropertiesProto::Ro::BootImage::_FIELD_NAMES,
             SystemPropertiesProto::Ro::BootImage::_FIELD_IDS,
-            SystemPropertiesProto::Ro::BootImage::_FIELD_COUNT);
+            SystemPropertiesProto::Ro::BootImage::_FIELD_COUNT,
+            SystemPropertiesProto::Ro::BootImage::_FIELD_ID);
     Message bootimage(&bootimageTable);
     ro.addSubMessage(SystemPropertiesProto::Ro::BOOTIMAGE, &bootimage);
 
     Table buildTable(SystemPropertiesProto::Ro::Build::_FIELD_NAMES,
             SystemPropertiesProto::Ro::Build::_FIELD_IDS,
-            SystemPropertiesProto::Ro::Build::_FIELD_COUNT);
+            SystemPropertiesProto::Ro::Build::_FIELD_COUNT,
+            SystemPropertiesProto::Ro::Build::_FIELD_ID);
     Message build(&buildTable);
 
     Table versionTable(SystemPropertiesProto::Ro::Build::Version::_FIELD_NAMES,
             SystemPropertiesProto::Ro::Build::Version::_FIELD_IDS,
-            SystemPropertiesProto::Ro::Build::Version::_FIELD_COUNT);
+            SystemPropertiesProto::Ro::Build::Version::_FIELD_COUNT,
+            SystemPropertiesProto::Ro::Build::Version::_FIELD_ID);
     Message version(&versionTable);
     build.addSubMessage(SystemPropertiesProto::Ro::Build::VERSION, &version);
     ro.addSubMessage(SystemPropertiesProto::Ro::BUILD, &build);
 
     Table configTable(SystemPropertiesProto::Ro::Config::_FIELD_NAMES,
             SystemPropertiesProto::Ro::Config::_FIELD_IDS,
-            SystemPropertiesProto::Ro::Config::_FIELD_COUNT);
+            SystemPropertiesProto::Ro::Config::_FIELD_COUNT,
+            SystemPropertiesProto::Ro::Config::_FIELD_ID);
     Message config(&configTable);
     ro.addSubMessage(SystemPropertiesProto::Ro::CONFIG, &config);
 
     Table hardwareTable(SystemPropertiesProto::Ro::Hardware::_FIELD_NAMES,
                    SystemPropertiesProto::Ro::Hardware::_FIELD_IDS,
-                   SystemPropertiesProto::Ro::Hardware::_FIELD_COUNT);
+                   SystemPropertiesProto::Ro::Hardware::_FIELD_COUNT,
+                   SystemPropertiesProto::Ro::Hardware::_FIELD_ID);
     Message hardware(&hardwareTable);
     ro.addSubMessage(SystemPropertiesProto::Ro::HARDWARE, &hardware);
 
     Table productTable(SystemPropertiesProto::Ro::Product::_FIELD_NAMES,
                    SystemPropertiesProto::Ro::Product::_FIELD_IDS,
-                   SystemPropertiesProto::Ro::Product::_FIELD_COUNT);
+                   SystemPropertiesProto::Ro::Product::_FIELD_COUNT,
+                   SystemPropertiesProto::Ro::Product::_FIELD_ID);
     Message product(&productTable);
 
     Table pVendorTable(SystemPropertiesProto::Ro::Product::Vendor::_FIELD_NAMES,
             SystemPropertiesProto::Ro::Product::Vendor::_FIELD_IDS,
-            SystemPropertiesProto::Ro::Product::Vendor::_FIELD_COUNT);
+            SystemPropertiesProto::Ro::Product::Vendor::_FIELD_COUNT,
+            SystemPropertiesProto::Ro::Product::Vendor::_FIELD_ID);
     Message pVendor(&pVendorTable);
     product.addSubMessage(SystemPropertiesProto::Ro::Product::VENDOR, &pVendor);
     ro.addSubMessage(SystemPropertiesProto::Ro::PRODUCT, &product);
 
     Table telephonyTable(SystemPropertiesProto::Ro::Telephony::_FIELD_NAMES,
                    SystemPropertiesProto::Ro::Telephony::_FIELD_IDS,
-                   SystemPropertiesProto::Ro::Telephony::_FIELD_COUNT);
+                   SystemPropertiesProto::Ro::Telephony::_FIELD_COUNT,
+                   SystemPropertiesProto::Ro::Telephony::_FIELD_ID);
     Message telephony(&telephonyTable);
     ro.addSubMessage(SystemPropertiesProto::Ro::TELEPHONY, &telephony);
 
     Table vendorTable(SystemPropertiesProto::Ro::Vendor::_FIELD_NAMES,
                    SystemPropertiesProto::Ro::Vendor::_FIELD_IDS,
-                   SystemPropertiesProto::Ro::Vendor::_FIELD_COUNT);
+                   SystemPropertiesProto::Ro::Vendor::_FIELD_COUNT,
+                   SystemPropertiesProto::Ro::Vendor::_FIELD_ID);
     Message vendor(&vendorTable);
     ro.addSubMessage(SystemPropertiesProto::Ro::VENDOR, &vendor);
 
@@ -172,12 +192,14 @@ SystemPropertiesParser::Parse(const int in, const int out) const
 
     Table sysTable(SystemPropertiesProto::Sys::_FIELD_NAMES,
                    SystemPropertiesProto::Sys::_FIELD_IDS,
-                   SystemPropertiesProto::Sys::_FIELD_COUNT);
+                   SystemPropertiesProto::Sys::_FIELD_COUNT,
+                   SystemPropertiesProto::Sys::_FIELD_ID);
     Message sys(&sysTable);
 
     Table usbTable(SystemPropertiesProto::Sys::Usb::_FIELD_NAMES,
                    SystemPropertiesProto::Sys::Usb::_FIELD_IDS,
-                   SystemPropertiesProto::Sys::Usb::_FIELD_COUNT);
+                   SystemPropertiesProto::Sys::Usb::_FIELD_COUNT,
+                   SystemPropertiesProto::Sys::Usb::_FIELD_ID);
     Message usb(&usbTable);
     sys.addSubMessage(SystemPropertiesProto::Sys::USB, &usb);
 
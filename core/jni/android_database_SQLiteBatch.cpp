@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "android_database_SQLiteBatch.h"
+
+#include <string.h>
+
+namespace android {
+
+static inline size_t cellOffset(int64_t value) {
+    return static_cast<uint64_t>(value) >> 32;
+}
+
+static inline size_t cellLength(int64_t value) {
+    return static_cast<uint32_t>(value);
+}
+
+bool isValidSQLiteBatch(const SQLiteBatch& batch) {
+    const size_t cellCount = batch.rowCount * batch.columnCount;
+    if (batch.columnCount != 0 && cellCount / batch.columnCount != batch.rowCount) {
+        return false;
+    }
+    for (size_t i = 0; i < cellCount; i++) {
+        const size_t offset = cellOffset(batch.values[i]);
+        const size_t length = cellLength(batch.values[i]);
+        switch (batch.types[i]) {
+            case SQLITE_BATCH_NULL:
+            case SQLITE_BATCH_INTEGER:
+            case SQLITE_BATCH_FLOAT:
+                break;
+            case SQLITE_BATCH_STRING:
+                if (offset > batch.textLength || length > batch.textLength - offset) {
+                    return false;
+                }
+                break;
+            case SQLITE_BATCH_BLOB:
+                if (offset > batch.blobsLength || length > batch.blobsLength - offset) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+static int bindCell(sqlite3_stmt* statement, int index, const SQLiteBatch& batch, size_t cell) {
+    const int64_t value = batch.values[cell];
+    switch (batch.types[cell]) {
+        case SQLITE_BATCH_INTEGER:
+            return sqlite3_bind_int64(statement, index, value);
+        case SQLITE_BATCH_FLOAT: {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            return sqlite3_bind_double(statement, index, d);
+        }
+        // The batch outlives the step that reads these, so SQLite need not copy them.
+        case SQLITE_BATCH_STRING:
+            return sqlite3_bind_text16(statement, index, batch.text + cellOffset(value),
+                    cellLength(value) * sizeof(char16_t), SQLITE_STATIC);
+        case SQLITE_BATCH_BLOB:
+            return sqlite3_bind_blob(statement, index, batch.blobs + cellOffset(value),
+                    cellLength(value), SQLITE_STATIC);
+        default:
+            return sqlite3_bind_null(statement, index);
+    }
+}
+
+int executeSQLiteBatch(sqlite3* db, sqlite3_stmt* statement, const SQLiteBatch& batch,
+        bool returnRowIds, int64_t* outResults, size_t* outRowsExecuted) {
+    size_t cell = 0;
+    for (size_t row = 0; row < batch.rowCount; row++) {
+        *outRowsExecuted = row;
+        for (size_t column = 0; column < batch.columnCount; column++, cell++) {
+            int err = bindCell(statement, column + 1, batch, cell);
+            if (err != SQLITE_OK) {
+                return err;
+            }
+        }
+        int err = sqlite3_step(statement);
+        if (err != SQLITE_DONE) {
+            return err;
+        }
+        if (outResults) {
+            const int changes = sqlite3_changes(db);
+            if (!returnRowIds) {
+                outResults[row] = changes;
+            } else {
+                outResults[row] = changes > 0 ? sqlite3_last_insert_rowid(db) : -1;
+            }
+        }
+        // Every parameter is rebound for the next row, so there is no need to clear them here.
+        err = sqlite3_reset(statement);
+        if (err != SQLITE_OK) {
+            return err;
+        }
+    }
+    *outRowsExecuted = batch.rowCount;
+    sqlite3_clear_bindings(statement);
+    return SQLITE_DONE;
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ANDROID_DATABASE_SQLITE_BATCH_H
+#define _ANDROID_DATABASE_SQLITE_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sqlite3.h>
+
+namespace android {
+
+/* Cell types of a batch. Must be kept in sync with the FIELD_TYPE_* constants in Cursor.java. */
+enum {
+    SQLITE_BATCH_NULL    = 0,
+    SQLITE_BATCH_INTEGER = 1,
+    SQLITE_BATCH_FLOAT   = 2,
+    SQLITE_BATCH_STRING  = 3,
+    SQLITE_BATCH_BLOB    = 4,
+};
+
+/* The bind arguments of rowCount executions of one statement, packed row by row with
+   columnCount cells per row. values holds each cell's integer, the raw bits of its double, or
+   for strings and blobs (offset << 32 | length) into text (in chars) or blobs (in bytes). */
+struct SQLiteBatch {
+    size_t rowCount;
+    size_t columnCount;
+    const int8_t* types;
+    const int64_t* values;
+    const char16_t* text;
+    size_t textLength;
+    const uint8_t* blobs;
+    size_t blobsLength;
+};
+
+/* returns whether every cell of batch has a known type and, for strings and blobs, lies
+   within text or blobs */
+bool isValidSQLiteBatch(const SQLiteBatch& batch);
+
+/* binds and steps each row of batch in turn, storing the number of changed rows of each
+   execution in outResults (or, if returnRowIds, its last inserted row id or -1 if it inserted
+   nothing). Returns SQLITE_DONE once every row has been executed and the statement has been
+   reset with its bindings cleared. Otherwise returns the error of the row at *outRowsExecuted,
+   or SQLITE_ROW if the statement is a query, and leaves the statement for the caller to read
+   the error from and reset. The batch must be valid, and outResults may be null. */
+int executeSQLiteBatch(sqlite3* db, sqlite3_stmt* statement, const SQLiteBatch& batch,
+        bool returnRowIds, int64_t* outResults, size_t* outRowsExecuted);
+
+}
+
+#endif // _ANDROID_DATABASE_SQLITE_BATCH_H
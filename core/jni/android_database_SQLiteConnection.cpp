@@ -18,6 +18,7 @@
 
 #include <jni.h>
 #include <nativehelper/JNIHelp.h>
+#include <nativehelper/ScopedPrimitiveArray.h>
 #include <android_runtime/AndroidRuntime.h>
 #include <android_runtime/Log.h>
 
@@ -35,7 +36,9 @@
 #include <sqlite3.h>
 #include <sqlite3_android.h>
 
+#include "android_database_SQLiteBatch.h"
 #include "android_database_SQLiteCommon.h"
+#include "android_database_SQLitePrefetch.h"
 
 #include "core_jni_helpers.h"
 
@@ -84,10 +87,32 @@ struct SQLiteConnection {
 
     volatile bool canceled;
 
+    // Set while this prefetcher is filling a window in the background with db.
+    SQLiteWindowPrefetcher* prefetcher;
+    // Fills windows in the background for every prefetcher of this connection. Created by the
+    // first prefetcher.
+    SQLitePrefetchWorker* prefetchWorker;
+
     SQLiteConnection(sqlite3* db, int openFlags, const String8& path, const String8& label) :
-        db(db), openFlags(openFlags), path(path), label(label), canceled(false) { }
+        db(db), openFlags(openFlags), path(path), label(label), canceled(false),
+        prefetcher(NULL), prefetchWorker(NULL) { }
+
+    ~SQLiteConnection() {
+        delete prefetchWorker;
+    }
 };
 
+// Returns the connection once it is free for this thread to use: a database handle must only be
+// used by one thread at a time, so this first waits for any window being prefetched with it.
+static SQLiteConnection* toConnection(jlong connectionPtr) {
+    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    if (connection && connection->prefetcher) {
+        connection->prefetcher->await();
+        connection->prefetcher = NULL;
+    }
+    return connection;
+}
+
 // Called each time a statement begins execution, when tracing is enabled.
 static void sqliteTraceCallback(void *data, const char *sql) {
     SQLiteConnection* connection = static_cast<SQLiteConnection*>(data);
@@ -184,7 +209,7 @@ static jlong nativeOpen(JNIEnv* env, jclass clazz, jstring pathStr, jint openFla
 }
 
 static void nativeClose(JNIEnv* env, jclass clazz, jlong connectionPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
 
     if (connection) {
         ALOGV("Closing connection %p", connection->db);
@@ -235,7 +260,7 @@ static void sqliteCustomScalarFunctionDestructor(void* data) {
 
 static void nativeRegisterCustomScalarFunction(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jstring functionName, jobject functionObj) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
 
     jobject functionObjGlobal = env->NewGlobalRef(functionObj);
     ScopedUtfChars functionNameChars(env, functionName);
@@ -329,7 +354,7 @@ static void sqliteCustomAggregateFunctionDestructor(void* data) {
 
 static void nativeRegisterCustomAggregateFunction(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jstring functionName, jobject functionObj) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
 
     jobject functionObjGlobal = env->NewGlobalRef(functionObj);
     ScopedUtfChars functionNameChars(env, functionName);
@@ -351,7 +376,7 @@ static void nativeRegisterCustomAggregateFunction(JNIEnv* env, jclass clazz, jlo
 
 static void nativeRegisterLocalizedCollators(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jstring localeStr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
 
     const char* locale = env->GetStringUTFChars(localeStr, NULL);
     int err = register_localized_collators(connection->db, locale, UTF16_STORAGE);
@@ -364,7 +389,7 @@ static void nativeRegisterLocalizedCollators(JNIEnv* env, jclass clazz, jlong co
 
 static jlong nativePrepareStatement(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jstring sqlString) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
 
     jsize sqlLength = env->GetStringLength(sqlString);
     const jchar* sql = env->GetStringCritical(sqlString, NULL);
@@ -395,7 +420,7 @@ static jlong nativePrepareStatement(JNIEnv* env, jclass clazz, jlong connectionP
 
 static void nativeFinalizeStatement(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jlong statementPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     // We ignore the result of sqlite3_finalize because it is really telling us about
@@ -443,7 +468,7 @@ static jstring nativeGetColumnName(JNIEnv* env, jclass clazz, jlong connectionPt
 
 static void nativeBindNull(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jlong statementPtr, jint index) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = sqlite3_bind_null(statement, index);
@@ -454,7 +479,7 @@ static void nativeBindNull(JNIEnv* env, jclass clazz, jlong connectionPtr,
 
 static void nativeBindLong(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jlong statementPtr, jint index, jlong value) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = sqlite3_bind_int64(statement, index, value);
@@ -465,7 +490,7 @@ static void nativeBindLong(JNIEnv* env, jclass clazz, jlong connectionPtr,
 
 static void nativeBindDouble(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jlong statementPtr, jint index, jdouble value) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = sqlite3_bind_double(statement, index, value);
@@ -476,7 +501,7 @@ static void nativeBindDouble(JNIEnv* env, jclass clazz, jlong connectionPtr,
 
 static void nativeBindString(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jlong statementPtr, jint index, jstring valueString) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     jsize valueLength = env->GetStringLength(valueString);
@@ -491,7 +516,7 @@ static void nativeBindString(JNIEnv* env, jclass clazz, jlong connectionPtr,
 
 static void nativeBindBlob(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jlong statementPtr, jint index, jbyteArray valueArray) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     jsize valueLength = env->GetArrayLength(valueArray);
@@ -505,7 +530,7 @@ static void nativeBindBlob(JNIEnv* env, jclass clazz, jlong connectionPtr,
 
 static void nativeResetStatementAndClearBindings(JNIEnv* env, jclass clazz, jlong connectionPtr,
         jlong statementPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = sqlite3_reset(statement);
@@ -536,7 +561,7 @@ static int executeNonQuery(JNIEnv* env, SQLiteConnection* connection, sqlite3_st
 
 static void nativeExecute(JNIEnv* env, jclass clazz, jlong connectionPtr, jlong statementPtr,
         jboolean isPragmaStmt) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     executeNonQuery(env, connection, statement, isPragmaStmt);
@@ -544,7 +569,7 @@ static void nativeExecute(JNIEnv* env, jclass clazz, jlong connectionPtr, jlong
 
 static jint nativeExecuteForChangedRowCount(JNIEnv* env, jclass clazz,
         jlong connectionPtr, jlong statementPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = executeNonQuery(env, connection, statement, false);
@@ -553,7 +578,7 @@ static jint nativeExecuteForChangedRowCount(JNIEnv* env, jclass clazz,
 
 static jlong nativeExecuteForLastInsertedRowId(JNIEnv* env, jclass clazz,
         jlong connectionPtr, jlong statementPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = executeNonQuery(env, connection, statement, false);
@@ -561,6 +586,80 @@ static jlong nativeExecuteForLastInsertedRowId(JNIEnv* env, jclass clazz,
             ? sqlite3_last_insert_rowid(connection->db) : -1;
 }
 
+static jint nativeExecuteMany(JNIEnv* env, jclass clazz, jlong connectionPtr,
+        jlong statementPtr, jint rowCount, jbyteArray typesArray, jlongArray valuesArray,
+        jcharArray textArray, jbyteArray blobsArray, jboolean returnRowIds,
+        jlongArray resultsArray) {
+    SQLiteConnection* connection = toConnection(connectionPtr);
+    sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
+
+    ScopedByteArrayRO types(env, typesArray);
+    ScopedLongArrayRO values(env, valuesArray);
+    ScopedCharArrayRO text(env, textArray);
+    ScopedByteArrayRO blobs(env, blobsArray);
+    if (types.get() == NULL || values.get() == NULL || text.get() == NULL
+            || blobs.get() == NULL) {
+        return 0;
+    }
+
+    SQLiteBatch batch;
+    batch.rowCount = rowCount < 0 ? 0 : rowCount;
+    batch.columnCount = sqlite3_bind_parameter_count(statement);
+    batch.types = types.get();
+    batch.values = values.get();
+    batch.text = reinterpret_cast<const char16_t*>(text.get());
+    batch.textLength = text.size();
+    batch.blobs = reinterpret_cast<const uint8_t*>(blobs.get());
+    batch.blobsLength = blobs.size();
+    if (rowCount < 0 || types.size() != values.size()
+            || types.size() != batch.rowCount * batch.columnCount
+            || (resultsArray != NULL && env->GetArrayLength(resultsArray) < rowCount)
+            || !isValidSQLiteBatch(batch)) {
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                "Malformed batch of bind arguments");
+        return 0;
+    }
+
+    // Run all of the rows in one transaction unless the caller already has one open, rather
+    // than letting SQLite commit each of them.
+    const bool ownTransaction = sqlite3_get_autocommit(connection->db) != 0;
+    if (ownTransaction) {
+        int err = sqlite3_exec(connection->db, "BEGIN IMMEDIATE", NULL, NULL, NULL);
+        if (err != SQLITE_OK) {
+            throw_sqlite3_exception(env, connection->db);
+            return 0;
+        }
+    }
+
+    ScopedLongArrayRW results(env);
+    if (resultsArray != NULL) {
+        results.reset(resultsArray);
+    }
+    size_t rowsExecuted = 0;
+    int err = executeSQLiteBatch(connection->db, statement, batch, returnRowIds,
+            results.get(), &rowsExecuted);
+    if (err == SQLITE_DONE && ownTransaction) {
+        err = sqlite3_exec(connection->db, "COMMIT", NULL, NULL, NULL);
+        if (err == SQLITE_OK) {
+            err = SQLITE_DONE;
+        }
+    }
+    if (err != SQLITE_DONE) {
+        if (err == SQLITE_ROW) {
+            throw_sqlite3_exception(env,
+                    "Queries can be performed using SQLiteDatabase query or rawQuery methods only.");
+        } else {
+            throw_sqlite3_exception(env, connection->db);
+        }
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+        if (ownTransaction) {
+            sqlite3_exec(connection->db, "ROLLBACK", NULL, NULL, NULL);
+        }
+    }
+    return rowsExecuted;
+}
+
 static int executeOneRowQuery(JNIEnv* env, SQLiteConnection* connection, sqlite3_stmt* statement) {
     int err = sqlite3_step(statement);
     if (err != SQLITE_ROW) {
@@ -571,7 +670,7 @@ static int executeOneRowQuery(JNIEnv* env, SQLiteConnection* connection, sqlite3
 
 static jlong nativeExecuteForLong(JNIEnv* env, jclass clazz,
         jlong connectionPtr, jlong statementPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = executeOneRowQuery(env, connection, statement);
@@ -583,7 +682,7 @@ static jlong nativeExecuteForLong(JNIEnv* env, jclass clazz,
 
 static jstring nativeExecuteForString(JNIEnv* env, jclass clazz,
         jlong connectionPtr, jlong statementPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = executeOneRowQuery(env, connection, statement);
@@ -633,7 +732,7 @@ static int createAshmemRegionWithData(JNIEnv* env, const void* data, size_t leng
 
 static jint nativeExecuteForBlobFileDescriptor(JNIEnv* env, jclass clazz,
         jlong connectionPtr, jlong statementPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
     int err = executeOneRowQuery(env, connection, statement);
@@ -649,109 +748,10 @@ static jint nativeExecuteForBlobFileDescriptor(JNIEnv* env, jclass clazz,
     return -1;
 }
 
-enum CopyRowResult {
-    CPR_OK,
-    CPR_FULL,
-    CPR_ERROR,
-};
-
-static CopyRowResult copyRow(JNIEnv* env, CursorWindow* window,
-        sqlite3_stmt* statement, int numColumns, int startPos, int addedRows) {
-    // Allocate a new field directory for the row.
-    status_t status = window->allocRow();
-    if (status) {
-        LOG_WINDOW("Failed allocating fieldDir at startPos %d row %d, error=%d",
-                startPos, addedRows, status);
-        return CPR_FULL;
-    }
-
-    // Pack the row into the window.
-    CopyRowResult result = CPR_OK;
-    for (int i = 0; i < numColumns; i++) {
-        int type = sqlite3_column_type(statement, i);
-        if (type == SQLITE_TEXT) {
-            // TEXT data
-            const char* text = reinterpret_cast<const char*>(
-                    sqlite3_column_text(statement, i));
-            // SQLite does not include the NULL terminator in size, but does
-            // ensure all strings are NULL terminated, so increase size by
-            // one to make sure we store the terminator.
-            size_t sizeIncludingNull = sqlite3_column_bytes(statement, i) + 1;
-            status = window->putString(addedRows, i, text, sizeIncludingNull);
-            if (status) {
-                LOG_WINDOW("Failed allocating %zu bytes for text at %d,%d, error=%d",
-                        sizeIncludingNull, startPos + addedRows, i, status);
-                result = CPR_FULL;
-                break;
-            }
-            LOG_WINDOW("%d,%d is TEXT with %zu bytes",
-                    startPos + addedRows, i, sizeIncludingNull);
-        } else if (type == SQLITE_INTEGER) {
-            // INTEGER data
-            int64_t value = sqlite3_column_int64(statement, i);
-            status = window->putLong(addedRows, i, value);
-            if (status) {
-                LOG_WINDOW("Failed allocating space for a long in column %d, error=%d",
-                        i, status);
-                result = CPR_FULL;
-                break;
-            }
-            LOG_WINDOW("%d,%d is INTEGER %" PRId64, startPos + addedRows, i, value);
-        } else if (type == SQLITE_FLOAT) {
-            // FLOAT data
-            double value = sqlite3_column_double(statement, i);
-            status = window->putDouble(addedRows, i, value);
-            if (status) {
-                LOG_WINDOW("Failed allocating space for a double in column %d, error=%d",
-                        i, status);
-                result = CPR_FULL;
-                break;
-            }
-            LOG_WINDOW("%d,%d is FLOAT %lf", startPos + addedRows, i, value);
-        } else if (type == SQLITE_BLOB) {
-            // BLOB data
-            const void* blob = sqlite3_column_blob(statement, i);
-            size_t size = sqlite3_column_bytes(statement, i);
-            status = window->putBlob(addedRows, i, blob, size);
-            if (status) {
-                LOG_WINDOW("Failed allocating %zu bytes for blob at %d,%d, error=%d",
-                        size, startPos + addedRows, i, status);
-                result = CPR_FULL;
-                break;
-            }
-            LOG_WINDOW("%d,%d is Blob with %zu bytes",
-                    startPos + addedRows, i, size);
-        } else if (type == SQLITE_NULL) {
-            // NULL field
-            status = window->putNull(addedRows, i);
-            if (status) {
-                LOG_WINDOW("Failed allocating space for a null in column %d, error=%d",
-                        i, status);
-                result = CPR_FULL;
-                break;
-            }
-
-            LOG_WINDOW("%d,%d is NULL", startPos + addedRows, i);
-        } else {
-            // Unknown data
-            ALOGE("Unknown column type when filling database window");
-            throw_sqlite3_exception(env, "Unknown column type when filling window");
-            result = CPR_ERROR;
-            break;
-        }
-    }
-
-    // Free the last row if if was not successfully copied.
-    if (result != CPR_OK) {
-        window->freeLastRow();
-    }
-    return result;
-}
-
 static jlong nativeExecuteForCursorWindow(JNIEnv* env, jclass clazz,
         jlong connectionPtr, jlong statementPtr, jlong windowPtr,
         jint startPos, jint requiredPos, jboolean countAllRows) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
     CursorWindow* window = reinterpret_cast<CursorWindow*>(windowPtr);
 
@@ -790,7 +790,7 @@ static jlong nativeExecuteForCursorWindow(JNIEnv* env, jclass clazz,
                 continue;
             }
 
-            CopyRowResult cpr = copyRow(env, window, statement, numColumns, startPos, addedRows);
+            CopyRowResult cpr = copyRow(window, statement, numColumns, startPos, addedRows);
             if (cpr == CPR_FULL && addedRows && startPos + addedRows <= requiredPos) {
                 // We filled the window before we got to the one row that we really wanted.
                 // Clear the window and start filling it again from here.
@@ -799,7 +799,7 @@ static jlong nativeExecuteForCursorWindow(JNIEnv* env, jclass clazz,
                 window->setNumColumns(numColumns);
                 startPos += addedRows;
                 addedRows = 0;
-                cpr = copyRow(env, window, statement, numColumns, startPos, addedRows);
+                cpr = copyRow(window, statement, numColumns, startPos, addedRows);
             }
 
             if (cpr == CPR_OK) {
@@ -807,6 +807,7 @@ static jlong nativeExecuteForCursorWindow(JNIEnv* env, jclass clazz,
             } else if (cpr == CPR_FULL) {
                 windowFull = true;
             } else {
+                throw_sqlite3_exception(env, "Unknown column type when filling window");
                 gotException = true;
             }
         } else if (err == SQLITE_DONE) {
@@ -852,8 +853,72 @@ static jlong nativeExecuteForCursorWindow(JNIEnv* env, jclass clazz,
     return result;
 }
 
+// Custom functions call back into Java, so prefetching threads are attached to the VM, once for
+// the lifetime of the connection's worker.
+static void runAttachedToVm(const std::function<void()>& loop) {
+    JavaVM* vm = AndroidRuntime::getJavaVM();
+    JNIEnv* env;
+    JavaVMAttachArgs args = { JNI_VERSION_1_4, "SQLitePrefetch", NULL };
+    if (vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        ALOGE("Failed to attach the window prefetching thread to the VM");
+        env = NULL;
+    }
+    loop();
+    if (env) {
+        vm->DetachCurrentThread();
+    }
+}
+
+static jlong nativeOpenWindowPrefetcher(JNIEnv* env, jclass clazz, jlong connectionPtr,
+        jlong statementPtr) {
+    SQLiteConnection* connection = toConnection(connectionPtr);
+    sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
+
+    if (!connection->prefetchWorker) {
+        connection->prefetchWorker = new SQLitePrefetchWorker(runAttachedToVm);
+    }
+    SQLiteWindowPrefetcher* prefetcher =
+            new SQLiteWindowPrefetcher(connection->db, statement, connection->prefetchWorker);
+    return reinterpret_cast<jlong>(prefetcher);
+}
+
+/*
+ * Unlike nativeExecuteForCursorWindow, which re-executes the query and skips to startPos for
+ * every window, this continues from the row after the previous window's last row. Returns the
+ * start position of window in the upper 32 bits and its number of rows in the lower, which is
+ * 0 once the query has no more rows.
+ *
+ * prefetchWindow is filled in the background after this returns, so the caller must not free it
+ * until it has been passed back as windowPtr, or the prefetcher has been closed.
+ */
+static jlong nativeFillNextWindow(JNIEnv* env, jclass clazz, jlong connectionPtr,
+        jlong prefetcherPtr, jlong windowPtr, jlong prefetchWindowPtr) {
+    SQLiteConnection* connection = toConnection(connectionPtr);
+    SQLiteWindowPrefetcher* prefetcher = reinterpret_cast<SQLiteWindowPrefetcher*>(prefetcherPtr);
+    CursorWindow* window = reinterpret_cast<CursorWindow*>(windowPtr);
+    CursorWindow* prefetchWindow = reinterpret_cast<CursorWindow*>(prefetchWindowPtr);
+
+    SQLiteWindowFill fill = prefetcher->next(window, prefetchWindow);
+    if (prefetcher->isPrefetching()) {
+        connection->prefetcher = prefetcher;
+    }
+    if (fill.failed) {
+        throw_sqlite3_exception(env, fill.errcode,
+                fill.sqlite3Message.empty() ? NULL : fill.sqlite3Message.c_str(),
+                fill.message.empty() ? NULL : fill.message.c_str());
+        return 0;
+    }
+    return jlong(fill.startPos) << 32 | jlong(fill.addedRows);
+}
+
+static void nativeCloseWindowPrefetcher(JNIEnv* env, jclass clazz, jlong connectionPtr,
+        jlong prefetcherPtr) {
+    toConnection(connectionPtr);
+    delete reinterpret_cast<SQLiteWindowPrefetcher*>(prefetcherPtr);
+}
+
 static jint nativeGetDbLookaside(JNIEnv* env, jobject clazz, jlong connectionPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
 
     int cur = -1;
     int unused;
@@ -868,7 +933,7 @@ static void nativeCancel(JNIEnv* env, jobject clazz, jlong connectionPtr) {
 
 static void nativeResetCancel(JNIEnv* env, jobject clazz, jlong connectionPtr,
         jboolean cancelable) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     connection->canceled = false;
 
     if (cancelable) {
@@ -880,17 +945,17 @@ static void nativeResetCancel(JNIEnv* env, jobject clazz, jlong connectionPtr,
 }
 
 static jint nativeLastInsertRowId(JNIEnv* env, jclass, jlong connectionPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     return sqlite3_last_insert_rowid(connection->db);
 }
 
 static jlong nativeChanges(JNIEnv* env, jclass, jlong connectionPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     return sqlite3_changes64(connection->db);
 }
 
 static jlong nativeTotalChanges(JNIEnv* env, jclass, jlong connectionPtr) {
-    SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
+    SQLiteConnection* connection = toConnection(connectionPtr);
     return sqlite3_total_changes64(connection->db);
 }
 
@@ -943,8 +1008,16 @@ static const JNINativeMethod sMethods[] =
             (void*)nativeExecuteForChangedRowCount },
     { "nativeExecuteForLastInsertedRowId", "(JJ)J",
             (void*)nativeExecuteForLastInsertedRowId },
+    { "nativeExecuteMany", "(JJI[B[J[C[BZ[J)I",
+            (void*)nativeExecuteMany },
     { "nativeExecuteForCursorWindow", "(JJJIIZ)J",
             (void*)nativeExecuteForCursorWindow },
+    { "nativeOpenWindowPrefetcher", "(JJ)J",
+            (void*)nativeOpenWindowPrefetcher },
+    { "nativeFillNextWindow", "(JJJJ)J",
+            (void*)nativeFillNextWindow },
+    { "nativeCloseWindowPrefetcher", "(JJ)V",
+            (void*)nativeCloseWindowPrefetcher },
     { "nativeGetDbLookaside", "(J)I",
             (void*)nativeGetDbLookaside },
     { "nativeCancel", "(J)V",
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "SQLiteConnection"
+
+#include "android_database_SQLitePrefetch.h"
+
+#include <unistd.h>
+
+#include <utils/Log.h>
+
+namespace android {
+
+CopyRowResult copyRow(CursorWindow* window, sqlite3_stmt* statement, int numColumns,
+        int startPos, int addedRows) {
+    // Allocate a new field directory for the row.
+    status_t status = window->allocRow();
+    if (status) {
+        LOG_WINDOW("Failed allocating fieldDir at startPos %d row %d, error=%d",
+                startPos, addedRows, status);
+        return CPR_FULL;
+    }
+
+    // Pack the row into the window.
+    CopyRowResult result = CPR_OK;
+    for (int i = 0; i < numColumns; i++) {
+        int type = sqlite3_column_type(statement, i);
+        if (type == SQLITE_TEXT) {
+            // TEXT data
+            const char* text = reinterpret_cast<const char*>(
+                    sqlite3_column_text(statement, i));
+            // SQLite does not include the NULL terminator in size, but does
+            // ensure all strings are NULL terminated, so increase size by
+            // one to make sure we store the terminator.
+            size_t sizeIncludingNull = sqlite3_column_bytes(statement, i) + 1;
+            status = window->putString(addedRows, i, text, sizeIncludingNull);
+            if (status) {
+                LOG_WINDOW("Failed allocating %zu bytes for text at %d,%d, error=%d",
+                        sizeIncludingNull, startPos + addedRows, i, status);
+                result = CPR_FULL;
+                break;
+            }
+            LOG_WINDOW("%d,%d is TEXT with %zu bytes",
+                    startPos + addedRows, i, sizeIncludingNull);
+        } else if (type == SQLITE_INTEGER) {
+            // INTEGER data
+            int64_t value = sqlite3_column_int64(statement, i);
+            status = window->putLong(addedRows, i, value);
+            if (status) {
+                LOG_WINDOW("Failed allocating space for a long in column %d, error=%d",
+                        i, status);
+                result = CPR_FULL;
+                break;
+            }
+            LOG_WINDOW("%d,%d is INTEGER %" PRId64, startPos + addedRows, i, value);
+        } else if (type == SQLITE_FLOAT) {
+            // FLOAT data
+            double value = sqlite3_column_double(statement, i);
+            status = window->putDouble(addedRows, i, value);
+            if (status) {
+                LOG_WINDOW("Failed allocating space for a double in column %d, error=%d",
+                        i, status);
+                result = CPR_FULL;
+                break;
+            }
+            LOG_WINDOW("%d,%d is FLOAT %lf", startPos + addedRows, i, value);
+        } else if (type == SQLITE_BLOB) {
+            // BLOB data
+            const void* blob = sqlite3_column_blob(statement, i);
+            size_t size = sqlite3_column_bytes(statement, i);
+            status = window->putBlob(addedRows, i, blob, size);
+            if (status) {
+                LOG_WINDOW("Failed allocating %zu bytes for blob at %d,%d, error=%d",
+                        size, startPos + addedRows, i, status);
+                result = CPR_FULL;
+                break;
+            }
+            LOG_WINDOW("%d,%d is Blob with %zu bytes",
+                    startPos + addedRows, i, size);
+        } else if (type == SQLITE_NULL) {
+            // NULL field
+            status = window->putNull(addedRows, i);
+            if (status) {
+                LOG_WINDOW("Failed allocating space for a null in column %d, error=%d",
+                        i, status);
+                result = CPR_FULL;
+                break;
+            }
+
+            LOG_WINDOW("%d,%d is NULL", startPos + addedRows, i);
+        } else {
+            // Unknown data
+            ALOGE("Unknown column type when filling database window");
+            result = CPR_ERROR;
+            break;
+        }
+    }
+
+    // Free the last row if if was not successfully copied.
+    if (result != CPR_OK) {
+        window->freeLastRow();
+    }
+    return result;
+}
+
+
+SQLitePrefetchWorker::SQLitePrefetchWorker(ThreadWrapper wrapper) :
+        mThreadWrapper(std::move(wrapper)) {
+}
+
+SQLitePrefetchWorker::~SQLitePrefetchWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mExiting = true;
+        mCondition.notify_all();
+    }
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void SQLitePrefetchWorker::post(std::function<void()> task) {
+    std::unique_lock<std::mutex> lock(mLock);
+    mCondition.wait(lock, [this]() { return !mBusy; });
+    if (!mThread.joinable()) {
+        mThread = std::thread([this]() {
+            if (mThreadWrapper) {
+                mThreadWrapper([this]() { loop(); });
+            } else {
+                loop();
+            }
+        });
+    }
+    mTask = std::move(task);
+    mBusy = true;
+    mCondition.notify_all();
+}
+
+void SQLitePrefetchWorker::await() {
+    std::unique_lock<std::mutex> lock(mLock);
+    mCondition.wait(lock, [this]() { return !mBusy; });
+}
+
+void SQLitePrefetchWorker::loop() {
+    std::unique_lock<std::mutex> lock(mLock);
+    for (;;) {
+        mCondition.wait(lock, [this]() { return mTask || mExiting; });
+        if (!mTask) {
+            break;
+        }
+        std::function<void()> task = std::move(mTask);
+        mTask = nullptr;
+        lock.unlock();
+        task();
+        lock.lock();
+        mBusy = false;
+        mCondition.notify_all();
+    }
+}
+
+
+SQLiteWindowPrefetcher::SQLiteWindowPrefetcher(sqlite3* db, sqlite3_stmt* statement,
+        SQLitePrefetchWorker* worker) :
+        mDb(db), mStatement(statement), mNumColumns(sqlite3_column_count(statement)),
+        mWorker(worker) {
+}
+
+SQLiteWindowPrefetcher::~SQLiteWindowPrefetcher() {
+    await();
+    sqlite3_reset(mStatement);
+}
+
+void SQLiteWindowPrefetcher::await() {
+    if (mPrefetching) {
+        mWorker->await();
+        mPrefetching = false;
+    }
+}
+
+SQLiteWindowFill SQLiteWindowPrefetcher::next(CursorWindow* window,
+        CursorWindow* prefetchWindow) {
+    await();
+
+    SQLiteWindowFill result;
+    if (mPrefetchWindow == window) {
+        result = std::move(mPrefetchFill);
+    } else if (mPrefetchWindow) {
+        // The prefetched rows have already been stepped past, so they are only in the other
+        // window; handing out this one instead would silently skip them.
+        fail(&result, SQLITE_MISUSE, NULL, "Window was not the one prefetched into");
+    } else {
+        fill(window, &result);
+    }
+    mPrefetchWindow = nullptr;
+
+    if (!result.failed && !mDone && mWorker && prefetchWindow && prefetchWindow != window) {
+        mPrefetchWindow = prefetchWindow;
+        mPrefetchFill = SQLiteWindowFill();
+        mPrefetching = true;
+        mWorker->post([this]() { fill(mPrefetchWindow, &mPrefetchFill); });
+    }
+    return result;
+}
+
+void SQLiteWindowPrefetcher::fail(SQLiteWindowFill* outFill, int errcode,
+        const char* sqlite3Message, const char* message) {
+    outFill->failed = true;
+    outFill->errcode = errcode;
+    outFill->sqlite3Message = sqlite3Message ? sqlite3Message : "";
+    outFill->message = message ? message : "";
+    mDone = true;
+}
+
+void SQLiteWindowPrefetcher::fill(CursorWindow* window, SQLiteWindowFill* outFill) {
+    outFill->startPos = mPosition;
+    outFill->addedRows = 0;
+
+    status_t status = window->clear();
+    if (!status) {
+        status = window->setNumColumns(mNumColumns);
+    }
+    if (status) {
+        String8 msg;
+        msg.appendFormat("Failed to prepare the cursor window, status=%d", status);
+        fail(outFill, sqlite3_extended_errcode(mDb), sqlite3_errmsg(mDb), msg.c_str());
+        return;
+    }
+
+    int retryCount = 0;
+    while (!mDone) {
+        if (!mRowPending) {
+            int err = sqlite3_step(mStatement);
+            if (err == SQLITE_DONE) {
+                LOG_WINDOW("Processed all rows");
+                mDone = true;
+                break;
+            } else if (err == SQLITE_LOCKED || err == SQLITE_BUSY) {
+                LOG_WINDOW("Database locked, retrying");
+                if (retryCount > 50) {
+                    ALOGE("Bailing on database busy retry");
+                    fail(outFill, sqlite3_extended_errcode(mDb), sqlite3_errmsg(mDb),
+                            "retrycount exceeded");
+                    break;
+                }
+                usleep(1000);
+                retryCount++;
+                continue;
+            } else if (err != SQLITE_ROW) {
+                fail(outFill, sqlite3_extended_errcode(mDb), sqlite3_errmsg(mDb), NULL);
+                break;
+            }
+            retryCount = 0;
+            mRowPending = true;
+        }
+
+        CopyRowResult cpr = copyRow(window, mStatement, mNumColumns, outFill->startPos,
+                outFill->addedRows);
+        if (cpr == CPR_FULL) {
+            // Leave the row for the next window, unless even an empty window cannot hold it.
+            if (outFill->addedRows == 0) {
+                String8 msg;
+                msg.appendFormat("Row too big to fit into CursorWindow requiredPos=%d",
+                        mPosition);
+                fail(outFill, SQLITE_TOOBIG, NULL, msg.c_str());
+            }
+            break;
+        } else if (cpr == CPR_ERROR) {
+            fail(outFill, SQLITE_OK, "unknown error", "Unknown column type when filling window");
+            break;
+        }
+        mRowPending = false;
+        mPosition++;
+        outFill->addedRows++;
+    }
+    LOG_WINDOW("Filled window %p with %d rows from %d", window, outFill->addedRows,
+            outFill->startPos);
+}
+
+}
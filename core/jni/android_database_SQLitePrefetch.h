@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ANDROID_DATABASE_SQLITE_PREFETCH_H
+#define _ANDROID_DATABASE_SQLITE_PREFETCH_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <androidfw/CursorWindow.h>
+#include <sqlite3.h>
+
+namespace android {
+
+enum CopyRowResult {
+    CPR_OK,
+    CPR_FULL,
+    CPR_ERROR,
+};
+
+/* copies the row statement is on into a newly allocated row of window. Returns CPR_FULL, with
+   the window unchanged, if the row does not fit, and CPR_ERROR if a column has an unknown type */
+CopyRowResult copyRow(CursorWindow* window, sqlite3_stmt* statement, int numColumns,
+        int startPos, int addedRows);
+
+/* The rows [startPos, startPos + addedRows) of a query, as copied into one window. */
+struct SQLiteWindowFill {
+    int startPos = 0;
+    int addedRows = 0;
+
+    // Set if the fill stopped on an error, described the same way as throw_sqlite3_exception's
+    // arguments. The rows before it are still in the window.
+    bool failed = false;
+    int errcode = SQLITE_OK;
+    std::string sqlite3Message;
+    std::string message;
+};
+
+/*
+ * A thread that runs one task at a time in the background. A connection keeps one for all of its
+ * prefetching, so that a thread is started, and attached to the VM, once rather than per window.
+ * The thread is started by the first post() and stopped by the destructor.
+ */
+class SQLitePrefetchWorker {
+public:
+    // Runs the worker's loop, so that the caller can prepare the thread it runs on.
+    using ThreadWrapper = std::function<void(const std::function<void()>& loop)>;
+
+    explicit SQLitePrefetchWorker(ThreadWrapper wrapper = nullptr);
+    // Waits for the current task, then stops the thread.
+    ~SQLitePrefetchWorker();
+
+    // Waits for the current task, if any, then starts running task.
+    void post(std::function<void()> task);
+    // Waits for the current task, if any.
+    void await();
+
+private:
+    void loop();
+
+    const ThreadWrapper mThreadWrapper;
+
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    // The fields below are guarded by mLock.
+    std::function<void()> mTask;
+    bool mBusy = false;
+    bool mExiting = false;
+
+    std::thread mThread;
+};
+
+/*
+ * Reads the result of a query a window at a time without ever re-executing it: the statement
+ * stays positioned after the last row copied, and while the caller reads one window the next is
+ * filled on worker.
+ *
+ * The statement, worker and windows are borrowed. Nothing else may use the statement's database
+ * connection while a window is being filled in the background; call await() first. Likewise, a
+ * window passed as prefetchWindow must outlive the fill: CursorWindow is not reference counted,
+ * so the caller must await() (or destroy the prefetcher) before freeing it.
+ */
+class SQLiteWindowPrefetcher {
+public:
+    // Without a worker, every window is filled when it is asked for.
+    SQLiteWindowPrefetcher(sqlite3* db, sqlite3_stmt* statement,
+            SQLitePrefetchWorker* worker = nullptr);
+    // Waits for any background fill and resets the statement.
+    ~SQLiteWindowPrefetcher();
+
+    // Returns the next rows in window: either those a previous call already started prefetching
+    // into it, or those copied into it now. Unless the query has finished, then starts filling
+    // prefetchWindow (if not null) with the rows after them. The caller must not touch or free
+    // prefetchWindow until it passes it as the window of the next call.
+    SQLiteWindowFill next(CursorWindow* window, CursorWindow* prefetchWindow);
+
+    void await();
+    bool isPrefetching() const { return mPrefetching; }
+
+private:
+    void fill(CursorWindow* window, SQLiteWindowFill* outFill);
+    void fail(SQLiteWindowFill* outFill, int errcode, const char* sqlite3Message,
+            const char* message);
+
+    sqlite3* const mDb;
+    sqlite3_stmt* const mStatement;
+    const int mNumColumns;
+    SQLitePrefetchWorker* const mWorker;
+
+    // The number of rows copied so far, which is the start position of the next window.
+    int mPosition = 0;
+    // Whether the statement is on a row that did not fit into the last window.
+    bool mRowPending = false;
+    bool mDone = false;
+
+    bool mPrefetching = false;
+    CursorWindow* mPrefetchWindow = nullptr;
+    SQLiteWindowFill mPrefetchFill;
+};
+
+}
+
+#endif // _ANDROID_DATABASE_SQLITE_PREFETCH_H
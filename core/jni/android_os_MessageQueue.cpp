@@ -19,8 +19,16 @@
 #include <nativehelper/JNIHelp.h>
 #include <android_runtime/AndroidRuntime.h>
 
+#include <android-base/stringprintf.h>
 #include <utils/Looper.h>
 #include <utils/Log.h>
+#include <utils/Timers.h>
+
+#include <atomic>
+#include <inttypes.h>
+#include <limits>
+#include <string>
+
 #include "android_os_MessageQueue.h"
 
 #include "core_jni_helpers.h"
@@ -47,6 +55,8 @@ public:
 
     void pollOnce(JNIEnv* env, jobject obj, int timeoutMillis);
     void wake();
+    void setWakeBatchWindow(nsecs_t window);
+    std::string dumpWakeStats() const;
     void setFileDescriptorEvents(int fd, int events);
 
     virtual int handleEvent(int fd, int events, void* data);
@@ -67,9 +77,27 @@ public:
     };
 
 private:
+    // mPollDeadline while no pollOnce() is waiting, or one is about to that has not said
+    // until when yet.
+    static constexpr nsecs_t kNoDeadline = 0;
+    // mPollDeadline while pollOnce() waits without a timeout.
+    static constexpr nsecs_t kInfiniteDeadline = std::numeric_limits<nsecs_t>::max();
+
     JNIEnv* mPollEnv;
     jobject mPollObj;
     jthrowable mExceptionObj;
+
+    // Set by the first wake() after the looper last returned from polling, so that the wakes
+    // that follow it in a burst don't write to the looper's eventfd again.
+    std::atomic<bool> mWakePending;
+    // When the current pollOnce() times out at the latest, for wake batching.
+    std::atomic<nsecs_t> mPollDeadline;
+    // Wakes within this long of mPollDeadline are left to the timeout. 0 disables batching.
+    std::atomic<nsecs_t> mWakeBatchWindow;
+
+    std::atomic<uint64_t> mWakesIssued;
+    std::atomic<uint64_t> mWakesCoalesced;
+    std::atomic<uint64_t> mWakesBatched;
 };
 
 
@@ -91,7 +119,9 @@ bool MessageQueue::raiseAndClearException(JNIEnv* env, const char* msg) {
 }
 
 NativeMessageQueue::NativeMessageQueue() :
-        mPollEnv(NULL), mPollObj(NULL), mExceptionObj(NULL) {
+        mPollEnv(NULL), mPollObj(NULL), mExceptionObj(NULL), mWakePending(false),
+        mPollDeadline(kNoDeadline), mWakeBatchWindow(0), mWakesIssued(0), mWakesCoalesced(0),
+        mWakesBatched(0) {
     mLooper = Looper::getForThread();
     if (mLooper == NULL) {
         mLooper = new Looper(false);
@@ -122,7 +152,13 @@ void NativeMessageQueue::raiseException(JNIEnv* env, const char* msg, jthrowable
 void NativeMessageQueue::pollOnce(JNIEnv* env, jobject pollObj, int timeoutMillis) {
     mPollEnv = env;
     mPollObj = pollObj;
+    mPollDeadline.store(timeoutMillis < 0 ? kInfiniteDeadline
+            : systemTime(SYSTEM_TIME_MONOTONIC) + milliseconds_to_nanoseconds(timeoutMillis));
     mLooper->pollOnce(timeoutMillis);
+    mPollDeadline.store(kNoDeadline);
+    // The caller looks at its queue again after this returns, which covers every message that
+    // was enqueued before a wake that found one already pending.
+    mWakePending.store(false);
     mPollObj = NULL;
     mPollEnv = NULL;
 
@@ -134,9 +170,38 @@ void NativeMessageQueue::pollOnce(JNIEnv* env, jobject pollObj, int timeoutMilli
 }
 
 void NativeMessageQueue::wake() {
+    const nsecs_t window = mWakeBatchWindow.load(std::memory_order_relaxed);
+    if (window > 0) {
+        const nsecs_t deadline = mPollDeadline.load();
+        if (deadline != kNoDeadline && deadline != kInfiniteDeadline
+                && deadline - systemTime(SYSTEM_TIME_MONOTONIC) <= window) {
+            // The looper is waiting and returns soon enough on its own.
+            mWakesBatched.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    if (mWakePending.exchange(true)) {
+        mWakesCoalesced.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    mWakesIssued.fetch_add(1, std::memory_order_relaxed);
     mLooper->wake();
 }
 
+void NativeMessageQueue::setWakeBatchWindow(nsecs_t window) {
+    mWakeBatchWindow.store(window > 0 ? window : 0, std::memory_order_relaxed);
+}
+
+std::string NativeMessageQueue::dumpWakeStats() const {
+    return base::StringPrintf("wakes issued=%" PRIu64 " coalesced=%" PRIu64 " batched=%" PRIu64
+            " batchWindow=%" PRId64 "ms",
+            mWakesIssued.load(std::memory_order_relaxed),
+            mWakesCoalesced.load(std::memory_order_relaxed),
+            mWakesBatched.load(std::memory_order_relaxed),
+            nanoseconds_to_milliseconds(mWakeBatchWindow.load(std::memory_order_relaxed)));
+}
+
 void NativeMessageQueue::setFileDescriptorEvents(int fd, int events) {
     if (events) {
         int looperEvents = 0;
@@ -230,6 +295,16 @@ static void android_os_MessageQueue_nativeWake(jlong ptr) {
     nativeMessageQueue->wake();
 }
 
+static void android_os_MessageQueue_nativeSetWakeBatchWindow(jlong ptr, jint windowMillis) {
+    NativeMessageQueue* nativeMessageQueue = reinterpret_cast<NativeMessageQueue*>(ptr);
+    nativeMessageQueue->setWakeBatchWindow(milliseconds_to_nanoseconds(windowMillis));
+}
+
+static jstring android_os_MessageQueue_nativeDumpWakeStats(JNIEnv* env, jclass clazz, jlong ptr) {
+    NativeMessageQueue* nativeMessageQueue = reinterpret_cast<NativeMessageQueue*>(ptr);
+    return env->NewStringUTF(nativeMessageQueue->dumpWakeStats().c_str());
+}
+
 static jboolean android_os_MessageQueue_nativeIsPolling(JNIEnv* env, jclass clazz, jlong ptr) {
     NativeMessageQueue* nativeMessageQueue = reinterpret_cast<NativeMessageQueue*>(ptr);
     return nativeMessageQueue->getLooper()->isPolling();
@@ -249,6 +324,10 @@ static const JNINativeMethod gMessageQueueMethods[] = {
     { "nativeDestroy", "(J)V", (void*)android_os_MessageQueue_nativeDestroy },
     { "nativePollOnce", "(JI)V", (void*)android_os_MessageQueue_nativePollOnce },
     { "nativeWake", "(J)V", (void*)android_os_MessageQueue_nativeWake },
+    { "nativeSetWakeBatchWindow", "(JI)V",
+            (void*)android_os_MessageQueue_nativeSetWakeBatchWindow },
+    { "nativeDumpWakeStats", "(J)Ljava/lang/String;",
+            (void*)android_os_MessageQueue_nativeDumpWakeStats },
     { "nativeIsPolling", "(J)Z", (void*)android_os_MessageQueue_nativeIsPolling },
     { "nativeSetFileDescriptorEvents", "(JII)V",
             (void*)android_os_MessageQueue_nativeSetFileDescriptorEvents },
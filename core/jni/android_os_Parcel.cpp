@@ -18,6 +18,7 @@
 //#define LOG_NDEBUG 0
 
 #include "android_os_Parcel.h"
+#include "android_os_ParcelGather.h"
 #include "android_util_Binder.h"
 
 #include <nativehelper/JNIPlatformHelp.h>
@@ -175,6 +176,17 @@ static void android_os_Parcel_setDataCapacity(JNIEnv* env, jclass clazz, jlong n
     }
 }
 
+static void android_os_Parcel_reserve(JNIEnv* env, jclass clazz, jlong nativePtr, jint bytes)
+{
+    Parcel* parcel = reinterpret_cast<Parcel*>(nativePtr);
+    if (parcel != NULL && bytes > 0) {
+        const status_t err = reserveParcelCapacity(parcel, bytes);
+        if (err != NO_ERROR) {
+            signalExceptionForError(env, clazz, err);
+        }
+    }
+}
+
 static jboolean android_os_Parcel_pushAllowFds(jlong nativePtr, jboolean allowFds)
 {
     Parcel* parcel = reinterpret_cast<Parcel*>(nativePtr);
@@ -259,6 +271,88 @@ static void android_os_Parcel_writeBlob(JNIEnv* env, jclass clazz, jlong nativeP
     blob.release();
 }
 
+static void android_os_Parcel_writeByteArrays(JNIEnv* env, jclass clazz, jlong nativePtr,
+                                              jobjectArray arrays)
+{
+    Parcel* parcel = reinterpret_cast<Parcel*>(nativePtr);
+    if (parcel == NULL) {
+        return;
+    }
+    if (arrays == NULL) {
+        jniThrowNullPointerException(env, NULL);
+        return;
+    }
+
+    // Size all of the arrays first, so the Parcel grows once instead of once per array.
+    const jsize count = env->GetArrayLength(arrays);
+    size_t total = 0;
+    for (jsize i = 0; i < count; i++) {
+        ScopedLocalRef<jbyteArray> array(env,
+                reinterpret_cast<jbyteArray>(env->GetObjectArrayElement(arrays, i)));
+        if (env->ExceptionCheck()) {
+            return;
+        }
+        total += parcelByteArraySize(array.get() != NULL ? env->GetArrayLength(array.get()) : -1);
+    }
+    status_t err = reserveParcelCapacity(parcel, total);
+    if (err != NO_ERROR) {
+        signalExceptionForError(env, clazz, err);
+        return;
+    }
+
+    for (jsize i = 0; i < count; i++) {
+        ScopedLocalRef<jbyteArray> array(env,
+                reinterpret_cast<jbyteArray>(env->GetObjectArrayElement(arrays, i)));
+        if (env->ExceptionCheck()) {
+            return;
+        }
+        ParcelByteRange range = { NULL, -1 };
+        if (array.get() != NULL) {
+            range.length = env->GetArrayLength(array.get());
+            range.data = env->GetPrimitiveArrayCritical(array.get(), 0);
+            if (range.data == NULL) {
+                return;
+            }
+        }
+        err = writeParcelByteRanges(parcel, &range, 1);
+        if (range.data != NULL) {
+            env->ReleasePrimitiveArrayCritical(array.get(), const_cast<void*>(range.data),
+                                               JNI_ABORT);
+        }
+        if (err != NO_ERROR) {
+            signalExceptionForError(env, clazz, err);
+            return;
+        }
+    }
+}
+
+static void android_os_Parcel_writeByteBuffer(JNIEnv* env, jclass clazz, jlong nativePtr,
+                                              jobject buffer, jint offset, jint length)
+{
+    Parcel* parcel = reinterpret_cast<Parcel*>(nativePtr);
+    if (parcel == NULL) {
+        return;
+    }
+
+    // Direct buffers are copied straight from their memory, without pinning anything.
+    const jbyte* data = reinterpret_cast<const jbyte*>(env->GetDirectBufferAddress(buffer));
+    if (data == NULL) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "not a direct buffer");
+        return;
+    }
+    const jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (offset < 0 || length < 0 || offset > capacity - length) {
+        jniThrowException(env, "java/lang/IndexOutOfBoundsException", NULL);
+        return;
+    }
+
+    const ParcelByteRange range = { data + offset, length };
+    const status_t err = writeParcelByteRanges(parcel, &range, 1);
+    if (err != NO_ERROR) {
+        signalExceptionForError(env, clazz, err);
+    }
+}
+
 static int android_os_Parcel_writeInt(jlong nativePtr, jint val) {
     Parcel* parcel = reinterpret_cast<Parcel*>(nativePtr);
     return (parcel != NULL) ? parcel->writeInt32(val) : OK;
@@ -828,6 +922,8 @@ static const JNINativeMethod gParcelMethods[] = {
     {"nativeSetDataPosition",     "(JI)V", (void*)android_os_Parcel_setDataPosition},
     // @FastNative
     {"nativeSetDataCapacity",     "(JI)V", (void*)android_os_Parcel_setDataCapacity},
+    // @FastNative
+    {"nativeReserve",             "(JI)V", (void*)android_os_Parcel_reserve},
 
     // @CriticalNative
     {"nativePushAllowFds",        "(JZ)Z", (void*)android_os_Parcel_pushAllowFds},
@@ -836,6 +932,8 @@ static const JNINativeMethod gParcelMethods[] = {
 
     {"nativeWriteByteArray",      "(J[BII)V", (void*)android_os_Parcel_writeByteArray},
     {"nativeWriteBlob",           "(J[BII)V", (void*)android_os_Parcel_writeBlob},
+    {"nativeWriteByteArrays",     "(J[[B)V", (void*)android_os_Parcel_writeByteArrays},
+    {"nativeWriteByteBuffer",     "(JLjava/nio/ByteBuffer;II)V", (void*)android_os_Parcel_writeByteBuffer},
     // @CriticalNative
     {"nativeWriteInt",            "(JI)I", (void*)android_os_Parcel_writeInt},
     // @CriticalNative
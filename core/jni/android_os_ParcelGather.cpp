@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "android_os_ParcelGather.h"
+
+#include <limits.h>
+#include <string.h>
+
+namespace android {
+
+size_t parcelByteArraySize(int32_t length) {
+    // The length, then the bytes padded to four like every Parcel write.
+    return sizeof(int32_t) + (length > 0 ? (static_cast<size_t>(length) + 3) & ~size_t(3) : 0);
+}
+
+status_t reserveParcelCapacity(Parcel* parcel, size_t extra) {
+    const size_t needed = parcel->dataPosition() + extra;
+    if (needed > INT32_MAX) {
+        return BAD_VALUE;
+    }
+    if (needed <= parcel->dataCapacity()) {
+        return NO_ERROR;
+    }
+    return parcel->setDataCapacity(needed);
+}
+
+status_t writeParcelByteRanges(Parcel* parcel, const ParcelByteRange* ranges, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += parcelByteArraySize(ranges[i].data != NULL ? ranges[i].length : -1);
+    }
+    status_t err = reserveParcelCapacity(parcel, total);
+    if (err != NO_ERROR) {
+        return err;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (ranges[i].data == NULL) {
+            err = parcel->writeInt32(-1);
+            if (err != NO_ERROR) {
+                return err;
+            }
+            continue;
+        }
+        err = parcel->writeInt32(ranges[i].length);
+        if (err != NO_ERROR) {
+            return err;
+        }
+        void* dest = parcel->writeInplace(ranges[i].length);
+        if (dest == NULL) {
+            return NO_MEMORY;
+        }
+        memcpy(dest, ranges[i].data, ranges[i].length);
+    }
+    return NO_ERROR;
+}
+
+} // namespace android
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ANDROID_OS_PARCEL_GATHER_H
+#define _ANDROID_OS_PARCEL_GATHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <binder/Parcel.h>
+
+namespace android {
+
+/* One byte array to gather into a Parcel. A null data pointer stands for a null array. */
+struct ParcelByteRange {
+    const void* data;
+    int32_t length;
+};
+
+/* Returns the number of bytes Parcel.writeByteArray() writes for an array of the given length,
+   or for a null array if length is negative. */
+size_t parcelByteArraySize(int32_t length);
+
+/* Grows parcel so that extra more bytes can be written at its current position without it
+   reallocating its data as it fills up. Never shrinks it. */
+status_t reserveParcelCapacity(Parcel* parcel, size_t extra);
+
+/* Writes each of the ranges as Parcel.writeByteArray() would, after growing parcel once for
+   all of them. The bytes are copied into the Parcel; nothing refers to the ranges afterwards. */
+status_t writeParcelByteRanges(Parcel* parcel, const ParcelByteRange* ranges, size_t count);
+
+} // namespace android
+
+#endif // _ANDROID_OS_PARCEL_GATHER_H
@@ -183,6 +183,30 @@ ScopedLockedAssetsOperation LockAndStartAssetManager(jlong ptr) {
   return ScopedLockedAssetsOperation(AssetManagerFromLong(ptr));
 }
 
+// Read-only access for resource and style lookups. Any number of these run at once, so
+// inflation threads and the UI thread no longer serialize on one AssetManager; everything that
+// changes the AssetManager or one of its themes still goes through LockAndStartAssetManager().
+struct ScopedSharedAssetsOperation {
+  ScopedSharedAssetsOperation(Guarded<AssetManager2>& guarded_am)
+        : am_(guarded_am), op_(am_->StartOperation()) {}
+
+  const AssetManager2& operator*() { return *am_; }
+
+  const AssetManager2* operator->() { return am_.get(); }
+
+  const AssetManager2* get() { return am_.get(); }
+
+  private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedSharedAssetsOperation);
+
+  ScopedSharedLock<AssetManager2> am_;
+  AssetManager2::ScopedOperation op_;
+};
+
+ScopedSharedAssetsOperation LockSharedAndStartAssetManager(jlong ptr) {
+  return ScopedSharedAssetsOperation(AssetManagerFromLong(ptr));
+}
+
 static jobject NativeGetOverlayableMap(JNIEnv* env, jclass /*clazz*/, jlong ptr,
                                        jstring package_name) {
   auto assetmanager = LockAndStartAssetManager(ptr);
@@ -681,7 +705,7 @@ static jlong NativeOpenXmlAssetFd(JNIEnv* env, jobject /*clazz*/, jlong ptr, int
 static jint NativeGetResourceValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid,
                                    jshort density, jobject typed_value,
                                    jboolean resolve_references) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   ResourceTimer _timer(ResourceTimer::Counter::GetResourceValue);
 
   auto value = assetmanager->GetResource(static_cast<uint32_t>(resid), false /*may_be_bag*/,
@@ -701,7 +725,7 @@ static jint NativeGetResourceValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jin
 
 static jint NativeGetResourceBagValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid,
                                       jint bag_entry_id, jobject typed_value) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
 
   auto bag = assetmanager->GetBag(static_cast<uint32_t>(resid));
   if (!bag.has_value()) {
@@ -729,7 +753,7 @@ static jint NativeGetResourceBagValue(JNIEnv* env, jclass /*clazz*/, jlong ptr,
 }
 
 static jintArray NativeGetStyleAttributes(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
 
   auto bag_result = assetmanager->GetBag(static_cast<uint32_t>(resid));
   if (!bag_result.has_value()) {
@@ -751,7 +775,7 @@ static jintArray NativeGetStyleAttributes(JNIEnv* env, jclass /*clazz*/, jlong p
 
 static jobjectArray NativeGetResourceStringArray(JNIEnv* env, jclass /*clazz*/, jlong ptr,
                                                  jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
 
   auto bag_result = assetmanager->GetBag(static_cast<uint32_t>(resid));
   if (!bag_result.has_value()) {
@@ -810,7 +834,7 @@ static jobjectArray NativeGetResourceStringArray(JNIEnv* env, jclass /*clazz*/,
 
 static jintArray NativeGetResourceStringArrayInfo(JNIEnv* env, jclass /*clazz*/, jlong ptr,
                                                   jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
 
   auto bag_result = assetmanager->GetBag(static_cast<uint32_t>(resid));
   if (!bag_result.has_value()) {
@@ -849,7 +873,7 @@ static jintArray NativeGetResourceStringArrayInfo(JNIEnv* env, jclass /*clazz*/,
 }
 
 static jintArray NativeGetResourceIntArray(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
 
   auto bag_result = assetmanager->GetBag(static_cast<uint32_t>(resid));
   if (!bag_result.has_value()) {
@@ -885,7 +909,7 @@ static jintArray NativeGetResourceIntArray(JNIEnv* env, jclass /*clazz*/, jlong
 }
 
 static jint NativeGetResourceArraySize(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   auto bag = assetmanager->GetBag(static_cast<uint32_t>(resid));
   if (!bag.has_value()) {
     return -1;
@@ -895,7 +919,7 @@ static jint NativeGetResourceArraySize(JNIEnv* env, jclass /*clazz*/, jlong ptr,
 
 static jint NativeGetResourceArray(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid,
                                    jintArray out_data) {
-    auto assetmanager = LockAndStartAssetManager(ptr);
+    auto assetmanager = LockSharedAndStartAssetManager(ptr);
 
     auto bag_result = assetmanager->GetBag(static_cast<uint32_t>(resid));
     if (!bag_result.has_value()) {
@@ -947,7 +971,7 @@ static jint NativeGetResourceArray(JNIEnv* env, jclass /*clazz*/, jlong ptr, jin
 }
 
 static jint NativeGetParentThemeIdentifier(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   const auto parentThemeResId = assetmanager->GetParentThemeResourceId(resid);
   return parentThemeResId.value_or(0);
 }
@@ -974,7 +998,7 @@ static jint NativeGetResourceIdentifier(JNIEnv* env, jclass /*clazz*/, jlong ptr
     package = package_utf8.c_str();
   }
 
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   auto resid = assetmanager->GetResourceId(name_utf8.c_str(), type, package);
   if (!resid.has_value()) {
     return 0;
@@ -984,7 +1008,7 @@ static jint NativeGetResourceIdentifier(JNIEnv* env, jclass /*clazz*/, jlong ptr
 }
 
 static jstring NativeGetResourceName(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   auto name = assetmanager->GetResourceName(static_cast<uint32_t>(resid));
   if (!name.has_value()) {
     return nullptr;
@@ -995,7 +1019,7 @@ static jstring NativeGetResourceName(JNIEnv* env, jclass /*clazz*/, jlong ptr, j
 }
 
 static jstring NativeGetResourcePackageName(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   auto name = assetmanager->GetResourceName(static_cast<uint32_t>(resid));
   if (!name.has_value()) {
     return nullptr;
@@ -1008,7 +1032,7 @@ static jstring NativeGetResourcePackageName(JNIEnv* env, jclass /*clazz*/, jlong
 }
 
 static jstring NativeGetResourceTypeName(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   auto name = assetmanager->GetResourceName(static_cast<uint32_t>(resid));
   if (!name.has_value()) {
     return nullptr;
@@ -1023,7 +1047,7 @@ static jstring NativeGetResourceTypeName(JNIEnv* env, jclass /*clazz*/, jlong pt
 }
 
 static jstring NativeGetResourceEntryName(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   auto name = assetmanager->GetResourceName(static_cast<uint32_t>(resid));
   if (!name.has_value()) {
     return nullptr;
@@ -1134,7 +1158,7 @@ static jobjectArray NativeGetSizeAndUiModeConfigurations(JNIEnv* env, jclass /*c
 static jintArray NativeAttributeResolutionStack(JNIEnv* env, jclass /*clazz*/, jlong ptr,
                                                 jlong theme_ptr, jint xml_style_res,
                                                 jint def_style_attr, jint def_style_resid) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   Theme* theme = reinterpret_cast<Theme*>(theme_ptr);
   CHECK(theme->GetAssetManager() == &(*assetmanager));
   (void) assetmanager;
@@ -1176,7 +1200,7 @@ static jintArray NativeAttributeResolutionStack(JNIEnv* env, jclass /*clazz*/, j
 static void NativeApplyStyle(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlong theme_ptr,
                              jint def_style_attr, jint def_style_resid, jlong xml_parser_ptr,
                              jintArray java_attrs, jlong out_values_ptr, jlong out_indices_ptr) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   Theme* theme = reinterpret_cast<Theme*>(theme_ptr);
   CHECK(theme->GetAssetManager() == &(*assetmanager));
   (void) assetmanager;
@@ -1191,9 +1215,9 @@ static void NativeApplyStyle(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlong the
     return;
   }
 
-  ApplyStyle(theme, xml_parser, static_cast<uint32_t>(def_style_attr),
-             static_cast<uint32_t>(def_style_resid), reinterpret_cast<uint32_t*>(attrs), attrs_len,
-             out_values, out_indices);
+  ApplyStyleCached(theme, xml_parser, static_cast<uint32_t>(def_style_attr),
+                   static_cast<uint32_t>(def_style_resid), reinterpret_cast<uint32_t*>(attrs),
+                   attrs_len, out_values, out_indices);
   env->ReleasePrimitiveArrayCritical(java_attrs, attrs, JNI_ABORT);
 }
 
@@ -1251,7 +1275,7 @@ static jboolean NativeResolveAttrs(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlo
     }
   }
 
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   Theme* theme = reinterpret_cast<Theme*>(theme_ptr);
   CHECK(theme->GetAssetManager() == &(*assetmanager));
   (void) assetmanager;
@@ -1310,7 +1334,7 @@ static jboolean NativeRetrieveAttributes(JNIEnv* env, jclass /*clazz*/, jlong pt
     }
   }
 
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
   ResourceTimer _timer(ResourceTimer::Counter::RetrieveAttributes);
   ResXMLParser* xml_parser = reinterpret_cast<ResXMLParser*>(xml_parser_ptr);
   auto result =
@@ -1419,7 +1443,7 @@ static void NativeThemeCopy(JNIEnv* env, jclass /*clazz*/, jlong dst_asset_manag
 static jint NativeThemeGetAttributeValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlong theme_ptr,
                                          jint resid, jobject typed_value,
                                          jboolean resolve_references) {
-  auto assetmanager = LockAndStartAssetManager(ptr);
+  auto assetmanager = LockSharedAndStartAssetManager(ptr);
 
   Theme* theme = reinterpret_cast<Theme*>(theme_ptr);
   CHECK(theme->GetAssetManager() == &(*assetmanager));
@@ -14,28 +14,52 @@
  * limitations under the License.
  */
 
+#include <androidfw/Util.h>
+
+#include <memory>
+
 #include "core_jni_helpers.h"
 #include "nativehelper/scoped_primitive_array.h"
 
 namespace android {
 
+// Strings up to this many characters are converted through a buffer on the stack
+static constexpr size_t kStackBufferChars = 256;
+
 static jint android_util_CharsetUtils_toModifiedUtf8Bytes(JNIEnv *env, jobject clazz,
         jstring src, jint srcLen, jlong dest, jint destOff, jint destLen) {
     char *destPtr = reinterpret_cast<char*>(dest);
 
+    // Copy the characters out once and encode them ourselves, which copies
+    // runs of ASCII in bulk rather than one character at a time
+    char16_t stackBuffer[kStackBufferChars];
+    std::unique_ptr<char16_t[]> heapBuffer;
+    char16_t *chars = stackBuffer;
+    if (static_cast<size_t>(srcLen) > kStackBufferChars) {
+        heapBuffer.reset(new char16_t[srcLen]);
+        chars = heapBuffer.get();
+    }
+    env->GetStringRegion(src, 0, srcLen, reinterpret_cast<jchar*>(chars));
+    if (env->ExceptionCheck()) {
+        // srcLen was out of range; chars holds nothing to encode
+        return 0;
+    }
+
     // Quickly check if destination has plenty of room for worst-case
     // 4-bytes-per-char encoded size
     const jint worstLen = (srcLen * 4);
     if (destOff >= 0 && destOff + worstLen < destLen) {
-        env->GetStringUTFRegion(src, 0, srcLen, destPtr + destOff);
-        return strlen(destPtr + destOff + srcLen) + srcLen;
+        char *end = util::EncodeModifiedUtf8(chars, srcLen, destPtr + destOff);
+        *end = '\0';
+        return end - (destPtr + destOff);
     }
 
     // String still might fit in destination, but we need to measure
     // its actual encoded size to be sure
-    const jint encodedLen = env->GetStringUTFLength(src);
+    const jint encodedLen = util::ModifiedUtf8Length(chars, srcLen);
     if (destOff >= 0 && destOff + encodedLen < destLen) {
-        env->GetStringUTFRegion(src, 0, srcLen, destPtr + destOff);
+        char *end = util::EncodeModifiedUtf8(chars, srcLen, destPtr + destOff);
+        *end = '\0';
         return encodedLen;
     }
 
@@ -46,6 +70,20 @@ static jstring android_util_CharsetUtils_fromModifiedUtf8Bytes(JNIEnv *env, jobj
         jlong src, jint srcOff, jint srcLen) {
     char *srcPtr = reinterpret_cast<char*>(src);
 
+    // Every byte decodes to at most one UTF-16 character
+    char16_t stackBuffer[kStackBufferChars];
+    std::unique_ptr<char16_t[]> heapBuffer;
+    char16_t *chars = stackBuffer;
+    if (static_cast<size_t>(srcLen) > kStackBufferChars) {
+        heapBuffer.reset(new char16_t[srcLen]);
+        chars = heapBuffer.get();
+    }
+    const ssize_t len = util::DecodeModifiedUtf8(srcPtr + srcOff, srcLen, chars);
+    if (len >= 0) {
+        return env->NewString(reinterpret_cast<const jchar*>(chars), len);
+    }
+
+    // Malformed input is left to JNI, which replaces what it cannot decode.
     // This is funky, but we need to temporarily swap a null byte so that
     // JNI knows where the string ends; we'll put it back, we promise
     char tmp = srcPtr[srcOff + srcLen];
@@ -16,11 +16,14 @@
 */
 
 #include <nativehelper/JNIHelp.h>
+#include <nativehelper/ScopedLocalRef.h>
 #include <nativehelper/ScopedPrimitiveArray.h>
 #include <nativehelper/ScopedUtfChars.h>
 #include "jni.h"
 #include "utils/Log.h"
+#include "utils/SystemClock.h"
 #include "utils/misc.h"
+#include "android_util_FileObserverBatch.h"
 #include "core_jni_helpers.h"
 
 #include <stdio.h>
@@ -30,6 +33,12 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <errno.h>
+#include <poll.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #if defined(__linux__)
 #include <sys/inotify.h>
@@ -38,6 +47,8 @@
 namespace android {
 
 static jmethodID method_onEvent;
+static jmethodID method_onEvents;
+static jclass class_String;
 
 static jint android_os_fileobserver_init(JNIEnv* env, jobject object)
 {
@@ -81,10 +92,17 @@ static void android_os_fileobserver_observe(JNIEnv* env, jobject object, jint fd
                 path = env->NewStringUTF(event->name);
             }
 
-            env->CallVoidMethod(object, method_onEvent, event->wd, event->mask, path);
             if (env->ExceptionCheck()) {
+                // Out of memory for the path; drop the event rather than call back with an
+                // exception pending.
                 env->ExceptionDescribe();
                 env->ExceptionClear();
+            } else {
+                env->CallVoidMethod(object, method_onEvent, event->wd, event->mask, path);
+                if (env->ExceptionCheck()) {
+                    env->ExceptionDescribe();
+                    env->ExceptionClear();
+                }
             }
             if (path != NULL)
             {
@@ -100,6 +118,159 @@ static void android_os_fileobserver_observe(JNIEnv* env, jobject object, jint fd
 #endif
 }
 
+#if defined(__linux__)
+
+// Room for dozens of events per read, however long their names are.
+static const size_t kBatchReadSize = 16 * 1024;
+// A batch is delivered once it holds this many events, even if its window has not passed.
+static const size_t kMaxBatchEvents = 1024;
+// Number of path strings kept alive across batches.
+static const size_t kMaxInternedPaths = 256;
+
+// Java strings for the paths of recent batches. Churning directories tend to reuse the same
+// names, so most batches need no new strings at all.
+class InternedPaths {
+public:
+    explicit InternedPaths(JNIEnv* env) : mEnv(env) {}
+
+    ~InternedPaths() {
+        clear();
+    }
+
+    jstring get(const std::string& path) {
+        auto it = mStrings.find(path);
+        if (it != mStrings.end()) {
+            return it->second;
+        }
+        if (mStrings.size() >= kMaxInternedPaths) {
+            clear();
+        }
+        ScopedLocalRef<jstring> string(mEnv, mEnv->NewStringUTF(path.c_str()));
+        if (string.get() == NULL) {
+            // Out of memory; the exception is left pending for the caller.
+            return NULL;
+        }
+        jstring global = reinterpret_cast<jstring>(mEnv->NewGlobalRef(string.get()));
+        mStrings.emplace(path, global);
+        return global;
+    }
+
+private:
+    void clear() {
+        for (const auto& [path, string] : mStrings) {
+            mEnv->DeleteGlobalRef(string);
+        }
+        mStrings.clear();
+    }
+
+    JNIEnv* const mEnv;
+    std::unordered_map<std::string, jstring> mStrings;
+};
+
+// Reads from fd into buf, retrying on EINTR. Returns false at a short read or an error.
+static bool readEvents(int fd, std::vector<char>& buf, FileObserverBatch& batch)
+{
+    while (1) {
+        ssize_t num_bytes = read(fd, buf.data(), buf.size());
+        if (num_bytes < (ssize_t)sizeof(struct inotify_event)) {
+            if (num_bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        return batch.add(buf.data(), num_bytes);
+    }
+}
+
+static void deliverBatch(JNIEnv* env, jobject object, const FileObserverBatch& batch,
+                         InternedPaths& internedPaths, ScopedLocalRef<jintArray>& eventsArray)
+{
+    // The events array is reused while it is large enough; the callback must not keep it.
+    const jsize eventInts = batch.events().size();
+    if (eventsArray.get() == NULL || env->GetArrayLength(eventsArray.get()) < eventInts) {
+        eventsArray.reset(env->NewIntArray(
+                std::max<jsize>(eventInts, kMaxBatchEvents * FileObserverBatch::EVENT_FIELDS)));
+        if (eventsArray.get() == NULL) {
+            env->ExceptionClear();
+            return;
+        }
+    }
+    env->SetIntArrayRegion(eventsArray.get(), 0, eventInts, batch.events().data());
+
+    ScopedLocalRef<jobjectArray> paths(env,
+            env->NewObjectArray(batch.paths().size(), class_String, NULL));
+    if (paths.get() == NULL) {
+        env->ExceptionClear();
+        return;
+    }
+    for (size_t i = 0; i < batch.paths().size(); i++) {
+        jstring path = internedPaths.get(batch.paths()[i]);
+        if (env->ExceptionCheck()) {
+            // Out of memory for a path; drop the batch rather than deliver it with an
+            // exception pending.
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+            return;
+        }
+        env->SetObjectArrayElement(paths.get(), i, path);
+    }
+
+    env->CallVoidMethod(object, method_onEvents, eventsArray.get(), (jint)batch.eventCount(),
+                        paths.get());
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+}
+
+#endif
+
+static void android_os_fileobserver_observeBatched(JNIEnv* env, jobject object, jint fd,
+                                                   jint windowMillis)
+{
+#if defined(__linux__)
+
+    std::vector<char> buf(kBatchReadSize);
+    FileObserverBatch batch;
+    InternedPaths internedPaths(env);
+    ScopedLocalRef<jintArray> eventsArray(env, NULL);
+
+    while (1)
+    {
+        // Wait for the first events of a batch...
+        if (!readEvents(fd, buf, batch)) {
+            ALOGE("***** ERROR! android_os_fileobserver_observeBatched() got a short event!");
+            return;
+        }
+
+        // ...then take whatever else arrives within the window.
+        const int64_t deadline = uptimeMillis() + std::max(windowMillis, 0);
+        while (batch.eventCount() < kMaxBatchEvents) {
+            const int64_t timeout = deadline - uptimeMillis();
+            if (timeout <= 0) {
+                break;
+            }
+            struct pollfd pfd = { fd, POLLIN, 0 };
+            const int ready = poll(&pfd, 1, (int)timeout);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready <= 0) {
+                break;
+            }
+            if (!readEvents(fd, buf, batch)) {
+                ALOGE("***** ERROR! android_os_fileobserver_observeBatched() got a short event!");
+                return;
+            }
+        }
+
+        deliverBatch(env, object, batch, internedPaths, eventsArray);
+        batch.clear();
+    }
+
+#endif
+}
+
 static void android_os_fileobserver_startWatching(JNIEnv* env, jobject object, jint fd,
                                                        jobjectArray pathStrings, jint mask,
                                                        jintArray wfdArray)
@@ -147,6 +318,7 @@ static const JNINativeMethod sMethods[] = {
      /* name, signature, funcPtr */
     { "init", "()I", (void*)android_os_fileobserver_init },
     { "observe", "(I)V", (void*)android_os_fileobserver_observe },
+    { "observeBatched", "(II)V", (void*)android_os_fileobserver_observeBatched },
     { "startWatching", "(I[Ljava/lang/String;I[I)V", (void*)android_os_fileobserver_startWatching },
     { "stopWatching", "(I[I)V", (void*)android_os_fileobserver_stopWatching }
 
@@ -157,6 +329,8 @@ int register_android_os_FileObserver(JNIEnv* env)
     jclass clazz = FindClassOrDie(env, "android/os/FileObserver$ObserverThread");
 
     method_onEvent = GetMethodIDOrDie(env, clazz, "onEvent", "(IILjava/lang/String;)V");
+    method_onEvents = GetMethodIDOrDie(env, clazz, "onEvents", "([II[Ljava/lang/String;)V");
+    class_String = MakeGlobalRefOrDie(env, FindClassOrDie(env, "java/lang/String"));
 
     return RegisterMethodsOrDie(env, "android/os/FileObserver$ObserverThread", sMethods,
                                 NELEM(sMethods));
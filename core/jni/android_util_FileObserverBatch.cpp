@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "android_util_FileObserverBatch.h"
+
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+namespace android {
+
+bool FileObserverBatch::add(const char* buf, size_t size) {
+#if defined(__linux__)
+    while (size >= sizeof(struct inotify_event)) {
+        struct inotify_event event;
+        memcpy(&event, buf, sizeof(event));
+        const size_t eventSize = sizeof(event) + event.len;
+        if (eventSize > size) {
+            return false;
+        }
+        // The name is NUL padded to len bytes.
+        addEvent(event.wd, event.mask, event.len > 0 ? buf + sizeof(event) : NULL);
+        buf += eventSize;
+        size -= eventSize;
+    }
+#endif
+    return size == 0;
+}
+
+void FileObserverBatch::clear() {
+    mEvents.clear();
+    mPaths.clear();
+    mPathIndices.clear();
+    mLastEvents.clear();
+}
+
+void FileObserverBatch::addEvent(int32_t wd, uint32_t mask, const char* name) {
+    mAdded++;
+
+    int32_t pathIndex = -1;
+    if (name != NULL) {
+        auto [it, inserted] = mPathIndices.try_emplace(name, mPaths.size());
+        if (inserted) {
+            mPaths.push_back(it->first);
+        }
+        pathIndex = it->second;
+    }
+
+    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(wd)) << 32)
+            | static_cast<uint32_t>(pathIndex);
+    auto [last, first] = mLastEvents.try_emplace(key, mEvents.size());
+    if (!first) {
+        if (static_cast<uint32_t>(mEvents[last->second + EVENT_MASK]) == mask) {
+            mCoalesced++;
+            return;
+        }
+        last->second = mEvents.size();
+    }
+    mEvents.push_back(wd);
+    mEvents.push_back(static_cast<int32_t>(mask));
+    mEvents.push_back(pathIndex);
+}
+
+} // namespace android
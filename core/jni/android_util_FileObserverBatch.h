@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ANDROID_UTIL_FILE_OBSERVER_BATCH_H
+#define _ANDROID_UTIL_FILE_OBSERVER_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace android {
+
+/* Collects the events read from an inotify fd so they can be delivered together.
+ *
+ * An event that repeats the last event of the same watch and path in the batch is dropped, so a
+ * file written in many small chunks reports one IN_MODIFY per batch, while a file that is
+ * created, deleted and created again still reports all three. Paths are interned: each distinct
+ * path of a batch is stored once and events refer to it by index. */
+class FileObserverBatch {
+public:
+    /* Events are packed as EVENT_FIELDS ints each. */
+    enum {
+        EVENT_WD = 0,
+        EVENT_MASK = 1,
+        EVENT_PATH_INDEX = 2, // into paths(), or -1 for an event without a path
+        EVENT_FIELDS = 3,
+    };
+
+    /* Adds the events of one read() from an inotify fd. Returns false if buf ends in the middle
+       of an event. */
+    bool add(const char* buf, size_t size);
+
+    /* Forgets the events and paths, keeping the memory for the next batch. */
+    void clear();
+
+    size_t eventCount() const { return mEvents.size() / EVENT_FIELDS; }
+    const std::vector<int32_t>& events() const { return mEvents; }
+    const std::vector<std::string>& paths() const { return mPaths; }
+
+    /* Number of events added since construction, and how many of them were dropped. */
+    uint64_t added() const { return mAdded; }
+    uint64_t coalesced() const { return mCoalesced; }
+
+private:
+    void addEvent(int32_t wd, uint32_t mask, const char* name);
+
+    std::vector<int32_t> mEvents;
+    std::vector<std::string> mPaths;
+    std::unordered_map<std::string, int32_t> mPathIndices;
+    /* Index into mEvents of the last event of each (watch, path index). */
+    std::unordered_map<uint64_t, size_t> mLastEvents;
+    uint64_t mAdded = 0;
+    uint64_t mCoalesced = 0;
+};
+
+} // namespace android
+
+#endif // _ANDROID_UTIL_FILE_OBSERVER_BATCH_H
@@ -24,7 +24,9 @@
 #include <utils/Log.h>
 
 #include <androidfw/ResourceTypes.h>
+#include <androidfw/Util.h>
 
+#include <memory>
 #include <stdio.h>
 
 namespace android {
@@ -76,6 +78,19 @@ static jstring android_content_StringBlock_nativeGetString(JNIEnv* env, jobject
     }
 
     if (auto str8 = osb->string8At(idx); str8.has_value()) {
+        // Decode here rather than in NewStringUTF, which goes one character at a time
+        // and has to find the end of the string first.
+        char16_t stackBuffer[256];
+        std::unique_ptr<char16_t[]> heapBuffer;
+        char16_t* chars = stackBuffer;
+        if (str8->size() > NELEM(stackBuffer)) {
+            heapBuffer.reset(new char16_t[str8->size()]);
+            chars = heapBuffer.get();
+        }
+        const ssize_t len = util::DecodeModifiedUtf8(str8->data(), str8->size(), chars);
+        if (len >= 0) {
+            return env->NewString(reinterpret_cast<const jchar*>(chars), len);
+        }
         return env->NewStringUTF(str8->data());
     }
 
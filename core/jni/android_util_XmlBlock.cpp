@@ -25,12 +25,16 @@
 #include <utils/Log.h>
 #include <utils/misc.h>
 
+#include "android_util_XmlBlockEvents.h"
+
 #include <stdio.h>
 
+#include <vector>
+
 namespace android {
+using namespace xmlblock;
+
 constexpr int kNullDocument = UNEXPECTED_NULL;
-// The reason not to ResXMLParser::BAD_DOCUMENT which is -1 is that other places use the same value.
-constexpr int kBadDocument = BAD_VALUE;
 
 // ----------------------------------------------------------------------------
 
@@ -101,28 +105,63 @@ static jint android_content_XmlBlock_nativeNext(CRITICAL_JNI_PARAMS_COMMA jlong
         return ResXMLParser::END_DOCUMENT;
     }
 
-    do {
-        ResXMLParser::event_code_t code = st->next();
-        switch (code) {
-            case ResXMLParser::START_TAG:
-                return 2;
-            case ResXMLParser::END_TAG:
-                return 3;
-            case ResXMLParser::TEXT:
-                return 4;
-            case ResXMLParser::START_DOCUMENT:
-                return 0;
-            case ResXMLParser::END_DOCUMENT:
-                return 1;
-            case ResXMLParser::BAD_DOCUMENT:
-                goto bad;
-            default:
-                break;
-        }
-    } while (true);
-
-bad:
-    return kBadDocument;
+    return nextEvent(st);
+}
+
+/*
+ * nativeNext followed by all of the getters for the new event, in one transition. If the
+ * start tag has more attributes than fit in out, the rest are left unwritten and can still be
+ * read with nativeGetAttribute*, since the parser stays on the tag.
+ */
+static jint android_content_XmlBlock_nativeNextBulk(JNIEnv* env, jobject clazz, jlong token,
+                                                    jintArray out)
+{
+    ResXMLParser* st = reinterpret_cast<ResXMLParser*>(token);
+    if (st == NULL || out == NULL) {
+        jniThrowNullPointerException(env, NULL);
+        return 0;
+    }
+
+    jsize capacity = env->GetArrayLength(out);
+    if (capacity < kEventHeaderSize) {
+        jniThrowException(env, "java/lang/IndexOutOfBoundsException", NULL);
+        return 0;
+    }
+
+    jint event = nextEvent(st);
+    jint* data = reinterpret_cast<jint*>(env->GetPrimitiveArrayCritical(out, NULL));
+    if (data == NULL) {
+        return 0;
+    }
+    writeEvent(st, event, data, capacity);
+    env->ReleasePrimitiveArrayCritical(out, data, 0);
+
+    return event;
+}
+
+/*
+ * Decodes every remaining event of the document up front into one flat array of events laid
+ * out as for nativeNextBulk, so that the Java parser can walk it without going back to native.
+ * The last event is END_DOCUMENT, or kBadDocument where the document turned out to be corrupt.
+ * The parse state's own position is left unchanged.
+ */
+static jintArray android_content_XmlBlock_nativeDecodeDocument(JNIEnv* env, jobject clazz,
+                                                               jlong token)
+{
+    ResXMLParser* st = reinterpret_cast<ResXMLParser*>(token);
+    if (st == NULL) {
+        jniThrowNullPointerException(env, NULL);
+        return NULL;
+    }
+
+    std::vector<int32_t> events = decodeDocument(st);
+
+    jintArray result = env->NewIntArray(events.size());
+    if (result == NULL) {
+        return NULL;
+    }
+    env->SetIntArrayRegion(result, 0, events.size(), events.data());
+    return result;
 }
 
 static jint android_content_XmlBlock_nativeGetNamespace(CRITICAL_JNI_PARAMS_COMMA jlong token) {
@@ -268,8 +307,7 @@ static jint android_content_XmlBlock_nativeGetIdAttribute(CRITICAL_JNI_PARAMS_CO
         return kNullDocument;
     }
 
-    ssize_t idx = st->indexOfID();
-    return idx >= 0 ? static_cast<jint>(st->getAttributeValueStringID(idx)) : -1;
+    return stringAttribute(st, st->indexOfID());
 }
 
 static jint android_content_XmlBlock_nativeGetClassAttribute(
@@ -279,8 +317,7 @@ static jint android_content_XmlBlock_nativeGetClassAttribute(
         return kNullDocument;
     }
 
-    ssize_t idx = st->indexOfClass();
-    return idx >= 0 ? static_cast<jint>(st->getAttributeValueStringID(idx)) : -1;
+    return stringAttribute(st, st->indexOfClass());
 }
 
 static jint android_content_XmlBlock_nativeGetStyleAttribute(
@@ -290,19 +327,7 @@ static jint android_content_XmlBlock_nativeGetStyleAttribute(
         return kNullDocument;
     }
 
-    ssize_t idx = st->indexOfStyle();
-    if (idx < 0) {
-        return 0;
-    }
-
-    Res_value value;
-    if (st->getAttributeValue(idx, &value) < 0) {
-        return 0;
-    }
-
-    return value.dataType == value.TYPE_REFERENCE
-        || value.dataType == value.TYPE_ATTRIBUTE
-        ? value.data : 0;
+    return styleAttribute(st);
 }
 
 static jint android_content_XmlBlock_nativeGetSourceResId(CRITICAL_JNI_PARAMS_COMMA jlong token) {
@@ -355,11 +380,15 @@ static const JNINativeMethod gXmlBlockMethods[] = {
             (void*) android_content_XmlBlock_nativeDestroyParseState },
     { "nativeDestroy",              "(J)V",
             (void*) android_content_XmlBlock_nativeDestroy },
+    { "nativeDecodeDocument",       "(J)[I",
+            (void*) android_content_XmlBlock_nativeDecodeDocument },
 
     // ------------------- @FastNative ----------------------
 
     { "nativeNext",                 "(J)I",
             (void*) android_content_XmlBlock_nativeNext },
+    { "nativeNextBulk",             "(J[I)I",
+            (void*) android_content_XmlBlock_nativeNextBulk },
     { "nativeGetNamespace",         "(J)I",
             (void*) android_content_XmlBlock_nativeGetNamespace },
     { "nativeGetName",              "(J)I",
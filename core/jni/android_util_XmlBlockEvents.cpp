@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "android_util_XmlBlockEvents.h"
+
+#include <algorithm>
+
+namespace android {
+namespace xmlblock {
+
+int32_t nextEvent(ResXMLParser* st) {
+    do {
+        ResXMLParser::event_code_t code = st->next();
+        switch (code) {
+            case ResXMLParser::START_TAG:
+                return 2;
+            case ResXMLParser::END_TAG:
+                return 3;
+            case ResXMLParser::TEXT:
+                return 4;
+            case ResXMLParser::START_DOCUMENT:
+                return 0;
+            case ResXMLParser::END_DOCUMENT:
+                return 1;
+            case ResXMLParser::BAD_DOCUMENT:
+                return kBadDocument;
+            default:
+                break;
+        }
+    } while (true);
+}
+
+int32_t stringAttribute(const ResXMLParser* st, ssize_t idx) {
+    return idx >= 0 ? static_cast<int32_t>(st->getAttributeValueStringID(idx)) : -1;
+}
+
+int32_t styleAttribute(const ResXMLParser* st) {
+    ssize_t idx = st->indexOfStyle();
+    if (idx < 0) {
+        return 0;
+    }
+
+    Res_value value;
+    if (st->getAttributeValue(idx, &value) < 0) {
+        return 0;
+    }
+
+    return value.dataType == value.TYPE_REFERENCE
+        || value.dataType == value.TYPE_ATTRIBUTE
+        ? value.data : 0;
+}
+
+size_t writeEvent(const ResXMLParser* st, int32_t event, int32_t* out, size_t capacity) {
+    const bool isTag = event == 2 || event == 3;
+    const size_t attributeCount = event == 2 ? st->getAttributeCount() : 0;
+    out[kEventCode] = event;
+    out[kEventLineNumber] = event == kBadDocument ? -1 : static_cast<int32_t>(st->getLineNumber());
+    out[kEventNamespace] = isTag ? static_cast<int32_t>(st->getElementNamespaceID()) : -1;
+    out[kEventName] = isTag ? static_cast<int32_t>(st->getElementNameID())
+            : event == 4 ? static_cast<int32_t>(st->getTextID()) : -1;
+    out[kEventIdAttribute] = event == 2 ? stringAttribute(st, st->indexOfID()) : -1;
+    out[kEventClassAttribute] = event == 2 ? stringAttribute(st, st->indexOfClass()) : -1;
+    out[kEventStyleAttribute] = event == 2 ? styleAttribute(st) : 0;
+    out[kEventAttributeCount] = static_cast<int32_t>(attributeCount);
+
+    const size_t written = std::min(attributeCount,
+            (capacity - kEventHeaderSize) / kAttributeStride);
+    int32_t* attr = out + kEventHeaderSize;
+    for (size_t i = 0; i < written; i++, attr += kAttributeStride) {
+        attr[kAttributeNamespace] = static_cast<int32_t>(st->getAttributeNamespaceID(i));
+        attr[kAttributeName] = static_cast<int32_t>(st->getAttributeNameID(i));
+        attr[kAttributeResource] = static_cast<int32_t>(st->getAttributeNameResID(i));
+        attr[kAttributeDataType] = static_cast<int32_t>(st->getAttributeDataType(i));
+        attr[kAttributeData] = static_cast<int32_t>(st->getAttributeData(i));
+        attr[kAttributeStringValue] = static_cast<int32_t>(st->getAttributeValueStringID(i));
+    }
+    return written;
+}
+
+std::vector<int32_t> decodeDocument(ResXMLParser* st) {
+    ResXMLParser::ResXMLPosition position;
+    st->getPosition(&position);
+
+    std::vector<int32_t> events;
+    int32_t event;
+    do {
+        event = nextEvent(st);
+        const size_t attributeCount = event == 2 ? st->getAttributeCount() : 0;
+        const size_t size = kEventHeaderSize + attributeCount * kAttributeStride;
+        const size_t start = events.size();
+        events.resize(start + size);
+        writeEvent(st, event, events.data() + start, size);
+    } while (event != 1 && event != kBadDocument);
+
+    st->setPosition(position);
+    return events;
+}
+
+} // namespace xmlblock
+} // namespace android
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _ANDROID_UTIL_XML_BLOCK_EVENTS_H
+#define _ANDROID_UTIL_XML_BLOCK_EVENTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <androidfw/ResourceTypes.h>
+
+#include <vector>
+
+namespace android {
+namespace xmlblock {
+
+// The reason not to ResXMLParser::BAD_DOCUMENT which is -1 is that other places use the same value.
+constexpr int32_t kBadDocument = BAD_VALUE;
+
+/*
+ * Layout of one event as written by writeEvent: a header of kEventHeaderSize ints, followed for
+ * START_TAG by kAttributeStride ints per attribute.
+ */
+enum {
+    kEventCode = 0,
+    kEventLineNumber,
+    kEventNamespace,        // element namespace for START_TAG and END_TAG, else -1
+    kEventName,             // element name for START_TAG and END_TAG, text for TEXT, else -1
+    kEventIdAttribute,      // as nativeGetIdAttribute, START_TAG only
+    kEventClassAttribute,   // as nativeGetClassAttribute, START_TAG only
+    kEventStyleAttribute,   // as nativeGetStyleAttribute, START_TAG only
+    kEventAttributeCount,
+    kEventHeaderSize
+};
+
+enum {
+    kAttributeNamespace = 0,
+    kAttributeName,
+    kAttributeResource,
+    kAttributeDataType,
+    kAttributeData,
+    kAttributeStringValue,
+    kAttributeStride
+};
+
+// Advances st and maps its event to the XmlPullParser constant that XmlBlock.Parser expects.
+int32_t nextEvent(ResXMLParser* st);
+
+// The string pool index of attribute idx's string value, or -1 if there is no such attribute.
+int32_t stringAttribute(const ResXMLParser* st, ssize_t idx);
+
+// The resource the style attribute of the current tag refers to, or 0.
+int32_t styleAttribute(const ResXMLParser* st);
+
+/*
+ * Writes the header of the event st is positioned on, and as many of its attributes as fit in
+ * capacity ints. out must hold at least kEventHeaderSize ints. Returns the number of attributes
+ * written; the header always carries the full attribute count.
+ */
+size_t writeEvent(const ResXMLParser* st, int32_t event, int32_t* out, size_t capacity);
+
+/*
+ * Writes every remaining event of the document, up to and including END_DOCUMENT or
+ * kBadDocument, laid out as for writeEvent. The position of st is left unchanged.
+ */
+std::vector<int32_t> decodeDocument(ResXMLParser* st);
+
+} // namespace xmlblock
+} // namespace android
+
+#endif // _ANDROID_UTIL_XML_BLOCK_EVENTS_H
@@ -22,8 +22,11 @@
 #include <input/Input.h>
 #include <input/VelocityTracker.h>
 #include <nativehelper/JNIHelp.h>
+#include <nativehelper/ScopedPrimitiveArray.h>
 #include <nativehelper/ScopedUtfChars.h>
 
+#include <algorithm>
+
 #include "android_view_MotionEvent.h"
 #include "core_jni_helpers.h"
 
@@ -40,10 +43,14 @@ public:
 
     void clear();
     void addMovement(const MotionEvent& event);
-    // TODO(b/32830165): consider supporting an overload that supports computing velocity only for
-    // a subset of the supported axes.
     void computeCurrentVelocity(int32_t units, float maxVelocity);
     float getVelocity(int32_t axis, int32_t id);
+    // Computes the velocity along each of the axes of each of the pointers into
+    // outVelocities[pointer * axisCount + axis]. Unlike computeCurrentVelocity(), only the
+    // requested axes of the requested pointers are fitted.
+    void computeVelocities(int32_t units, float maxVelocity, const int32_t* axes,
+                           size_t axisCount, const int32_t* ids, size_t idCount,
+                           float* outVelocities) const;
 
 private:
     VelocityTracker mVelocityTracker;
@@ -73,6 +80,23 @@ float VelocityTrackerState::getVelocity(int32_t axis, int32_t id) {
     return mComputedVelocity.getVelocity(axis, id).value_or(0);
 }
 
+void VelocityTrackerState::computeVelocities(int32_t units, float maxVelocity,
+                                             const int32_t* axes, size_t axisCount,
+                                             const int32_t* ids, size_t idCount,
+                                             float* outVelocities) const {
+    for (size_t i = 0; i < idCount; i++) {
+        const int32_t id = ids[i] == ACTIVE_POINTER_ID ? mVelocityTracker.getActivePointerId()
+                                                       : ids[i];
+        for (size_t j = 0; j < axisCount; j++) {
+            // Scaled and clamped the same way as VelocityTracker::getComputedVelocity().
+            const std::optional<float> velocity = mVelocityTracker.getVelocity(axes[j], id);
+            *outVelocities++ = velocity.has_value()
+                    ? std::clamp(*velocity * units / 1000, -maxVelocity, maxVelocity)
+                    : 0;
+        }
+    }
+}
+
 // Return a strategy enum from integer value.
 inline static VelocityTracker::Strategy getStrategyFromInt(const int32_t strategy) {
     if (strategy < static_cast<int32_t>(VelocityTracker::Strategy::MIN) ||
@@ -123,6 +147,34 @@ static jfloat android_view_VelocityTracker_nativeGetVelocity(JNIEnv* env, jclass
     return state->getVelocity(axis, id);
 }
 
+static void android_view_VelocityTracker_nativeComputeVelocities(JNIEnv* env, jclass clazz,
+        jlong ptr, jint units, jfloat maxVelocity, jintArray axesArray, jintArray idsArray,
+        jfloatArray outVelocitiesArray) {
+    ScopedIntArrayRO axes(env, axesArray);
+    ScopedIntArrayRO ids(env, idsArray);
+    ScopedFloatArrayRW outVelocities(env, outVelocitiesArray);
+    if (axes.get() == nullptr || ids.get() == nullptr || outVelocities.get() == nullptr) {
+        return;
+    }
+    if (outVelocities.size() < axes.size() * ids.size()) {
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                          "outVelocities is too small for every axis of every pointer");
+        return;
+    }
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (ids[i] != ACTIVE_POINTER_ID && (ids[i] < 0 || ids[i] > MAX_POINTER_ID)) {
+            jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException",
+                                 "Invalid pointer id %d, must be between 0 and %d", ids[i],
+                                 MAX_POINTER_ID);
+            return;
+        }
+    }
+
+    VelocityTrackerState* state = reinterpret_cast<VelocityTrackerState*>(ptr);
+    state->computeVelocities(units, maxVelocity, axes.get(), axes.size(), ids.get(), ids.size(),
+                             outVelocities.get());
+}
+
 static jboolean android_view_VelocityTracker_nativeIsAxisSupported(JNIEnv* env, jclass clazz,
                                                                    jint axis) {
     return VelocityTracker::isAxisSupported(axis);
@@ -140,6 +192,8 @@ static const JNINativeMethod gVelocityTrackerMethods[] = {
         {"nativeComputeCurrentVelocity", "(JIF)V",
          (void*)android_view_VelocityTracker_nativeComputeCurrentVelocity},
         {"nativeGetVelocity", "(JII)F", (void*)android_view_VelocityTracker_nativeGetVelocity},
+        {"nativeComputeVelocities", "(JIF[I[I[F)V",
+         (void*)android_view_VelocityTracker_nativeComputeVelocities},
         {"nativeIsAxisSupported", "(I)Z",
          (void*)android_view_VelocityTracker_nativeIsAxisSupported},
 };
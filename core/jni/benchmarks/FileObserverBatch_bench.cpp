@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "../android_util_FileObserverBatch.h"
+
+namespace android {
+
+constexpr int kFiles = 2000;
+constexpr int kNames = 64;
+constexpr int kOpenAtOnce = 4;
+
+// Creates kFiles files cycling through kNames names in dir, writes to a few of them at a time in
+// turns, then deletes them, as a download or media scan storm would.
+static void storm(const std::string& dir) {
+    for (int i = 0; i < kFiles; i += kOpenAtOnce) {
+        std::string paths[kOpenAtOnce];
+        int fds[kOpenAtOnce];
+        for (int j = 0; j < kOpenAtOnce; j++) {
+            paths[j] = dir + "/file" + std::to_string((i + j) % kNames);
+            fds[j] = open(paths[j].c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0600);
+        }
+        for (int round = 0; round < 8; round++) {
+            for (int j = 0; j < kOpenAtOnce; j++) {
+                if (write(fds[j], "x", 1) != 1) {
+                    break;
+                }
+            }
+        }
+        for (int j = 0; j < kOpenAtOnce; j++) {
+            close(fds[j]);
+            unlink(paths[j].c_str());
+        }
+    }
+}
+
+// Arg(0) makes a string and a callback per event, as observe() does. Arg(1) batches the events
+// as observeBatched() does, with one callback per batch. Only reading the events is timed.
+static void BM_FileObserverStorm(benchmark::State& state) {
+    char dirTemplate[] = "/data/local/tmp/fileobserverXXXXXX";
+    char* dir = mkdtemp(dirTemplate);
+    if (dir == nullptr) {
+        state.SkipWithError("mkdtemp failed");
+        return;
+    }
+    const int fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    inotify_add_watch(fd, dir, IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE);
+
+    std::vector<char> buf(16 * 1024);
+    FileObserverBatch batch;
+    uint64_t events = 0;
+    uint64_t delivered = 0;
+    uint64_t strings = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        storm(dir);
+        state.ResumeTiming();
+
+        ssize_t size;
+        while ((size = read(fd, buf.data(), buf.size())) > 0) {
+            if (state.range(0) != 0) {
+                batch.add(buf.data(), size);
+                continue;
+            }
+            for (ssize_t pos = 0; pos < size;) {
+                const inotify_event* event = reinterpret_cast<inotify_event*>(&buf[pos]);
+                std::string path(event->len > 0 ? event->name : "");
+                benchmark::DoNotOptimize(path);
+                events++;
+                delivered++;
+                strings++;
+                pos += sizeof(*event) + event->len;
+            }
+        }
+        if (state.range(0) != 0) {
+            events = batch.added();
+            delivered += batch.eventCount();
+            strings += batch.paths().size();
+            batch.clear();
+        }
+    }
+    if (state.range(0) != 0) {
+        events = batch.added();
+    }
+    state.counters["events"] = benchmark::Counter(events, benchmark::Counter::kAvgIterations);
+    state.counters["delivered"] =
+            benchmark::Counter(delivered, benchmark::Counter::kAvgIterations);
+    state.counters["strings"] = benchmark::Counter(strings, benchmark::Counter::kAvgIterations);
+
+    close(fd);
+    rmdir(dir);
+}
+// The storm itself is not timed, so a time based iteration count would run it far too often.
+BENCHMARK(BM_FileObserverStorm)->Arg(0)->Arg(1)->Iterations(20)->Unit(benchmark::kMillisecond);
+
+} // namespace android
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string.h>
+
+#include <vector>
+
+#include "../android_os_ParcelGather.h"
+
+namespace android {
+
+constexpr size_t kPayloadSize = 1024 * 1024;
+
+// Every variant below copies the whole payload into the Parcel. There is no zero-copy or
+// scatter-gather path to compare against, since Parcel data has to be contiguous; gathering
+// only saves the reallocations of a Parcel that grows array by array.
+
+// A 1MB payload split into state.range(0) byte arrays, as a Bundle of many entries would be.
+static std::vector<std::vector<uint8_t>> payload(const benchmark::State& state) {
+    const size_t count = state.range(0);
+    return std::vector<std::vector<uint8_t>>(count, std::vector<uint8_t>(kPayloadSize / count, 1));
+}
+
+// What Parcel.writeByteArray() does today: every array grows the Parcel as it needs to.
+static void BM_ParcelWriteByteArrays(benchmark::State& state) {
+    const auto arrays = payload(state);
+    for (auto _ : state) {
+        Parcel parcel;
+        for (const auto& array : arrays) {
+            parcel.writeInt32(array.size());
+            memcpy(parcel.writeInplace(array.size()), array.data(), array.size());
+        }
+        benchmark::DoNotOptimize(parcel.data());
+    }
+    state.SetBytesProcessed(state.iterations() * kPayloadSize);
+}
+BENCHMARK(BM_ParcelWriteByteArrays)->Arg(1)->Arg(16)->Arg(256);
+
+// The same arrays gathered by writeParcelByteRanges(), which sizes the Parcel once.
+static void BM_ParcelWriteByteRanges(benchmark::State& state) {
+    const auto arrays = payload(state);
+    std::vector<ParcelByteRange> ranges;
+    for (const auto& array : arrays) {
+        ranges.push_back({array.data(), static_cast<int32_t>(array.size())});
+    }
+    for (auto _ : state) {
+        Parcel parcel;
+        writeParcelByteRanges(&parcel, ranges.data(), ranges.size());
+        benchmark::DoNotOptimize(parcel.data());
+    }
+    state.SetBytesProcessed(state.iterations() * kPayloadSize);
+    state.SetLabel("copying, not zero-copy");
+}
+BENCHMARK(BM_ParcelWriteByteRanges)->Arg(1)->Arg(16)->Arg(256);
+
+// A 1MB blob, which large payloads already go through: a copy into ashmem.
+static void BM_ParcelWriteBlob(benchmark::State& state) {
+    const std::vector<uint8_t> blob(kPayloadSize, 1);
+    for (auto _ : state) {
+        Parcel parcel;
+        Parcel::WritableBlob out;
+        if (parcel.writeBlob(blob.size(), false, &out) != NO_ERROR) {
+            state.SkipWithError("writeBlob failed");
+            break;
+        }
+        memcpy(out.data(), blob.data(), blob.size());
+        out.release();
+    }
+    state.SetBytesProcessed(state.iterations() * kPayloadSize);
+}
+BENCHMARK(BM_ParcelWriteBlob);
+
+} // namespace android
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <sqlite3.h>
+
+#include "../android_database_SQLiteBatch.h"
+
+namespace android {
+
+constexpr size_t kRows = 100000;
+
+// Three columns per row: an integer, a double and a short string.
+struct Rows {
+    std::vector<int8_t> types;
+    std::vector<int64_t> values;
+    std::u16string text;
+
+    Rows() {
+        for (size_t i = 0; i < kRows; i++) {
+            const double d = i * 0.5;
+            int64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            const std::u16string name = u"row " + std::u16string(1, u'a' + i % 26);
+            types.insert(types.end(),
+                         {SQLITE_BATCH_INTEGER, SQLITE_BATCH_FLOAT, SQLITE_BATCH_STRING});
+            values.insert(values.end(), {static_cast<int64_t>(i), bits,
+                                         static_cast<int64_t>(text.size()) << 32 |
+                                                 static_cast<int64_t>(name.size())});
+            text += name;
+        }
+    }
+
+    SQLiteBatch batch() const {
+        return SQLiteBatch{kRows,       3, types.data(), values.data(), text.data(), text.size(),
+                           nullptr,     0};
+    }
+};
+
+static const Rows& rows() {
+    static Rows* sRows = new Rows();
+    return *sRows;
+}
+
+static sqlite3_stmt* prepareInsert(sqlite3** db) {
+    sqlite3_open(":memory:", db);
+    sqlite3_exec(*db, "CREATE TABLE t (a INTEGER, b REAL, c TEXT)", nullptr, nullptr, nullptr);
+    sqlite3_stmt* statement;
+    sqlite3_prepare_v2(*db, "INSERT INTO t VALUES (?, ?, ?)", -1, &statement, nullptr);
+    return statement;
+}
+
+static void finish(benchmark::State& state, sqlite3* db, sqlite3_stmt* statement) {
+    sqlite3_finalize(statement);
+    sqlite3_close(db);
+    state.SetItemsProcessed(state.iterations() * kRows);
+}
+
+// What SQLiteConnection does for every row today: a separate native call per bind, then one to
+// execute and one to reset the statement and clear its bindings.
+static void BM_SQLiteInsertPerRow(benchmark::State& state) {
+    const Rows& data = rows();
+    sqlite3* db;
+    sqlite3_stmt* statement = prepareInsert(&db);
+    for (auto _ : state) {
+        sqlite3_exec(db, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+        for (size_t row = 0; row < kRows; row++) {
+            const int64_t* values = &data.values[row * 3];
+            double d;
+            memcpy(&d, &values[1], sizeof(d));
+            // Each string is copied out of its java.lang.String, so SQLite has to copy it too.
+            sqlite3_bind_int64(statement, 1, values[0]);
+            sqlite3_bind_double(statement, 2, d);
+            sqlite3_bind_text16(statement, 3, data.text.data() + (values[2] >> 32),
+                                static_cast<uint32_t>(values[2]) * sizeof(char16_t),
+                                SQLITE_TRANSIENT);
+            sqlite3_step(statement);
+            benchmark::DoNotOptimize(sqlite3_last_insert_rowid(db));
+            sqlite3_reset(statement);
+            sqlite3_clear_bindings(statement);
+        }
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+    finish(state, db, statement);
+}
+BENCHMARK(BM_SQLiteInsertPerRow)->Unit(benchmark::kMillisecond);
+
+static void BM_SQLiteInsertBatch(benchmark::State& state) {
+    const SQLiteBatch batch = rows().batch();
+    std::vector<int64_t> results(kRows);
+    sqlite3* db;
+    sqlite3_stmt* statement = prepareInsert(&db);
+    for (auto _ : state) {
+        sqlite3_exec(db, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+        size_t rowsExecuted;
+        if (executeSQLiteBatch(db, statement, batch, true, results.data(), &rowsExecuted) !=
+            SQLITE_DONE) {
+            state.SkipWithError("Failed to execute batch");
+        }
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+    finish(state, db, statement);
+}
+BENCHMARK(BM_SQLiteInsertBatch)->Unit(benchmark::kMillisecond);
+
+}  // namespace android
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <sqlite3.h>
+
+#include "../android_database_SQLitePrefetch.h"
+
+namespace android {
+
+constexpr int kRows = 1000000;
+constexpr size_t kWindowSize = 2 * 1024 * 1024;
+
+static sqlite3* database() {
+    static sqlite3* sDb = []() {
+        sqlite3* db;
+        sqlite3_open(":memory:", &db);
+        sqlite3_exec(db,
+                     "CREATE TABLE t (a INTEGER, b TEXT);"
+                     "WITH RECURSIVE n(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM n LIMIT 1000000)"
+                     "INSERT INTO t SELECT i, 'row number ' || i FROM n;",
+                     nullptr, nullptr, nullptr);
+        return db;
+    }();
+    return sDb;
+}
+
+static CursorWindow* createWindow(const char* name) {
+    CursorWindow* window;
+    CursorWindow::create(String8(name), kWindowSize, &window);
+    return window;
+}
+
+// Reads every row of window, as a cursor being scrolled through would.
+static void consume(CursorWindow* window) {
+    int64_t sum = 0;
+    for (uint32_t row = 0; row < window->getNumRows(); row++) {
+        sum += window->getFieldSlotValueLong(window->getFieldSlot(row, 0));
+    }
+    benchmark::DoNotOptimize(sum);
+}
+
+// What SQLiteCursor does today: every window re-executes the query and steps past the rows of
+// all of the windows before it.
+static void BM_SQLiteScanReexecute(benchmark::State& state) {
+    sqlite3_stmt* statement;
+    sqlite3_prepare_v2(database(), "SELECT a, b FROM t", -1, &statement, nullptr);
+    CursorWindow* window = createWindow("reexecute");
+    for (auto _ : state) {
+        int startPos = 0;
+        while (startPos < kRows) {
+            window->clear();
+            window->setNumColumns(2);
+            int totalRows = 0;
+            int addedRows = 0;
+            while (sqlite3_step(statement) == SQLITE_ROW) {
+                if (++totalRows <= startPos) {
+                    continue;
+                }
+                if (copyRow(window, statement, 2, startPos, addedRows) != CPR_OK) {
+                    break;
+                }
+                addedRows++;
+            }
+            sqlite3_reset(statement);
+            consume(window);
+            startPos += addedRows;
+        }
+    }
+    delete window;
+    sqlite3_finalize(statement);
+    state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_SQLiteScanReexecute)->Unit(benchmark::kMillisecond);
+
+// Arg(0) fills each window when it is needed, Arg(1) fills the next one while this one is read.
+// CPU time is only that of the reading thread, which is what prefetching takes work off.
+static void BM_SQLiteScanPrefetch(benchmark::State& state) {
+    const bool doubleBuffered = state.range(0);
+    sqlite3_stmt* statement;
+    sqlite3_prepare_v2(database(), "SELECT a, b FROM t", -1, &statement, nullptr);
+    CursorWindow* windows[2] = {createWindow("front"), createWindow("back")};
+    SQLitePrefetchWorker worker;
+    for (auto _ : state) {
+        SQLiteWindowPrefetcher prefetcher(database(), statement, &worker);
+        for (int i = 0;; i ^= doubleBuffered) {
+            SQLiteWindowFill fill =
+                    prefetcher.next(windows[i], doubleBuffered ? windows[i ^ 1] : nullptr);
+            if (fill.failed) {
+                state.SkipWithError(fill.sqlite3Message.c_str());
+                break;
+            }
+            if (fill.addedRows == 0) {
+                break;
+            }
+            consume(windows[i]);
+        }
+    }
+    delete windows[0];
+    delete windows[1];
+    sqlite3_finalize(statement);
+    state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_SQLiteScanPrefetch)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace android
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <input/Input.h>
+#include <input/VelocityTracker.h>
+
+#include <algorithm>
+#include <array>
+
+namespace android {
+
+constexpr int32_t kPointerCount = 10;
+constexpr nsecs_t kSamplePeriod = 1000000000LL / 480;
+constexpr std::array<int32_t, 2> kAxes = {AMOTION_EVENT_AXIS_X, AMOTION_EVENT_AXIS_Y};
+
+// Adds one 480Hz sample of ten fingers moving diagonally at different speeds.
+static void addSample(VelocityTracker& tracker, int64_t sample) {
+    const nsecs_t eventTime = sample * kSamplePeriod;
+    for (int32_t id = 0; id < kPointerCount; id++) {
+        tracker.addMovement(eventTime, id, AMOTION_EVENT_AXIS_X, sample * (id + 1));
+        tracker.addMovement(eventTime, id, AMOTION_EVENT_AXIS_Y, sample * (id + 2));
+    }
+}
+
+// What VelocityTracker.java does per frame today: compute every axis of every pointer, then
+// read each velocity it needs with one JNI call, modelled here as one lookup.
+static void BM_VelocityComputeAllThenGet(benchmark::State& state) {
+    VelocityTracker tracker;
+    int64_t sample = 0;
+    for (auto _ : state) {
+        addSample(tracker, sample++);
+        VelocityTracker::ComputedVelocity computed = tracker.getComputedVelocity(1000, 8000);
+        float sum = 0;
+        for (int32_t id = 0; id < kPointerCount; id++) {
+            for (int32_t axis : kAxes) {
+                sum += computed.getVelocity(axis, id).value_or(0);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_VelocityComputeAllThenGet);
+
+// What nativeComputeVelocities() does: fit only the requested axes, straight into one array.
+static void BM_VelocityComputeRequested(benchmark::State& state) {
+    VelocityTracker tracker;
+    int64_t sample = 0;
+    std::array<float, kPointerCount * kAxes.size()> velocities;
+    for (auto _ : state) {
+        addSample(tracker, sample++);
+        float* out = velocities.data();
+        for (int32_t id = 0; id < kPointerCount; id++) {
+            for (int32_t axis : kAxes) {
+                const std::optional<float> velocity = tracker.getVelocity(axis, id);
+                *out++ = velocity.has_value() ? std::clamp(*velocity, -8000.f, 8000.f) : 0;
+            }
+        }
+        benchmark::DoNotOptimize(velocities.data());
+    }
+}
+BENCHMARK(BM_VelocityComputeRequested);
+
+} // namespace android
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "android_os_ParcelGather.h"
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace android {
+
+TEST(ParcelGatherTest, SizesMatchWriteByteArray) {
+    EXPECT_EQ(4u, parcelByteArraySize(-1));
+    EXPECT_EQ(4u, parcelByteArraySize(0));
+    EXPECT_EQ(8u, parcelByteArraySize(1));
+    EXPECT_EQ(8u, parcelByteArraySize(4));
+    EXPECT_EQ(12u, parcelByteArraySize(5));
+}
+
+TEST(ParcelGatherTest, WritesEachRangeAsAByteArray) {
+    const uint8_t first[] = {1, 2, 3};
+    const uint8_t second[] = {4, 5, 6, 7, 8};
+    const ParcelByteRange ranges[] = {
+            {first, sizeof(first)},
+            {nullptr, -1},
+            {second, sizeof(second)},
+    };
+    Parcel parcel;
+    ASSERT_EQ(NO_ERROR, writeParcelByteRanges(&parcel, ranges, std::size(ranges)));
+    EXPECT_EQ(parcelByteArraySize(sizeof(first)) + parcelByteArraySize(-1) +
+                      parcelByteArraySize(sizeof(second)),
+              parcel.dataSize());
+
+    parcel.setDataPosition(0);
+    EXPECT_EQ(static_cast<int32_t>(sizeof(first)), parcel.readInt32());
+    EXPECT_EQ(0, memcmp(first, parcel.readInplace(sizeof(first)), sizeof(first)));
+    EXPECT_EQ(-1, parcel.readInt32());
+    EXPECT_EQ(static_cast<int32_t>(sizeof(second)), parcel.readInt32());
+    EXPECT_EQ(0, memcmp(second, parcel.readInplace(sizeof(second)), sizeof(second)));
+}
+
+// Gathering copies the ranges: the Parcel does not refer to them once written, so there is no
+// zero-copy or scatter-gather write.
+TEST(ParcelGatherTest, CopiesRanges) {
+    std::vector<uint8_t> bytes(64, 1);
+    const ParcelByteRange range = {bytes.data(), static_cast<int32_t>(bytes.size())};
+    Parcel parcel;
+    ASSERT_EQ(NO_ERROR, writeParcelByteRanges(&parcel, &range, 1));
+    std::fill(bytes.begin(), bytes.end(), 2);
+
+    parcel.setDataPosition(sizeof(int32_t));
+    const uint8_t* written = static_cast<const uint8_t*>(parcel.readInplace(bytes.size()));
+    ASSERT_NE(nullptr, written);
+    EXPECT_NE(static_cast<const void*>(bytes.data()), static_cast<const void*>(written));
+    EXPECT_TRUE(std::all_of(written, written + bytes.size(), [](uint8_t b) { return b == 1; }));
+}
+
+TEST(ParcelGatherTest, ReservesOnce) {
+    Parcel parcel;
+    ASSERT_EQ(NO_ERROR, reserveParcelCapacity(&parcel, 1000));
+    EXPECT_GE(parcel.dataCapacity(), 1000u);
+    const size_t capacity = parcel.dataCapacity();
+    ASSERT_EQ(NO_ERROR, reserveParcelCapacity(&parcel, 10));
+    EXPECT_EQ(capacity, parcel.dataCapacity());
+}
+
+} // namespace android
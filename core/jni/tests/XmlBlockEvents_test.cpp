@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "android_util_XmlBlockEvents.h"
+
+#include <androidfw/ResourceTypes.h>
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace android {
+namespace xmlblock {
+
+enum {
+    kStyle = 0,
+    kLabel,
+    kView,
+    kText,
+    kPlain,
+    kHello,
+};
+
+static const char* kStrings[] = {"style", "label", "View", "Text", "Plain", "hello"};
+
+// Builds the compiled form of a small document, one chunk at a time.
+class XmlBuilder {
+public:
+    XmlBuilder() {
+        ResXMLTree_header header = {};
+        header.header.type = RES_XML_TYPE;
+        header.header.headerSize = sizeof(header);
+        append(&header, sizeof(header));
+        addStringPool();
+    }
+
+    // Starts an element whose first attribute is its style.
+    void startElement(uint32_t name, uint8_t styleType, uint32_t styleData,
+                      bool withLabel = false) {
+        const uint16_t attributeCount = withLabel ? 2 : 1;
+        ResXMLTree_node node = {};
+        node.header.type = RES_XML_START_ELEMENT_TYPE;
+        node.header.headerSize = sizeof(node);
+        node.header.size = sizeof(node) + sizeof(ResXMLTree_attrExt) +
+                attributeCount * sizeof(ResXMLTree_attribute);
+        node.lineNumber = ++mLine;
+        node.comment.index = -1;
+        append(&node, sizeof(node));
+
+        ResXMLTree_attrExt ext = {};
+        ext.ns.index = -1;
+        ext.name.index = name;
+        ext.attributeStart = sizeof(ext);
+        ext.attributeSize = sizeof(ResXMLTree_attribute);
+        ext.attributeCount = attributeCount;
+        ext.styleIndex = 1;  // 1-based
+        append(&ext, sizeof(ext));
+
+        addAttribute(kStyle, styleType, styleData);
+        if (withLabel) {
+            addAttribute(kLabel, Res_value::TYPE_STRING, kHello);
+        }
+    }
+
+    void endElement(uint32_t name) {
+        ResXMLTree_node node = {};
+        node.header.type = RES_XML_END_ELEMENT_TYPE;
+        node.header.headerSize = sizeof(node);
+        node.header.size = sizeof(node) + sizeof(ResXMLTree_endElementExt);
+        node.lineNumber = ++mLine;
+        node.comment.index = -1;
+        append(&node, sizeof(node));
+
+        ResXMLTree_endElementExt ext = {};
+        ext.ns.index = -1;
+        ext.name.index = name;
+        append(&ext, sizeof(ext));
+    }
+
+    std::vector<uint8_t> finish() {
+        reinterpret_cast<ResXMLTree_header*>(mData.data())->header.size = mData.size();
+        return mData;
+    }
+
+private:
+    void append(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        mData.insert(mData.end(), bytes, bytes + size);
+    }
+
+    void addStringPool() {
+        const size_t count = sizeof(kStrings) / sizeof(kStrings[0]);
+        std::vector<uint32_t> offsets;
+        std::string strings;
+        for (const char* str : kStrings) {
+            offsets.push_back(strings.size());
+            strings += static_cast<char>(strlen(str));  // UTF-16 length
+            strings += static_cast<char>(strlen(str));  // UTF-8 length
+            strings += str;
+            strings += '\0';
+        }
+        strings.resize((strings.size() + 3) & ~3);
+
+        ResStringPool_header pool = {};
+        pool.header.type = RES_STRING_POOL_TYPE;
+        pool.header.headerSize = sizeof(pool);
+        pool.header.size = sizeof(pool) + count * sizeof(uint32_t) + strings.size();
+        pool.stringCount = count;
+        pool.flags = ResStringPool_header::UTF8_FLAG;
+        pool.stringsStart = sizeof(pool) + count * sizeof(uint32_t);
+        append(&pool, sizeof(pool));
+        append(offsets.data(), offsets.size() * sizeof(uint32_t));
+        append(strings.data(), strings.size());
+    }
+
+    void addAttribute(uint32_t name, uint8_t type, uint32_t data) {
+        ResXMLTree_attribute attr = {};
+        attr.ns.index = -1;
+        attr.name.index = name;
+        attr.rawValue.index = type == Res_value::TYPE_STRING ? data : -1;
+        attr.typedValue.size = sizeof(Res_value);
+        attr.typedValue.dataType = type;
+        attr.typedValue.data = data;
+        append(&attr, sizeof(attr));
+    }
+
+    std::vector<uint8_t> mData;
+    uint32_t mLine = 0;
+};
+
+class XmlBlockEventsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // <View style="@0x7f030001" label="hello">
+        //     <Text style="?0x7f010002"/>
+        //     <Plain style="hello"/>
+        // </View>
+        XmlBuilder builder;
+        builder.startElement(kView, Res_value::TYPE_REFERENCE, 0x7f030001, true);
+        builder.startElement(kText, Res_value::TYPE_ATTRIBUTE, 0x7f010002);
+        builder.endElement(kText);
+        builder.startElement(kPlain, Res_value::TYPE_STRING, kHello);
+        builder.endElement(kPlain);
+        builder.endElement(kView);
+        mData = builder.finish();
+
+        ASSERT_EQ(NO_ERROR, mTree.setTo(mData.data(), mData.size(), true));
+    }
+
+    std::vector<uint8_t> mData;
+    ResXMLTree mTree;
+};
+
+static const int32_t kExpectedStyles[] = {0x7f030001, 0x7f010002, 0};
+
+TEST_F(XmlBlockEventsTest, StyleAttributeOfEachTag) {
+    ResXMLParser parser(mTree);
+    parser.restart();
+
+    std::vector<int32_t> styles;
+    for (int32_t event = nextEvent(&parser); event != 1; event = nextEvent(&parser)) {
+        ASSERT_NE(kBadDocument, event);
+        if (event == 2) {
+            styles.push_back(styleAttribute(&parser));
+        }
+    }
+    EXPECT_EQ(std::vector<int32_t>(std::begin(kExpectedStyles), std::end(kExpectedStyles)),
+              styles);
+}
+
+TEST_F(XmlBlockEventsTest, WriteEventCarriesStyleAttribute) {
+    ResXMLParser parser(mTree);
+    parser.restart();
+
+    // Only room for the header, as when nativeNextBulk is given a short array.
+    int32_t out[kEventHeaderSize];
+    std::vector<int32_t> styles;
+    for (int32_t event = nextEvent(&parser); event != 1; event = nextEvent(&parser)) {
+        ASSERT_NE(kBadDocument, event);
+        EXPECT_EQ(0u, writeEvent(&parser, event, out, kEventHeaderSize));
+        if (event == 2) {
+            styles.push_back(out[kEventStyleAttribute]);
+            EXPECT_EQ(styleAttribute(&parser), out[kEventStyleAttribute]);
+        }
+    }
+    EXPECT_EQ(std::vector<int32_t>(std::begin(kExpectedStyles), std::end(kExpectedStyles)),
+              styles);
+}
+
+TEST_F(XmlBlockEventsTest, DecodeDocumentCarriesStyleAttribute) {
+    ResXMLParser parser(mTree);
+    parser.restart();
+
+    std::vector<int32_t> events = decodeDocument(&parser);
+    std::vector<int32_t> styles;
+    size_t i = 0;
+    while (i < events.size()) {
+        const int32_t* event = events.data() + i;
+        if (event[kEventCode] == 2) {
+            styles.push_back(event[kEventStyleAttribute]);
+        }
+        i += kEventHeaderSize + event[kEventAttributeCount] * kAttributeStride;
+        if (event[kEventCode] == 1) {
+            break;
+        }
+    }
+    EXPECT_EQ(events.size(), i);
+    EXPECT_EQ(std::vector<int32_t>(std::begin(kExpectedStyles), std::end(kExpectedStyles)),
+              styles);
+
+    // The parser is left where it was, before the first tag.
+    ASSERT_EQ(2, nextEvent(&parser));
+    EXPECT_EQ(kExpectedStyles[0], styleAttribute(&parser));
+}
+
+} // namespace xmlblock
+} // namespace android
@@ -317,13 +317,13 @@ Asset::Asset(void)
 /*
  * Create a new Asset from compressed data in a memory mapping.
  */
-/*static*/ std::unique_ptr<Asset> Asset::createFromCompressedMap(incfs::IncFsFileMap&& dataMap,
-                                                                 size_t uncompressedLen,
-                                                                 AccessMode mode)
+/*static*/ std::unique_ptr<Asset> Asset::createFromCompressedMap(
+        incfs::IncFsFileMap&& dataMap, size_t uncompressedLen, AccessMode mode,
+        std::shared_ptr<InflateSeekIndex> seekIndex)
 {
   auto pAsset = util::make_unique<_CompressedAsset>();
 
-  status_t result = pAsset->openChunk(std::move(dataMap), uncompressedLen);
+  status_t result = pAsset->openChunk(std::move(dataMap), uncompressedLen, std::move(seekIndex));
   if (result != NO_ERROR) {
       return NULL;
   }
@@ -796,7 +796,8 @@ status_t _CompressedAsset::openChunk(int fd, off64_t offset,
  *
  * Nothing is expanded until the first read call.
  */
-status_t _CompressedAsset::openChunk(incfs::IncFsFileMap&& dataMap, size_t uncompressedLen)
+status_t _CompressedAsset::openChunk(incfs::IncFsFileMap&& dataMap, size_t uncompressedLen,
+    std::shared_ptr<InflateSeekIndex> seekIndex)
 {
     assert(mFd < 0);        // no re-open
     assert(!mMap.has_value());
@@ -810,6 +811,9 @@ status_t _CompressedAsset::openChunk(incfs::IncFsFileMap&& dataMap, size_t uncom
 
     if (uncompressedLen > StreamingZipInflater::OUTPUT_CHUNK_SIZE) {
         mZipInflater = new StreamingZipInflater(&(*mMap), uncompressedLen);
+        if (seekIndex != nullptr) {
+            mZipInflater->setSeekIndex(std::move(seekIndex));
+        }
     }
     return NO_ERROR;
 }
@@ -113,6 +113,7 @@ bool AssetManager2::SetApkAssets(ApkAssetsList apk_assets, bool invalidate_cache
   RebuildFilterList();
   if (invalidate_caches) {
     InvalidateCaches(static_cast<uint32_t>(-1));
+    apk_assets_generation_++;
   }
   return true;
 }
@@ -630,7 +631,9 @@ base::expected<FindEntryResult, NullOrIOError> AssetManager2::FindEntry(
     uint32_t resid, uint16_t density_override, bool stop_at_first_match,
     bool ignore_configuration) const {
   const bool logging_enabled = resource_resolution_logging_enabled_;
+  std::unique_lock resolution_lock(resolution_lock_, std::defer_lock);
   if (UNLIKELY(logging_enabled)) {
+    resolution_lock.lock();
     // Clear the last logged resource resolution.
     ResetResourceResolution();
     last_resolution_.resid = resid;
@@ -965,6 +968,7 @@ std::string AssetManager2::GetLastResourceResolution() const {
     return {};
   }
 
+  std::lock_guard resolution_lock(resolution_lock_);
   const ApkAssetsCookie cookie = last_resolution_.cookie;
   if (cookie == kInvalidCookie) {
     LOG(ERROR) << "AssetManager hasn't resolved a resource to read resolution path.";
@@ -1116,6 +1120,7 @@ base::expected<std::monostate, NullOrIOError> AssetManager2::ResolveReference(
   const uint32_t original_flags = value.flags;
   const uint32_t original_resid = value.data;
   if (cache_value) {
+    std::lock_guard lock(cache_lock_);
     auto cached_value = cached_resolved_values_.find(value.data);
     if (cached_value != cached_resolved_values_.end()) {
       value = cached_value->second;
@@ -1144,6 +1149,7 @@ base::expected<std::monostate, NullOrIOError> AssetManager2::ResolveReference(
         result->data == resolve_resid || i == kMaxIterations) {
       // This reference can't be resolved, so exit now and let the caller deal with it.
       if (cache_value) {
+        std::lock_guard lock(cache_lock_);
         cached_resolved_values_[original_resid] = value;
       }
 
@@ -1160,16 +1166,20 @@ base::expected<std::monostate, NullOrIOError> AssetManager2::ResolveReference(
 
 base::expected<const std::vector<uint32_t>*, NullOrIOError> AssetManager2::GetBagResIdStack(
     uint32_t resid) const {
-  auto it = cached_bag_resid_stacks_.find(resid);
-  if (it != cached_bag_resid_stacks_.end()) {
-    return &it->second;
+  {
+    std::lock_guard lock(cache_lock_);
+    auto it = cached_bag_resid_stacks_.find(resid);
+    if (it != cached_bag_resid_stacks_.end()) {
+      return &it->second;
+    }
   }
   std::vector<uint32_t> stacks;
   if (auto maybe_bag = GetBag(resid, stacks); UNLIKELY(IsIOError(maybe_bag))) {
     return base::unexpected(maybe_bag.error());
   }
 
-  it = cached_bag_resid_stacks_.emplace(resid, std::move(stacks)).first;
+  std::lock_guard lock(cache_lock_);
+  auto it = cached_bag_resid_stacks_.emplace(resid, std::move(stacks)).first;
   return &it->second;
 }
 
@@ -1187,22 +1197,32 @@ base::expected<const ResolvedBag*, NullOrIOError> AssetManager2::ResolveBag(
 }
 
 base::expected<const ResolvedBag*, NullOrIOError> AssetManager2::GetBag(uint32_t resid) const {
-  auto resid_stacks_it = cached_bag_resid_stacks_.find(resid);
-  if (resid_stacks_it == cached_bag_resid_stacks_.end()) {
-    resid_stacks_it = cached_bag_resid_stacks_.emplace(resid, std::vector<uint32_t>{}).first;
+  {
+    std::lock_guard lock(cache_lock_);
+    if (cached_bag_resid_stacks_.find(resid) != cached_bag_resid_stacks_.end()) {
+      if (auto cached_iter = cached_bags_.find(resid); cached_iter != cached_bags_.end()) {
+        return cached_iter->second.get();
+      }
+    }
   }
-  const auto bag = GetBag(resid, resid_stacks_it->second);
+  // Collect the stack separately so that threads resolving the same bag do not share it.
+  std::vector<uint32_t> child_resids;
+  const auto bag = GetBag(resid, child_resids);
   if (UNLIKELY(IsIOError(bag))) {
-    cached_bag_resid_stacks_.erase(resid_stacks_it);
     return base::unexpected(bag.error());
   }
+  std::lock_guard lock(cache_lock_);
+  cached_bag_resid_stacks_.try_emplace(resid, std::move(child_resids));
   return bag;
 }
 
 base::expected<const ResolvedBag*, NullOrIOError> AssetManager2::GetBag(
     uint32_t resid, std::vector<uint32_t>& child_resids) const {
-  if (auto cached_iter = cached_bags_.find(resid); cached_iter != cached_bags_.end()) {
-    return cached_iter->second.get();
+  {
+    std::lock_guard lock(cache_lock_);
+    if (auto cached_iter = cached_bags_.find(resid); cached_iter != cached_bags_.end()) {
+      return cached_iter->second.get();
+    }
   }
 
   auto entry = FindEntry(resid, 0u /* density_override */, false /* stop_at_first_match */,
@@ -1277,9 +1297,7 @@ base::expected<const ResolvedBag*, NullOrIOError> AssetManager2::GetBag(
 
     new_bag->type_spec_flags = entry->type_flags;
     new_bag->entry_count = static_cast<uint32_t>(entry_count);
-    ResolvedBag* result = new_bag.get();
-    cached_bags_[resid] = std::move(new_bag);
-    return result;
+    return CacheBag(resid, std::move(new_bag));
   }
 
   // In case the parent is a dynamic reference, resolve it.
@@ -1407,9 +1425,14 @@ base::expected<const ResolvedBag*, NullOrIOError> AssetManager2::GetBag(
   // Combine flags from the parent and our own bag.
   new_bag->type_spec_flags = entry->type_flags | (*parent_bag)->type_spec_flags;
   new_bag->entry_count = static_cast<uint32_t>(actual_count);
-  ResolvedBag* result = new_bag.get();
-  cached_bags_[resid] = std::move(new_bag);
-  return result;
+  return CacheBag(resid, std::move(new_bag));
+}
+
+const ResolvedBag* AssetManager2::CacheBag(uint32_t resid,
+                                           util::unique_cptr<ResolvedBag> bag) const {
+  std::lock_guard lock(cache_lock_);
+  // If another thread built the same bag first, keep the bag it may already be using.
+  return cached_bags_.try_emplace(resid, std::move(bag)).first->second.get();
 }
 
 static bool Utf8ToUtf16(StringPiece str, std::u16string* out) {
@@ -1579,18 +1602,24 @@ void AssetManager2::ForEachPackage(base::function_ref<bool(const std::string&, u
 }
 
 AssetManager2::ScopedOperation AssetManager2::StartOperation() const {
-  ++number_of_running_scoped_operations_;
+  number_of_running_scoped_operations_.fetch_add(1, std::memory_order_relaxed);
   return ScopedOperation(*this);
 }
 
 void AssetManager2::FinishOperation() const {
-  if (number_of_running_scoped_operations_ < 1) {
+  const int running = number_of_running_scoped_operations_.fetch_sub(1, std::memory_order_acq_rel);
+  if (running < 1) {
+    number_of_running_scoped_operations_.fetch_add(1, std::memory_order_relaxed);
     ALOGW("Invalid FinishOperation() call when there's none happening");
     return;
   }
-  if (--number_of_running_scoped_operations_ == 0) {
-    for (auto&& [_, assets] : apk_assets_) {
-      assets.clear();
+  if (running == 1) {
+    std::lock_guard lock(apk_assets_lock_);
+    // Another thread may have started an operation and promoted assets in the meantime.
+    if (number_of_running_scoped_operations_.load(std::memory_order_acquire) == 0) {
+      for (auto&& [_, assets] : apk_assets_) {
+        assets.clear();
+      }
     }
   }
 }
@@ -1602,6 +1631,9 @@ const AssetManager2::ApkAssetsPtr& AssetManager2::GetApkAssets(ApkAssetsCookie c
     static const ApkAssetsPtr empty{};
     return empty;
   }
+  // The promoted pointer is only written here and cleared once no operation is running, so the
+  // returned reference stays valid for the rest of the caller's operation.
+  std::lock_guard lock(apk_assets_lock_);
   auto& [wptr, res] = apk_assets_[cookie];
   if (!res) {
     res = wptr.promote();
@@ -1616,6 +1648,7 @@ Theme::~Theme() = default;
 
 base::expected<std::monostate, NullOrIOError> Theme::ApplyStyle(uint32_t resid, bool force) {
   ATRACE_NAME("Theme::ApplyStyle");
+  layout_cache_.Clear();
 
   auto bag = asset_manager_->GetBag(resid);
   if (!bag.has_value()) {
@@ -1668,6 +1701,7 @@ void Theme::Rebase(AssetManager2* am, const uint32_t* style_ids, const uint8_t*
   // ApplyStyle.
   keys_.clear();
   entries_.clear();
+  layout_cache_.Clear();
   asset_manager_ = am;
   for (size_t i = 0; i < style_count; i++) {
     ApplyStyle(style_ids[i], force[i]);
@@ -1718,6 +1752,7 @@ base::expected<std::monostate, NullOrIOError> Theme::ResolveAttributeReference(
 void Theme::Clear() {
   keys_.clear();
   entries_.clear();
+  layout_cache_.Clear();
 }
 
 base::expected<std::monostate, IOError> Theme::SetTo(const Theme& source) {
@@ -1726,6 +1761,7 @@ base::expected<std::monostate, IOError> Theme::SetTo(const Theme& source) {
   }
 
   type_spec_flags_ = source.type_spec_flags_;
+  layout_cache_.Clear();
 
   if (asset_manager_ == source.asset_manager_) {
     keys_ = source.keys_;
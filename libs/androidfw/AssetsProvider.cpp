@@ -21,11 +21,16 @@
 #include <android-base/errors.h>
 #include <android-base/stringprintf.h>
 #include <android-base/utf8.h>
+#include <androidfw/StreamingZipInflater.h>
 #include <ziparchive/zip_archive.h>
 
 namespace android {
 namespace {
 constexpr const char* kEmptyDebugString = "<empty>";
+
+// Smaller entries are quick enough to inflate again from the start, and would take a
+// checkpoint's memory for little of their length.
+constexpr uint32_t kMinSeekIndexLength = 4 * InflateSeekIndex::SPACING;
 } // namespace
 
 std::unique_ptr<Asset> AssetsProvider::Open(const std::string& path, Asset::AccessMode mode,
@@ -181,8 +186,18 @@ std::unique_ptr<Asset> ZipAssetsProvider::OpenInternal(const std::string& path,
         return {};
       }
 
-      std::unique_ptr<Asset> asset =
-          Asset::createFromCompressedMap(std::move(asset_map), entry.uncompressed_length, mode);
+      std::shared_ptr<InflateSeekIndex> seek_index;
+      if (mode != Asset::ACCESS_STREAMING && entry.uncompressed_length >= kMinSeekIndexLength) {
+        std::lock_guard lock(seek_indices_lock_);
+        auto& index = seek_indices_[path];
+        if (index == nullptr) {
+          index = std::make_shared<InflateSeekIndex>();
+        }
+        seek_index = index;
+      }
+
+      std::unique_ptr<Asset> asset = Asset::createFromCompressedMap(
+          std::move(asset_map), entry.uncompressed_length, mode, std::move(seek_index));
       if (asset == nullptr) {
         LOG(ERROR) << "Failed to decompress '" << path << "' in APK '" << name_.GetDebugName()
                    << "'";
@@ -217,11 +217,16 @@ base::expected<std::monostate, IOError> ResolveAttrs(Theme* theme, uint32_t def_
   return {};
 }
 
-base::expected<std::monostate, IOError> ApplyStyle(Theme* theme, ResXMLParser* xml_parser,
-                                                   uint32_t def_style_attr,
-                                                   uint32_t def_style_resid,
-                                                   const uint32_t* attrs, size_t attrs_length,
-                                                   uint32_t* out_values, uint32_t* out_indices) {
+// Does the work of ApplyStyle(), and also reports in `out_changing_configurations` the
+// configuration changes that the theme, the styles and the resolved values depend on.
+static base::expected<std::monostate, IOError> ApplyStyle(Theme* theme, ResXMLParser* xml_parser,
+                                                          uint32_t def_style_attr,
+                                                          uint32_t def_style_resid,
+                                                          const uint32_t* attrs,
+                                                          size_t attrs_length,
+                                                          uint32_t* out_values,
+                                                          uint32_t* out_indices,
+                                                          uint32_t* out_changing_configurations) {
   DEBUG_LOG("APPLY STYLE: theme=0x%p defStyleAttr=0x%x defStyleRes=0x%x xml=0x%p", theme,
             def_style_attr, def_style_resid, xml_parser);
 
@@ -247,6 +252,17 @@ base::expected<std::monostate, IOError> ApplyStyle(Theme* theme, ResXMLParser* x
   BagAttributeFinder xml_style_attr_finder(xml_style_bag.value_or(nullptr));
   XmlAttributeFinder xml_attr_finder(xml_parser);
 
+  // Whether a style has a value for an attribute can depend on the configuration too, even when
+  // the value it has is not used.
+  uint32_t changing_configurations = theme->GetChangingConfigurations() |
+                                     def_style_theme_flags | xml_style_theme_flags;
+  if (default_style_bag.has_value() && *default_style_bag != nullptr) {
+    changing_configurations |= (*default_style_bag)->type_spec_flags;
+  }
+  if (xml_style_bag.has_value() && *xml_style_bag != nullptr) {
+    changing_configurations |= (*xml_style_bag)->type_spec_flags;
+  }
+
   // Now iterate through all of the attributes that the client has requested,
   // filling in each with whatever data we can find.
   for (size_t ii = 0; ii < attrs_length; ii++) {
@@ -336,6 +352,7 @@ base::expected<std::monostate, IOError> ApplyStyle(Theme* theme, ResXMLParser* x
     out_values[STYLE_CHANGING_CONFIGURATIONS] = value.flags;
     out_values[STYLE_DENSITY] = value.config.density;
     out_values[STYLE_SOURCE_RESOURCE_ID] = value_source_resid;
+    changing_configurations |= value.flags;
 
     if (value.type != Res_value::TYPE_NULL || value.data == Res_value::DATA_NULL_EMPTY) {
       // out_indices must NOT be nullptr.
@@ -346,10 +363,47 @@ base::expected<std::monostate, IOError> ApplyStyle(Theme* theme, ResXMLParser* x
 
   // out_indices must NOT be nullptr.
   out_indices[0] = indices_idx;
+  *out_changing_configurations = changing_configurations;
   return {};
 }
 
-base::expected<std::monostate, IOError> RetrieveAttributes(AssetManager2* assetmanager,
+base::expected<std::monostate, IOError> ApplyStyle(Theme* theme, ResXMLParser* xml_parser,
+                                                   uint32_t def_style_attr,
+                                                   uint32_t def_style_resid,
+                                                   const uint32_t* attrs, size_t attrs_length,
+                                                   uint32_t* out_values, uint32_t* out_indices) {
+  uint32_t changing_configurations;
+  return ApplyStyle(theme, xml_parser, def_style_attr, def_style_resid, attrs, attrs_length,
+                    out_values, out_indices, &changing_configurations);
+}
+
+base::expected<std::monostate, IOError> ApplyStyleCached(Theme* theme, ResXMLParser* xml_parser,
+                                                         uint32_t def_style_attr,
+                                                         uint32_t def_style_resid,
+                                                         const uint32_t* attrs,
+                                                         size_t attrs_length,
+                                                         uint32_t* out_values,
+                                                         uint32_t* out_indices) {
+  ResolvedLayoutCache& cache = theme->GetResolvedLayoutCache();
+  const AssetManager2& assetmanager = *theme->GetAssetManager();
+
+  ResolvedLayoutCache::Key key;
+  ResolvedLayoutCache::MakeKey(xml_parser, def_style_attr, def_style_resid, attrs, attrs_length,
+                               &key);
+  if (cache.Find(assetmanager, key, out_values, out_indices)) {
+    return {};
+  }
+
+  uint32_t changing_configurations;
+  auto result = ApplyStyle(theme, xml_parser, def_style_attr, def_style_resid, attrs,
+                           attrs_length, out_values, out_indices, &changing_configurations);
+  if (result.has_value()) {
+    cache.Insert(assetmanager, std::move(key), out_values, out_indices, changing_configurations);
+  }
+  return result;
+}
+
+base::expected<std::monostate, IOError> RetrieveAttributes(const AssetManager2* assetmanager,
                                                            ResXMLParser* xml_parser,
                                                            uint32_t* attrs,
                                                            size_t attrs_length,
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "androidfw/ResolvedLayoutCache.h"
+
+#include <algorithm>
+
+#include "androidfw/AssetManager2.h"
+#include "androidfw/AttributeResolution.h"
+#include "utils/JenkinsHash.h"
+
+namespace android {
+
+// A full entry for a framework View takes a few kilobytes, so this bounds a theme's cache to
+// well under a megabyte while still covering the elements of the layouts a screen inflates.
+constexpr size_t kMaxEntries = 256;
+
+void ResolvedLayoutCache::MakeKey(const ResXMLParser* xml_parser, uint32_t def_style_attr,
+                                  uint32_t def_style_resid, const uint32_t* attrs,
+                                  size_t attrs_length, Key* out_key) {
+  out_key->clear();
+  out_key->push_back(def_style_attr);
+  out_key->push_back(def_style_resid);
+  out_key->push_back(static_cast<uint32_t>(attrs_length));
+  out_key->insert(out_key->end(), attrs, attrs + attrs_length);
+  if (xml_parser == nullptr) {
+    return;
+  }
+
+  // The layout is part of the values, as the source of attributes set in XML.
+  out_key->push_back(xml_parser->getSourceResourceId());
+  out_key->push_back(static_cast<uint32_t>(xml_parser->indexOfStyle()));
+  const size_t xml_attr_count = xml_parser->getAttributeCount();
+  for (size_t i = 0; i < xml_attr_count; i++) {
+    Res_value value{};
+    xml_parser->getAttributeValue(i, &value);
+    out_key->push_back(xml_parser->getAttributeNameResID(i));
+    out_key->push_back(value.dataType);
+    out_key->push_back(value.data);
+  }
+}
+
+size_t ResolvedLayoutCache::KeyHash::operator()(const Key& key) const {
+  uint32_t hash = 0u;
+  for (uint32_t word : key) {
+    hash = JenkinsHashMix(hash, word);
+  }
+  return JenkinsHashWhiten(hash);
+}
+
+bool ResolvedLayoutCache::Find(const AssetManager2& asset_manager, const Key& key,
+                               uint32_t* out_values, uint32_t* out_indices) {
+  std::lock_guard lock(lock_);
+  ValidateLocked(asset_manager);
+  const auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  std::copy(it->second.values.begin(), it->second.values.end(), out_values);
+  std::copy(it->second.indices.begin(), it->second.indices.end(), out_indices);
+  return true;
+}
+
+void ResolvedLayoutCache::Insert(const AssetManager2& asset_manager, Key key,
+                                 const uint32_t* values, const uint32_t* indices,
+                                 uint32_t changing_configurations) {
+  // The number of requested attributes follows the default style in the key.
+  const size_t attrs_length = key[2];
+
+  std::lock_guard lock(lock_);
+  ValidateLocked(asset_manager);
+  if (entries_.size() >= kMaxEntries) {
+    entries_.clear();
+  }
+  changing_configurations_ |= changing_configurations;
+  Entry& entry = entries_[std::move(key)];
+  entry.values.assign(values, values + attrs_length * STYLE_NUM_ENTRIES);
+  entry.indices.assign(indices, indices + indices[0] + 1);
+}
+
+void ResolvedLayoutCache::Clear() {
+  std::lock_guard lock(lock_);
+  entries_.clear();
+  changing_configurations_ = 0u;
+}
+
+size_t ResolvedLayoutCache::size() const {
+  std::lock_guard lock(lock_);
+  return entries_.size();
+}
+
+void ResolvedLayoutCache::ValidateLocked(const AssetManager2& asset_manager) {
+  if (apk_assets_generation_ != asset_manager.GetApkAssetsGeneration()) {
+    apk_assets_generation_ = asset_manager.GetApkAssetsGeneration();
+    entries_.clear();
+    changing_configurations_ = 0u;
+  }
+
+  const std::vector<ResTable_config>& configurations = asset_manager.GetConfigurations();
+  uint32_t diff = 0u;
+  if (configurations_.size() != configurations.size()) {
+    diff = 0xffffffffu;
+  } else {
+    for (size_t i = 0; i < configurations.size(); i++) {
+      diff |= configurations_[i].diff(configurations[i]);
+    }
+  }
+  if (diff == 0u) {
+    return;
+  }
+  if ((diff & changing_configurations_) != 0u) {
+    entries_.clear();
+    changing_configurations_ = 0u;
+  }
+  configurations_ = configurations;
+}
+
+}  // namespace android
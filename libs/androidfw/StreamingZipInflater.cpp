@@ -26,6 +26,8 @@
 #include <unistd.h>
 #include <errno.h>
 
+#include <algorithm>
+
 /*
  * TEMP_FAILURE_RETRY is defined by some, but not all, versions of
  * <unistd.h>. (Alas, it is not as standard as we'd hoped!) So, if it's
@@ -47,6 +49,14 @@ static inline size_t min_of(size_t a, size_t b) { return (a < b) ? a : b; }
 
 using namespace android;
 
+// the most that inflate() can refer back to, and so the size of a checkpoint's window
+static const size_t WINDOW_SIZE = 1 << MAX_WBITS;
+
+size_t InflateSeekIndex::size() const {
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCheckpoints.size();
+}
+
 /*
  * Streaming access to compressed asset data in an open fd
  */
@@ -110,6 +120,7 @@ void StreamingZipInflater::initInflateState() {
     mOutLastDecoded = mOutDeliverable = mOutCurPosition = 0;
     mInNextChunkOffset = 0;
     mStreamNeedsInit = true;
+    mNextCheckpoint = InflateSeekIndex::SPACING;
 
     if (mDataMap == NULL) {
         ::lseek(mFd, mInFileStart, SEEK_SET);
@@ -181,7 +192,9 @@ ssize_t StreamingZipInflater::read(void* outBuf, size_t count) {
                 result = inflateInit2(&mInflateState, -MAX_WBITS);
                 mStreamNeedsInit = false;
             }
-            if (result == Z_OK) result = ::inflate(&mInflateState, Z_SYNC_FLUSH);
+            // with a seek index, stop at block boundaries, where checkpoints can be taken
+            const int flush = (mSeekIndex != NULL) ? Z_BLOCK : Z_SYNC_FLUSH;
+            if (result == Z_OK) result = ::inflate(&mInflateState, flush);
             if (result < 0) {
                 // Whoops, inflation failed
                 ALOGE("Error inflating asset: %d", result);
@@ -198,6 +211,13 @@ ssize_t StreamingZipInflater::read(void* outBuf, size_t count) {
                 // Note how much data we got, and off we go
                 mOutDeliverable = 0;
                 mOutLastDecoded = mOutBufSize - mInflateState.avail_out;
+
+                // bit 128 is set at the end of a block, bit 64 while in the last one
+                if (mSeekIndex != NULL && result != Z_STREAM_END
+                        && (mInflateState.data_type & 192) == 128
+                        && mOutCurPosition + off64_t(mOutLastDecoded) >= mNextCheckpoint) {
+                    addCheckpoint();
+                }
             }
         }
     }
@@ -227,11 +247,14 @@ int StreamingZipInflater::readNextChunk() {
     return 0;
 }
 
-// seeking backwards requires uncompressing fom the beginning, so is very
-// expensive.  seeking forwards only requires uncompressing from the current
-// position to the destination.
+// seeking backwards requires uncompressing from the beginning, or from the closest
+// checkpoint before the destination if there is a seek index, so is expensive.
+// seeking forwards only requires uncompressing from the current position, or from
+// a closer checkpoint, to the destination.
 off64_t StreamingZipInflater::seekAbsolute(off64_t absoluteInputPosition) {
-    if (absoluteInputPosition < mOutCurPosition) {
+    if (mSeekIndex != NULL && resumeFromCheckpoint(absoluteInputPosition)) {
+        read(NULL, absoluteInputPosition - mOutCurPosition);
+    } else if (absoluteInputPosition < mOutCurPosition) {
         // rewind and reprocess the data from the beginning
         if (!mStreamNeedsInit) {
             ::inflateEnd(&mInflateState);
@@ -244,3 +267,103 @@ off64_t StreamingZipInflater::seekAbsolute(off64_t absoluteInputPosition) {
     // else if the target position *is* our current position, do nothing
     return absoluteInputPosition;
 }
+
+void StreamingZipInflater::setSeekIndex(std::shared_ptr<InflateSeekIndex> index) {
+    mSeekIndex = std::move(index);
+}
+
+// offset from start of blob of the next byte of input that zlib has not consumed
+size_t StreamingZipInflater::inputConsumed() const {
+    if (mDataMap == NULL) {
+        return mInNextChunkOffset - mInflateState.avail_in;
+    }
+    return mInflateState.next_in - mInBuf;
+}
+
+/*
+ * Called when inflate() has stopped at a block boundary past mNextCheckpoint, with
+ * mOutBuf holding the output up to that boundary.
+ */
+void StreamingZipInflater::addCheckpoint() {
+    InflateSeekIndex::Checkpoint checkpoint;
+    checkpoint.outOffset = mOutCurPosition + mOutLastDecoded;
+    checkpoint.inOffset = inputConsumed();
+    checkpoint.bits = mInflateState.data_type & 7;
+    checkpoint.lastByte = 0;
+    if (checkpoint.bits != 0) {
+        if (mInflateState.next_in == mInBuf) {
+            // the partly inflated byte was at the end of the previous chunk, and is gone
+            return;
+        }
+        checkpoint.lastByte = mInflateState.next_in[-1];
+    }
+
+    std::lock_guard<std::mutex> lock(mSeekIndex->mLock);
+    std::vector<InflateSeekIndex::Checkpoint>& checkpoints = mSeekIndex->mCheckpoints;
+    // another inflater for the same asset may have got here first
+    const off64_t lastOffset = checkpoints.empty() ? 0 : checkpoints.back().outOffset;
+    if (checkpoint.outOffset >= lastOffset + off64_t(InflateSeekIndex::SPACING)) {
+        uInt windowSize = WINDOW_SIZE;
+        checkpoint.window.resize(windowSize);
+        if (inflateGetDictionary(&mInflateState, checkpoint.window.data(), &windowSize) != Z_OK) {
+            return;
+        }
+        checkpoint.window.resize(windowSize);
+        ALOGV("Adding checkpoint %zu at %08" PRIx64, checkpoints.size(),
+                (uint64_t) checkpoint.outOffset);
+        checkpoints.push_back(std::move(checkpoint));
+    }
+    if (!checkpoints.empty()) {
+        mNextCheckpoint = checkpoints.back().outOffset + InflateSeekIndex::SPACING;
+    }
+}
+
+/*
+ * Restarts inflation at the closest checkpoint before the destination, unless reading
+ * on from the current position gets there sooner.  Returns whether it did.
+ */
+bool StreamingZipInflater::resumeFromCheckpoint(off64_t absoluteInputPosition) {
+    std::lock_guard<std::mutex> lock(mSeekIndex->mLock);
+    const std::vector<InflateSeekIndex::Checkpoint>& checkpoints = mSeekIndex->mCheckpoints;
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), absoluteInputPosition,
+            [](off64_t position, const InflateSeekIndex::Checkpoint& checkpoint) {
+                return position < checkpoint.outOffset;
+            });
+    if (it == checkpoints.begin()) {
+        return false;
+    }
+    const InflateSeekIndex::Checkpoint& checkpoint = *(it - 1);
+    if (absoluteInputPosition >= mOutCurPosition && checkpoint.outOffset <= mOutCurPosition) {
+        return false;
+    }
+
+    ALOGV("Resuming from checkpoint at %08" PRIx64, (uint64_t) checkpoint.outOffset);
+    if (!mStreamNeedsInit) {
+        ::inflateEnd(&mInflateState);
+    }
+    initInflateState();
+    if (inflateInit2(&mInflateState, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    mStreamNeedsInit = false;
+    if ((checkpoint.bits != 0
+                && inflatePrime(&mInflateState, checkpoint.bits,
+                        checkpoint.lastByte >> (8 - checkpoint.bits)) != Z_OK)
+            || inflateSetDictionary(&mInflateState, checkpoint.window.data(),
+                    checkpoint.window.size()) != Z_OK) {
+        ::inflateEnd(&mInflateState);
+        initInflateState();
+        return false;
+    }
+
+    if (mDataMap == NULL) {
+        ::lseek(mFd, mInFileStart + checkpoint.inOffset, SEEK_SET);
+        mInNextChunkOffset = checkpoint.inOffset;
+    } else {
+        mInflateState.next_in = (Bytef*) mInBuf + checkpoint.inOffset;
+        mInflateState.avail_in = mInBufSize - checkpoint.inOffset;
+    }
+    mOutCurPosition = checkpoint.outOffset;
+    mNextCheckpoint = checkpoint.outOffset + InflateSeekIndex::SPACING;
+    return true;
+}
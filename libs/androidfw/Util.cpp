@@ -17,6 +17,7 @@
 #include "androidfw/Util.h"
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "utils/ByteOrder.h"
@@ -207,6 +208,194 @@ StringPiece16 GetString16(const android::ResStringPool& pool, size_t idx) {
   return StringPiece16();
 }
 
+namespace {
+
+constexpr uint64_t kLowBits8 = 0x0101010101010101ull;
+constexpr uint64_t kHighBits8 = 0x8080808080808080ull;
+constexpr uint64_t kLowBits16 = 0x0001000100010001ull;
+constexpr uint64_t kHighBits16 = 0x8000800080008000ull;
+constexpr uint64_t kNonAsciiBits16 = 0xff80ff80ff80ff80ull;
+
+inline uint64_t Load64(const void* p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+// Whether any byte of word is 0 or has its top bit set.
+inline bool HasNonAscii8(uint64_t word) {
+  return ((((word - kLowBits8) & ~word) | word) & kHighBits8) != 0;
+}
+
+// Whether any 16-bit lane of word is 0 or above 0x7f.
+inline bool HasNonAscii16(uint64_t word) {
+  return (((word - kLowBits16) & ~word & kHighBits16) | (word & kNonAsciiBits16)) != 0;
+}
+
+inline bool IsAscii(uint16_t c) {
+  return c - 1u < 0x7fu;
+}
+
+}  // namespace
+
+size_t AsciiPrefixLength(const char* str, size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    if (HasNonAscii8(Load64(str + i)) || HasNonAscii8(Load64(str + i + 8))) {
+      break;
+    }
+  }
+  while (i < len && IsAscii(static_cast<uint8_t>(str[i]))) {
+    i++;
+  }
+  return i;
+}
+
+size_t AsciiPrefixLength(const char16_t* str, size_t len) {
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    if (HasNonAscii16(Load64(str + i)) || HasNonAscii16(Load64(str + i + 4))) {
+      break;
+    }
+  }
+  while (i < len && IsAscii(str[i])) {
+    i++;
+  }
+  return i;
+}
+
+static inline bool IsLeadSurrogate(char16_t c) {
+  return c >= 0xd800 && c < 0xdc00;
+}
+
+static inline bool IsTrailSurrogate(char16_t c) {
+  return c >= 0xdc00 && c < 0xe000;
+}
+
+size_t ModifiedUtf8Length(const char16_t* utf16, size_t len) {
+  const char16_t* const end = utf16 + len;
+  size_t length = 0;
+  while (utf16 < end) {
+    while (end - utf16 >= 8 && !HasNonAscii16(Load64(utf16)) &&
+           !HasNonAscii16(Load64(utf16 + 4))) {
+      utf16 += 8;
+      length += 8;
+    }
+    if (utf16 == end) {
+      break;
+    }
+
+    const char16_t c = *utf16++;
+    if (IsAscii(c)) {
+      length += 1;
+    } else if (IsLeadSurrogate(c) && utf16 < end && IsTrailSurrogate(*utf16)) {
+      utf16++;
+      length += 4;
+    } else {
+      length += c < 0x800 ? 2 : 3;
+    }
+  }
+  return length;
+}
+
+char* EncodeModifiedUtf8(const char16_t* utf16, size_t len, char* out) {
+  const char16_t* const end = utf16 + len;
+  while (utf16 < end) {
+    // Narrow ASCII 8 characters at a time; the fixed size loop is vectorized.
+    while (end - utf16 >= 8 && !HasNonAscii16(Load64(utf16)) &&
+           !HasNonAscii16(Load64(utf16 + 4))) {
+      for (size_t i = 0; i < 8; i++) {
+        out[i] = static_cast<char>(utf16[i]);
+      }
+      utf16 += 8;
+      out += 8;
+    }
+    if (utf16 == end) {
+      break;
+    }
+
+    const char16_t c = *utf16++;
+    if (IsAscii(c)) {
+      *out++ = static_cast<char>(c);
+    } else if (IsLeadSurrogate(c) && utf16 < end && IsTrailSurrogate(*utf16)) {
+      const char32_t codepoint = 0x10000 + ((c - 0xd800) << 10) + (*utf16++ - 0xdc00);
+      *out++ = static_cast<char>(0xf0 | (codepoint >> 18));
+      *out++ = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3f));
+      *out++ = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f));
+      *out++ = static_cast<char>(0x80 | (codepoint & 0x3f));
+    } else if (c < 0x800) {
+      // Includes U+0000, which becomes 0xc0 0x80.
+      *out++ = static_cast<char>(0xc0 | (c >> 6));
+      *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+      *out++ = static_cast<char>(0xe0 | (c >> 12));
+      *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    }
+  }
+  return out;
+}
+
+// Returns the payload bits of the count continuation bytes at in, or -1 if they are not there.
+static inline int32_t ReadContinuation(const uint8_t* in, const uint8_t* end, int count) {
+  if (end - in < count) {
+    return -1;
+  }
+  int32_t bits = 0;
+  for (int i = 0; i < count; i++) {
+    if ((in[i] & 0xc0) != 0x80) {
+      return -1;
+    }
+    bits = (bits << 6) | (in[i] & 0x3f);
+  }
+  return bits;
+}
+
+ssize_t DecodeModifiedUtf8(const char* utf8, size_t len, char16_t* out) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(utf8);
+  const uint8_t* const end = in + len;
+  char16_t* const start = out;
+  while (in < end) {
+    // Widen ASCII 16 bytes at a time; the fixed size loop is vectorized.
+    while (end - in >= 16 && !HasNonAscii8(Load64(in)) && !HasNonAscii8(Load64(in + 8))) {
+      for (size_t i = 0; i < 16; i++) {
+        out[i] = in[i];
+      }
+      in += 16;
+      out += 16;
+    }
+    if (in == end) {
+      break;
+    }
+
+    const uint8_t lead = *in++;
+    int32_t bits;
+    if (IsAscii(lead)) {
+      *out++ = lead;
+    } else if (lead == 0) {
+      // Like NewStringUTF, stop at a NUL byte; Modified UTF-8 has no other way to encode it.
+      break;
+    } else if ((lead & 0xe0) == 0xc0 && (bits = ReadContinuation(in, end, 1)) >= 0) {
+      in += 1;
+      *out++ = static_cast<char16_t>(((lead & 0x1f) << 6) | bits);
+    } else if ((lead & 0xf0) == 0xe0 && (bits = ReadContinuation(in, end, 2)) >= 0) {
+      in += 2;
+      *out++ = static_cast<char16_t>(((lead & 0x0f) << 12) | bits);
+    } else if ((lead & 0xf8) == 0xf0 && (bits = ReadContinuation(in, end, 3)) >= 0) {
+      in += 3;
+      const int32_t codepoint = ((lead & 0x07) << 18) | bits;
+      if (codepoint < 0x10000 || codepoint > 0x10ffff) {
+        return -1;
+      }
+      *out++ = static_cast<char16_t>(0xd800 + ((codepoint - 0x10000) >> 10));
+      *out++ = static_cast<char16_t>(0xdc00 + ((codepoint - 0x10000) & 0x3ff));
+    } else {
+      return -1;
+    }
+  }
+  return out - start;
+}
+
 std::string GetString(const android::ResStringPool& pool, size_t idx) {
   if (auto str = pool.string8At(idx); str.ok()) {
     return ModifiedUtf8ToUtf8(*str);
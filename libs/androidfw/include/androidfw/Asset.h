@@ -35,6 +35,8 @@
 
 namespace android {
 
+class InflateSeekIndex;
+
 /*
  * Instances of this class provide read-only operations on a byte stream.
  *
@@ -221,10 +223,13 @@ private:
      * Create the asset from a memory-mapped file segment with compressed
      * data.
      *
-     * The asset takes ownership of the incfs::IncFsFileMap.
+     * The asset takes ownership of the incfs::IncFsFileMap.  If "seekIndex" is
+     * not null, seeking resumes inflation from the checkpoints it holds, and
+     * reading adds to them.
      */
-    static std::unique_ptr<Asset> createFromCompressedMap(incfs::IncFsFileMap&& dataMap,
-                                                          size_t uncompressedLen, AccessMode mode);
+    static std::unique_ptr<Asset> createFromCompressedMap(
+            incfs::IncFsFileMap&& dataMap, size_t uncompressedLen, AccessMode mode,
+            std::shared_ptr<InflateSeekIndex> seekIndex = nullptr);
 
     /*
      * Create from a reference-counted chunk of shared memory.
@@ -320,11 +325,13 @@ public:
         size_t uncompressedLen, size_t compressedLen);
 
     /*
-     * Use a memory-mapped region.
+     * Use a memory-mapped region, seeking with the help of "seekIndex" if it
+     * is not null.
      *
      * On success, the object takes ownership of "fd".
      */
-    status_t openChunk(incfs::IncFsFileMap&& dataMap, size_t uncompressedLen);
+    status_t openChunk(incfs::IncFsFileMap&& dataMap, size_t uncompressedLen,
+        std::shared_ptr<InflateSeekIndex> seekIndex = nullptr);
 
     /*
      * Standard Asset interfaces.
@@ -20,7 +20,9 @@
 #include <utils/RefBase.h>
 
 #include <array>
+#include <atomic>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <span>
 #include <unordered_map>
@@ -30,6 +32,7 @@
 #include "androidfw/ApkAssets.h"
 #include "androidfw/Asset.h"
 #include "androidfw/AssetManager.h"
+#include "androidfw/ResolvedLayoutCache.h"
 #include "androidfw/ResourceTypes.h"
 #include "androidfw/Util.h"
 
@@ -79,6 +82,11 @@ struct FindEntryResult;
 
 // AssetManager2 is the main entry point for accessing assets and resources.
 // AssetManager2 provides caching of resources retrieved via the underlying ApkAssets.
+//
+// Const methods may be called from several threads at once, as long as no non-const method runs
+// concurrently with them: the caches they fill are guarded internally. Callers that share an
+// AssetManager2 between threads are expected to hold a reader/writer lock around it, such as
+// Guarded<AssetManager2> with ScopedSharedLock for lookups and ScopedLock for everything else.
 class AssetManager2 {
   friend Theme;
 
@@ -130,6 +138,12 @@ class AssetManager2 {
     return int(apk_assets_.size());
   }
 
+  // Returns a number that changes every time SetApkAssets() invalidates the caches, for caches
+  // kept outside of the AssetManager to notice that their contents may no longer be valid.
+  uint32_t GetApkAssetsGeneration() const {
+    return apk_assets_generation_;
+  }
+
   // Returns the string pool for the given asset cookie.
   // Use the string pool returned here with a valid Res_value object of type Res_value::TYPE_STRING.
   const ResStringPool* GetStringPoolForCookie(ApkAssetsCookie cookie) const;
@@ -448,6 +462,9 @@ class AssetManager2 {
   base::expected<const ResolvedBag*, NullOrIOError> GetBag(
       uint32_t resid, std::vector<uint32_t>& child_resids) const;
 
+  // Adds a newly resolved bag to cached_bags_ and returns the cached bag for resid.
+  const ResolvedBag* CacheBag(uint32_t resid, util::unique_cptr<ResolvedBag> bag) const;
+
   // Finish an operation that was running with the current asset manager, and clean up the
   // promoted apk assets when the last operation ends.
   void FinishOperation() const;
@@ -471,6 +488,9 @@ class AssetManager2 {
 
   uint32_t default_locale_;
 
+  // Incremented each time the ApkAssets are replaced along with the caches.
+  uint32_t apk_assets_generation_ = 0u;
+
   // The current configurations set for this AssetManager. When this changes, cached resources
   // may need to be purged.
   std::vector<ResTable_config> configurations_;
@@ -486,9 +506,31 @@ class AssetManager2 {
   // Cached set of resolved resource values.
   mutable std::unordered_map<uint32_t, SelectedValue> cached_resolved_values_;
 
+  // Synchronization members that keep AssetManager2 movable. Moving is only valid while no other
+  // thread uses the AssetManager, so the moved-to object simply gets a fresh mutex.
+  struct CacheMutex : std::mutex {
+    CacheMutex() = default;
+    CacheMutex(CacheMutex&&) {
+    }
+  };
+  struct OperationCount : std::atomic<int> {
+    OperationCount() : std::atomic<int>(0) {
+    }
+    OperationCount(OperationCount&& other) : std::atomic<int>(other.load()) {
+    }
+  };
+
+  // Guards cached_bags_, cached_bag_resid_stacks_ and cached_resolved_values_ for concurrent
+  // const calls. Entries are only ever added under it; they are removed by non-const methods,
+  // which the caller runs exclusively, so pointers into the caches stay valid while reading.
+  mutable CacheMutex cache_lock_;
+
+  // Guards the promotion of apk_assets_ and clearing them when the last operation finishes.
+  mutable CacheMutex apk_assets_lock_;
+
   // Tracking the number of the started operations running with the current AssetManager.
   // Finishing the last one clears all promoted apk assets.
-  mutable int number_of_running_scoped_operations_ = 0;
+  mutable OperationCount number_of_running_scoped_operations_;
 
   // Whether or not to save resource resolution steps
   bool resource_resolution_logging_enabled_ = false;
@@ -535,8 +577,10 @@ class AssetManager2 {
     String8 best_package_name;
   };
 
-  // Record of the last resolved resource's resolution path.
+  // Record of the last resolved resource's resolution path. Held for the whole of a logged
+  // FindEntry(), so concurrent lookups log one at a time.
   mutable Resolution last_resolution_;
+  mutable CacheMutex resolution_lock_;
 };
 
 class Theme {
@@ -596,6 +640,12 @@ class Theme {
     return type_spec_flags_;
   }
 
+  // Returns the values ApplyStyleCached() resolved against this theme. It is cleared whenever the
+  // theme changes.
+  ResolvedLayoutCache& GetResolvedLayoutCache() {
+    return layout_cache_;
+  }
+
   void Dump() const;
 
   struct Entry;
@@ -609,6 +659,8 @@ class Theme {
 
   std::vector<uint32_t> keys_;
   std::vector<Entry> entries_;
+
+  ResolvedLayoutCache layout_cache_;
 };
 
 inline const ResolvedBag::Entry* begin(const ResolvedBag* bag) {
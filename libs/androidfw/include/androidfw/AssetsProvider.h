@@ -18,7 +18,9 @@
 #define ANDROIDFW_ASSETSPROVIDER_H
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "android-base/function_ref.h"
 #include "android-base/macros.h"
@@ -136,6 +138,11 @@ struct ZipAssetsProvider : public AssetsProvider {
   PathOrDebugName name_;
   package_property_t flags_;
   time_t last_mod_time_;
+
+  // Seek indices of the large compressed entries opened for random access, by path, so that
+  // each time such an entry is opened it can seek from where earlier Assets have read.
+  mutable std::mutex seek_indices_lock_;
+  mutable std::unordered_map<std::string, std::shared_ptr<InflateSeekIndex>> seek_indices_;
 };
 
 // Supplies assets from a root directory.
@@ -59,9 +59,21 @@ base::expected<std::monostate, IOError> ApplyStyle(Theme* theme, ResXMLParser* x
                                                    const uint32_t* attrs, size_t attrs_length,
                                                    uint32_t* out_values, uint32_t* out_indices);
 
+// Same as ApplyStyle(), but reuses the values that the theme's ResolvedLayoutCache holds for an
+// identical element, requested attributes and default style, and caches the values otherwise.
+// `out_values` must NOT be nullptr.
+// `out_indices` is NOT optional and must NOT be nullptr.
+base::expected<std::monostate, IOError> ApplyStyleCached(Theme* theme, ResXMLParser* xml_parser,
+                                                         uint32_t def_style_attr,
+                                                         uint32_t def_style_resid,
+                                                         const uint32_t* attrs,
+                                                         size_t attrs_length,
+                                                         uint32_t* out_values,
+                                                         uint32_t* out_indices);
+
 // `out_values` must NOT be nullptr.
 // `out_indices` may be nullptr.
-base::expected<std::monostate, IOError> RetrieveAttributes(AssetManager2* assetmanager,
+base::expected<std::monostate, IOError> RetrieveAttributes(const AssetManager2* assetmanager,
                                                            ResXMLParser* xml_parser,
                                                            uint32_t* attrs,
                                                            size_t attrs_length,
@@ -18,6 +18,7 @@
 
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <type_traits>
 #include <utility>
 
@@ -28,6 +29,9 @@ namespace android {
 template <typename T>
 class ScopedLock;
 
+template <typename T>
+class ScopedSharedLock;
+
 // Owns the guarded object and protects access to it via a mutex.
 // The guarded object is inaccessible via this class.
 // The mutex is locked and the object accessed via the ScopedLock<T> class.
@@ -43,6 +47,10 @@ class ScopedLock;
 //     *locked_string += " world";
 //   }
 //
+// Readers that only need const access may instead hold a ScopedSharedLock<T>, which runs
+// concurrently with other ScopedSharedLocks and excludes only ScopedLocks. T's const methods must
+// then be safe to call from several threads at once.
+//
 template <typename T>
 class Guarded {
   static_assert(!std::is_pointer_v<T>, "T must not be a raw pointer");
@@ -69,9 +77,10 @@ class Guarded {
 
  private:
   friend class ScopedLock<T>;
+  friend class ScopedSharedLock<T>;
   DISALLOW_COPY_AND_ASSIGN(Guarded);
 
-  std::mutex lock_;
+  std::shared_mutex lock_;
   std::optional<T> guarded_;
 };
 
@@ -96,8 +105,34 @@ class ScopedLock {
  private:
   DISALLOW_COPY_AND_ASSIGN(ScopedLock);
 
-  std::lock_guard<std::mutex> lock_;
+  std::lock_guard<std::shared_mutex> lock_;
   T& guarded_;
 };
 
+template <typename T>
+class ScopedSharedLock {
+ public:
+  explicit ScopedSharedLock(Guarded<T>& guarded)
+      : lock_(guarded.lock_), guarded_(*guarded.guarded_) {
+  }
+
+  const T& operator*() const {
+    return guarded_;
+  }
+
+  const T* operator->() const {
+    return &guarded_;
+  }
+
+  const T* get() const {
+    return &guarded_;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedSharedLock);
+
+  std::shared_lock<std::shared_mutex> lock_;
+  const T& guarded_;
+};
+
 }  // namespace android
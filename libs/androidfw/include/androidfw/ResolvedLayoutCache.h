@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDFW_RESOLVEDLAYOUTCACHE_H_
+#define ANDROIDFW_RESOLVEDLAYOUTCACHE_H_
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "android-base/macros.h"
+#include "androidfw/ResourceTypes.h"
+
+namespace android {
+
+class AssetManager2;
+
+// Holds the attribute values that ApplyStyle() resolved against one Theme, so that inflating the
+// same layout again, as a list does for every row it binds, copies the values instead of walking
+// the XML, the styles and the theme again.
+//
+// An element is identified by everything ApplyStyle() reads from it: the layout it comes from,
+// its attributes and its style. Together with the requested attributes and default style this
+// makes up the key, so identical elements share an entry no matter which parser they come from.
+//
+// Entries are dropped when the Theme changes, when the ApkAssets of its AssetManager change, and
+// when the configuration changes in a way that the theme or any of the cached values depend on.
+class ResolvedLayoutCache {
+ public:
+  using Key = std::vector<uint32_t>;
+
+  ResolvedLayoutCache() = default;
+
+  // Fills `out_key` with the key for the element at the position of `xml_parser`, which may be
+  // nullptr, and the given requested attributes and default style.
+  static void MakeKey(const ResXMLParser* xml_parser, uint32_t def_style_attr,
+                      uint32_t def_style_resid, const uint32_t* attrs, size_t attrs_length,
+                      Key* out_key);
+
+  // Copies the values cached for `key` into `out_values` and `out_indices`, which are laid out as
+  // ApplyStyle() writes them. Returns false if there are none.
+  bool Find(const AssetManager2& asset_manager, const Key& key, uint32_t* out_values,
+            uint32_t* out_indices);
+
+  // Caches the values that ApplyStyle() wrote for `key`. `changing_configurations` is the mask
+  // of configuration changes that would make it resolve them differently.
+  void Insert(const AssetManager2& asset_manager, Key key, const uint32_t* values,
+              const uint32_t* indices, uint32_t changing_configurations);
+
+  void Clear();
+
+  size_t size() const;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ResolvedLayoutCache);
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    std::vector<uint32_t> values;
+    std::vector<uint32_t> indices;
+  };
+
+  // Drops every entry if the ApkAssets of `asset_manager` were replaced, or its configuration
+  // changed in a way that matters, since they were resolved. Must be called with lock_ held.
+  void ValidateLocked(const AssetManager2& asset_manager);
+
+  // Views can be resolved concurrently under a shared AssetManager lock.
+  mutable std::mutex lock_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+
+  // What the entries were resolved against.
+  uint32_t apk_assets_generation_ = 0u;
+  std::vector<ResTable_config> configurations_;
+  uint32_t changing_configurations_ = 0u;
+};
+
+}  // namespace android
+
+#endif  // ANDROIDFW_RESOLVEDLAYOUTCACHE_H_
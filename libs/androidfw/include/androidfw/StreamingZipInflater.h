@@ -20,6 +20,10 @@
 #include <unistd.h>
 #include <inttypes.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <util/map_ptr.h>
 #include <zlib.h>
 
@@ -27,6 +31,39 @@
 
 namespace android {
 
+/*
+ * Points at which inflating a compressed asset can be resumed, so that seeking does not
+ * have to inflate everything from the start of the asset up to the new position.
+ *
+ * Each checkpoint holds the inflater's 32KB window, so one is taken at the first deflate
+ * block boundary after every SPACING bytes of output rather than at every block.  The
+ * index is filled in by the StreamingZipInflaters reading the asset as they get there,
+ * and may be shared between any number of them on different threads.
+ */
+class InflateSeekIndex {
+public:
+    static const size_t SPACING = 1024 * 1024;
+
+    InflateSeekIndex() = default;
+
+    // number of checkpoints taken so far
+    size_t size() const;
+
+private:
+    friend class StreamingZipInflater;
+
+    struct Checkpoint {
+        off64_t outOffset;          // uncompressed bytes before this point
+        size_t inOffset;            // compressed bytes before this point
+        int bits;                   // bits of the byte before inOffset still to be inflated
+        uint8_t lastByte;           // that byte, if bits is not zero
+        std::vector<uint8_t> window;
+    };
+
+    mutable std::mutex mLock;
+    std::vector<Checkpoint> mCheckpoints;  // in increasing order of outOffset
+};
+
 class StreamingZipInflater {
 public:
     static const size_t INPUT_CHUNK_SIZE = 64 * 1024;
@@ -44,14 +81,22 @@ public:
     // be NULL, in which case the data is consumed and discarded.
     ssize_t read(void* outBuf, size_t count);
 
-    // seeking backwards requires uncompressing fom the beginning, so is very
-    // expensive.  seeking forwards only requires uncompressing from the current
-    // position to the destination.
+    // seeking backwards requires uncompressing from the beginning, or from the closest
+    // checkpoint before the destination if there is a seek index, so is expensive.
+    // seeking forwards only requires uncompressing from the current position, or from
+    // a closer checkpoint, to the destination.
     off64_t seekAbsolute(off64_t absoluteInputPosition);
 
+    // Records checkpoints in 'index' while reading and resumes from them when seeking.
+    // Must be called before the first read.
+    void setSeekIndex(std::shared_ptr<InflateSeekIndex> index);
+
 private:
     void initInflateState();
     int readNextChunk();
+    size_t inputConsumed() const;
+    void addCheckpoint();
+    bool resumeFromCheckpoint(off64_t absoluteInputPosition);
 
     // where to find the uncompressed data
     int mFd;
@@ -79,6 +124,10 @@ private:
     // input state bookkeeping
     size_t mInNextChunkOffset;  // offset from start of blob at which the next input chunk lies
     // the z_stream contains state about input block consumption
+
+    // optional checkpoints to seek to
+    std::shared_ptr<InflateSeekIndex> mSeekIndex;
+    off64_t mNextCheckpoint;    // output offset after which the next checkpoint is due
 };
 
 }
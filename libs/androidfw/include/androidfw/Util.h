@@ -78,6 +78,26 @@ std::string Utf8ToModifiedUtf8(std::string_view utf8);
 // Converts a Modified UTF8 string into a UTF8 string
 std::string ModifiedUtf8ToUtf8(std::string_view modified_utf8);
 
+// Returns the length of the run of characters U+0001 to U+007F at the start of str, which are
+// the characters that every UTF-8 variant encodes as themselves. Checks 16 bytes at a time.
+size_t AsciiPrefixLength(const char* str, size_t len);
+size_t AsciiPrefixLength(const char16_t* str, size_t len);
+
+// The following convert between UTF-16 and the Modified UTF-8 of JNI's GetStringUTFRegion and
+// NewStringUTF: U+0000 is encoded as two bytes, a surrogate pair as one four byte sequence and
+// an unpaired surrogate as three bytes. Runs of ASCII are copied in bulk.
+
+// Returns the number of bytes EncodeModifiedUtf8 writes for utf16, without a terminator.
+size_t ModifiedUtf8Length(const char16_t* utf16, size_t len);
+
+// Writes utf16 to out, which must have room for ModifiedUtf8Length(utf16, len) bytes or, more
+// simply, 3 * len. Does not write a terminator. Returns the end of the written bytes.
+char* EncodeModifiedUtf8(const char16_t* utf16, size_t len, char* out);
+
+// Decodes Modified UTF-8, or plain UTF-8, into out, which must have room for len characters.
+// Returns the number of characters written, or -1 if utf8 is malformed.
+ssize_t DecodeModifiedUtf8(const char* utf8, size_t len, char16_t* out);
+
 inline uint16_t HostToDevice16(uint16_t value) {
   return htods(value);
 }
@@ -20,6 +20,7 @@
 #include "androidfw/ApkAssets.h"
 #include "androidfw/AssetManager.h"
 #include "androidfw/AssetManager2.h"
+#include "androidfw/MutexGuard.h"
 #include "androidfw/ResourceTypes.h"
 
 #include "BenchmarkHelpers.h"
@@ -258,4 +259,66 @@ static void BM_AssetManagerSetConfigurationFrameworkOld(benchmark::State& state)
 }
 BENCHMARK(BM_AssetManagerSetConfigurationFrameworkOld);
 
+static void ResolveStyle(const AssetManager2& assets, uint32_t style) {
+  auto op = assets.StartOperation();
+  auto bag = assets.GetBag(style);
+  if (!bag.has_value()) {
+    return;
+  }
+  for (const auto& entry : *bag) {
+    AssetManager2::SelectedValue value(*bag, entry);
+    assets.ResolveReference(value);
+    benchmark::DoNotOptimize(value.data);
+  }
+}
+
+// Several threads resolving framework styles through one Guarded<AssetManager2>, the way
+// background inflation, the UI thread and worker threads share an AssetManager through the JNI
+// layer. range(0) picks exclusive (0) or shared (1) locking for the lookups.
+static void BM_AssetManagerResolveStylesContended(benchmark::State& state) {
+  static const char* const kStyles[] = {
+      "android:style/Theme.Material",
+      "android:style/Theme.Material.Light",
+      "android:style/Widget.Material.Button",
+      "android:style/Widget.Material.TextView",
+      "android:style/TextAppearance.Material.Body1",
+  };
+  static auto* guarded = [] {
+    auto* guarded = new Guarded<AssetManager2>();
+    if (auto apk = ApkAssets::Load(kFrameworkPath)) {
+      ScopedLock<AssetManager2> assets(*guarded);
+      assets->SetApkAssets({apk});
+    }
+    return guarded;
+  }();
+  static const auto styles = [] {
+    std::vector<uint32_t> styles;
+    ScopedLock<AssetManager2> assets(*guarded);
+    for (const char* name : kStyles) {
+      if (auto resid = assets->GetResourceId(name); resid.has_value()) {
+        styles.push_back(*resid);
+      }
+    }
+    return styles;
+  }();
+  if (styles.size() != std::size(kStyles)) {
+    state.SkipWithError("Failed to load assets");
+    return;
+  }
+
+  const bool shared = state.range(0);
+  for (auto _ : state) {
+    for (uint32_t style : styles) {
+      if (shared) {
+        ScopedSharedLock<AssetManager2> assets(*guarded);
+        ResolveStyle(*assets, style);
+      } else {
+        ScopedLock<AssetManager2> assets(*guarded);
+        ResolveStyle(*assets, style);
+      }
+    }
+  }
+}
+BENCHMARK(BM_AssetManagerResolveStylesContended)->Arg(0)->Arg(1)->Threads(8)->UseRealTime();
+
 }  // namespace android
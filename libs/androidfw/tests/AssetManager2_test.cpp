@@ -17,6 +17,8 @@
 #include "androidfw/AssetManager2.h"
 #include "androidfw/AssetManager.h"
 
+#include <thread>
+
 #include "TestHelpers.h"
 #include "android-base/file.h"
 #include "android-base/logging.h"
@@ -330,6 +332,42 @@ TEST_F(AssetManager2Test, FindsStyleResourceWithParentFromSharedLibrary) {
   EXPECT_EQ(0x03, get_package_id((*bag)->entries[1].key));
 }
 
+TEST_F(AssetManager2Test, ConcurrentConstLookupsShareCachedBags) {
+  AssetManager2 assetmanager;
+  assetmanager.SetApkAssets({style_assets_});
+
+  constexpr int kThreadCount = 8;
+  std::vector<const ResolvedBag*> bags(kThreadCount);
+  std::vector<uint32_t> resolved(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&, i] {
+      const AssetManager2& am = assetmanager;
+      auto op = am.StartOperation();
+      auto bag = am.GetBag(app::R::style::StyleTwo);
+      if (!bag.has_value()) {
+        return;
+      }
+      bags[i] = *bag;
+      AssetManager2::SelectedValue value(*bag, (*bag)->entries[3]);
+      if (am.ResolveReference(value).has_value()) {
+        resolved[i] = value.type;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Every thread ends up with the single cached copy of the bag.
+  ASSERT_THAT(bags[0], NotNull());
+  for (int i = 0; i < kThreadCount; i++) {
+    EXPECT_EQ(bags[0], bags[i]);
+    EXPECT_EQ(Res_value::TYPE_STRING, resolved[i]);
+  }
+  EXPECT_EQ(bags[0], *assetmanager.GetBag(app::R::style::StyleTwo));
+}
+
 TEST_F(AssetManager2Test, MergesStylesWithParentFromSingleApkAssets) {
   AssetManager2 assetmanager;
   assetmanager.SetApkAssets({style_assets_});
@@ -35,6 +35,7 @@ namespace android {
 constexpr const static char* kFrameworkPath = "/system/framework/framework-res.apk";
 constexpr const static uint32_t Theme_Material_Light = 0x01030237u;
 
+// Arg(0) resolves the values every time, Arg(1) copies them from the theme's ResolvedLayoutCache.
 static void BM_ApplyStyle(benchmark::State& state) {
   auto styles_apk = ApkAssets::Load(GetTestDataPath() + "/styles/styles.apk");
   if (styles_apk == nullptr) {
@@ -72,11 +73,16 @@ static void BM_ApplyStyle(benchmark::State& state) {
   std::array<uint32_t, attrs.size() + 1> indices;
 
   while (state.KeepRunning()) {
-    ApplyStyle(theme.get(), &xml_tree, 0u /*def_style_attr*/, 0u /*def_style_res*/, attrs.data(),
-               attrs.size(), values.data(), indices.data());
+    if (state.range(0) == 0) {
+      ApplyStyle(theme.get(), &xml_tree, 0u /*def_style_attr*/, 0u /*def_style_res*/,
+                 attrs.data(), attrs.size(), values.data(), indices.data());
+    } else {
+      ApplyStyleCached(theme.get(), &xml_tree, 0u /*def_style_attr*/, 0u /*def_style_res*/,
+                       attrs.data(), attrs.size(), values.data(), indices.data());
+    }
   }
 }
-BENCHMARK(BM_ApplyStyle);
+BENCHMARK(BM_ApplyStyle)->Arg(0)->Arg(1);
 
 static void BM_ApplyStyleFramework(benchmark::State& state) {
   auto framework_apk = ApkAssets::Load(kFrameworkPath);
@@ -157,10 +163,16 @@ static void BM_ApplyStyleFramework(benchmark::State& state) {
   std::array<uint32_t, attrs.size() * STYLE_NUM_ENTRIES> values;
   std::array<uint32_t, attrs.size() + 1> indices;
   while (state.KeepRunning()) {
-    ApplyStyle(theme.get(), &xml_tree, 0x01010084u /*def_style_attr*/, 0u /*def_style_res*/,
-               attrs.data(), attrs.size(), values.data(), indices.data());
+    if (state.range(0) == 0) {
+      ApplyStyle(theme.get(), &xml_tree, 0x01010084u /*def_style_attr*/, 0u /*def_style_res*/,
+                 attrs.data(), attrs.size(), values.data(), indices.data());
+    } else {
+      ApplyStyleCached(theme.get(), &xml_tree, 0x01010084u /*def_style_attr*/,
+                       0u /*def_style_res*/, attrs.data(), attrs.size(), values.data(),
+                       indices.data());
+    }
   }
 }
-BENCHMARK(BM_ApplyStyleFramework);
+BENCHMARK(BM_ApplyStyleFramework)->Arg(0)->Arg(1);
 
 }  // namespace android
@@ -272,5 +272,53 @@ TEST_F(AttributeResolutionXmlTest, ThemeAndXmlParser) {
   EXPECT_EQ(expected_indices, indices);
 }
 
-} // namespace android
+TEST_F(AttributeResolutionXmlTest, ApplyStyleCached) {
+  std::unique_ptr<Theme> theme = assetmanager_.NewTheme();
+  ASSERT_TRUE(theme->ApplyStyle(R::style::StyleTwo).has_value());
 
+  std::array<uint32_t, 6> attrs{{R::attr::attr_one, R::attr::attr_two, R::attr::attr_three,
+                                 R::attr::attr_four, R::attr::attr_five, R::attr::attr_empty}};
+  std::array<uint32_t, attrs.size() * STYLE_NUM_ENTRIES> values;
+  std::array<uint32_t, attrs.size() + 1> indices;
+  ASSERT_TRUE(ApplyStyle(theme.get(), &xml_parser_, 0u /*def_style_attr*/, 0u /*def_style_res*/,
+                         attrs.data(), attrs.size(), values.data(), indices.data()).has_value());
+
+  // The first call resolves the values and caches them, the second copies them from the cache.
+  ResolvedLayoutCache& cache = theme->GetResolvedLayoutCache();
+  for (size_t i = 0; i < 2; i++) {
+    std::array<uint32_t, attrs.size() * STYLE_NUM_ENTRIES> cached_values;
+    std::array<uint32_t, attrs.size() + 1> cached_indices;
+    cached_values.fill(0xdeadbeef);
+    cached_indices.fill(0xdeadbeef);
+    ASSERT_TRUE(ApplyStyleCached(theme.get(), &xml_parser_, 0u /*def_style_attr*/,
+                                 0u /*def_style_res*/, attrs.data(), attrs.size(),
+                                 cached_values.data(), cached_indices.data()).has_value());
+    EXPECT_EQ(values, cached_values);
+    EXPECT_EQ(indices, cached_indices);
+    EXPECT_EQ(1u, cache.size());
+  }
+
+  // Values resolved without the XML are another entry.
+  ASSERT_TRUE(ApplyStyleCached(theme.get(), nullptr /*xml_parser*/, 0u /*def_style_attr*/,
+                               0u /*def_style_res*/, attrs.data(), attrs.size(), values.data(),
+                               indices.data()).has_value());
+  EXPECT_EQ(2u, cache.size());
+
+  // Changing the theme drops them.
+  ASSERT_TRUE(theme->ApplyStyle(R::style::StyleOne).has_value());
+  EXPECT_EQ(0u, cache.size());
+
+  // So does replacing the ApkAssets, though the theme does not change.
+  ASSERT_TRUE(ApplyStyleCached(theme.get(), &xml_parser_, 0u /*def_style_attr*/,
+                               0u /*def_style_res*/, attrs.data(), attrs.size(), values.data(),
+                               indices.data()).has_value());
+  ResolvedLayoutCache::Key key;
+  ResolvedLayoutCache::MakeKey(&xml_parser_, 0u /*def_style_attr*/, 0u /*def_style_res*/,
+                               attrs.data(), attrs.size(), &key);
+  EXPECT_TRUE(cache.Find(assetmanager_, key, values.data(), indices.data()));
+  assetmanager_.SetApkAssets({styles_assets_});
+  EXPECT_FALSE(cache.Find(assetmanager_, key, values.data(), indices.data()));
+  EXPECT_EQ(0u, cache.size());
+}
+
+} // namespace android
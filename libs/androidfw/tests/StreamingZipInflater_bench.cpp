@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <string>
+
+#include "android-base/file.h"
+#include "benchmark/benchmark.h"
+
+#include "androidfw/StreamingZipInflater.h"
+
+namespace android {
+
+constexpr size_t kAssetSize = 50 * 1024 * 1024;
+constexpr size_t kReadSize = 64 * 1024;
+
+// A deflated asset of kAssetSize bytes of text, as a game or media file stored compressed.
+static const std::string& GetCompressedAsset() {
+  static const std::string compressed = [] {
+    std::mt19937 random(42);
+    std::string text;
+    while (text.size() < kAssetSize) {
+      text += "frame " + std::to_string(random() % 100000) + " sample ";
+    }
+    text.resize(kAssetSize);
+
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&stream, text.size()), '\0');
+    stream.next_in = (Bytef*)text.data();
+    stream.avail_in = text.size();
+    stream.next_out = (Bytef*)out.data();
+    stream.avail_out = out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+  }();
+  return compressed;
+}
+
+// Reads kReadSize bytes at random offsets, as AAsset_seek() and AAsset_read() would. With
+// Arg(1), the inflater has a seek index that an earlier sequential read of the asset filled.
+static void BM_StreamingZipInflaterRandomRead(benchmark::State& state) {
+  const std::string& compressed = GetCompressedAsset();
+  TemporaryFile file;
+  if (!base::WriteStringToFd(compressed, file.fd)) {
+    state.SkipWithError("Failed to write the asset");
+    return;
+  }
+
+  StreamingZipInflater inflater(file.fd, 0, kAssetSize, compressed.size());
+  if (state.range(0) != 0) {
+    inflater.setSeekIndex(std::make_shared<InflateSeekIndex>());
+    inflater.read(nullptr, kAssetSize);
+  }
+
+  std::mt19937 random(7);
+  std::string buf(kReadSize, '\0');
+  for (auto&& _ : state) {
+    inflater.seekAbsolute(random() % (kAssetSize - kReadSize));
+    benchmark::DoNotOptimize(inflater.read(buf.data(), buf.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * kReadSize);
+}
+BENCHMARK(BM_StreamingZipInflaterRandomRead)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace android
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "androidfw/StreamingZipInflater.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "android-base/macros.h"
+
+#include "gtest/gtest.h"
+
+namespace android {
+
+// Some megabytes of text that deflates into many blocks.
+static std::string MakeText() {
+  static const char* const kWords[] = {"asset ", "seek ", "inflate ", "window ", "block ",
+                                       "checkpoint\n", "zip ", "read "};
+  std::mt19937 random(42);
+  std::string text;
+  while (text.size() < 6 * InflateSeekIndex::SPACING) {
+    text += kWords[random() % arraysize(kWords)];
+    text += std::to_string(random() % 1000);
+  }
+  return text;
+}
+
+// Deflates `text` the way zip entries are, without a zlib header.
+static std::string Deflate(const std::string& text) {
+  z_stream stream{};
+  EXPECT_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                               Z_DEFAULT_STRATEGY));
+  std::string out(deflateBound(&stream, text.size()), '\0');
+  stream.next_in = (Bytef*)text.data();
+  stream.avail_in = text.size();
+  stream.next_out = (Bytef*)out.data();
+  stream.avail_out = out.size();
+  EXPECT_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  return out;
+}
+
+class StreamingZipInflaterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    text_ = MakeText();
+    compressed_ = Deflate(text_);
+    ASSERT_TRUE(base::WriteStringToFd(compressed_, file_.fd));
+  }
+
+  std::unique_ptr<StreamingZipInflater> MakeInflater() {
+    return std::make_unique<StreamingZipInflater>(file_.fd, 0, text_.size(), compressed_.size());
+  }
+
+  // Seeks to a few places in both directions and checks what is read there.
+  void ExpectRandomReads(StreamingZipInflater* inflater) {
+    std::mt19937 random(7);
+    std::string buf(10000, '\0');
+    for (int i = 0; i < 20; i++) {
+      const off64_t offset = random() % (text_.size() - buf.size());
+      ASSERT_EQ(offset, inflater->seekAbsolute(offset));
+      ASSERT_EQ(ssize_t(buf.size()), inflater->read(buf.data(), buf.size()));
+      ASSERT_EQ(text_.substr(offset, buf.size()), buf) << "at " << offset;
+    }
+  }
+
+  std::string text_;
+  std::string compressed_;
+  TemporaryFile file_;
+};
+
+TEST_F(StreamingZipInflaterTest, ReadingAddsCheckpoints) {
+  auto index = std::make_shared<InflateSeekIndex>();
+  auto inflater = MakeInflater();
+  inflater->setSeekIndex(index);
+
+  std::string out(text_.size(), '\0');
+  ASSERT_EQ(ssize_t(out.size()), inflater->read(out.data(), out.size()));
+  EXPECT_EQ(text_, out);
+
+  // Checkpoints are at least SPACING bytes apart, and none is needed at the start.
+  EXPECT_GT(index->size(), 0u);
+  EXPECT_LT(index->size(), text_.size() / InflateSeekIndex::SPACING);
+}
+
+TEST_F(StreamingZipInflaterTest, SeeksWithoutIndex) {
+  ExpectRandomReads(MakeInflater().get());
+}
+
+TEST_F(StreamingZipInflaterTest, SeeksResumeFromCheckpoints) {
+  auto index = std::make_shared<InflateSeekIndex>();
+  auto inflater = MakeInflater();
+  inflater->setSeekIndex(index);
+  ExpectRandomReads(inflater.get());
+  const size_t checkpoints = index->size();
+  EXPECT_GT(checkpoints, 0u);
+
+  // Another inflater resumes from the checkpoints taken by the first one.
+  auto other = MakeInflater();
+  other->setSeekIndex(index);
+  ExpectRandomReads(other.get());
+  EXPECT_EQ(checkpoints, index->size());
+}
+
+}  // namespace android
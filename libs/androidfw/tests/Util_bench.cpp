@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "androidfw/ApkAssets.h"
+#include "androidfw/Util.h"
+#include "utils/Unicode.h"
+
+#include "BenchmarkHelpers.h"
+
+namespace android {
+
+constexpr const static char* kFrameworkPath = "/system/framework/framework-res.apk";
+
+struct StringPoolStrings {
+  std::vector<std::string> utf8;
+  std::vector<std::u16string> utf16;
+  size_t max_length = 0;
+};
+
+// Every string of the global string pool of the apk at path, in both encodings.
+static StringPoolStrings LoadStrings(const std::string& path) {
+  StringPoolStrings strings;
+  auto apk = ApkAssets::Load(path);
+  if (apk == nullptr) {
+    return strings;
+  }
+  const ResStringPool* pool = apk->GetLoadedArsc()->GetStringPool();
+  for (size_t i = 0; i < pool->size(); i++) {
+    std::string str = util::GetString(*pool, i);
+    strings.max_length = std::max(strings.max_length, str.size());
+    strings.utf16.push_back(util::Utf8ToUtf16(str));
+    strings.utf8.push_back(std::move(str));
+  }
+  return strings;
+}
+
+static StringPoolStrings LoadStrings(const benchmark::State& state) {
+  return LoadStrings(state.range(0) == 0 ? GetTestDataPath() + "/basic/basic.apk"
+                                         : kFrameworkPath);
+}
+
+static void BM_StringPoolDecodeUtf8Generic(benchmark::State& state) {
+  StringPoolStrings strings = LoadStrings(state);
+  std::vector<char16_t> out(strings.max_length + 1);
+  for (auto&& _ : state) {
+    for (const std::string& str : strings.utf8) {
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(str.data());
+      ssize_t len = utf8_to_utf16_length(data, str.size());
+      utf8_to_utf16(data, str.size(), out.data(), len + 1);
+      benchmark::DoNotOptimize(out.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * strings.utf8.size());
+}
+BENCHMARK(BM_StringPoolDecodeUtf8Generic)->Arg(0)->Arg(1);
+
+static void BM_StringPoolDecodeModifiedUtf8(benchmark::State& state) {
+  StringPoolStrings strings = LoadStrings(state);
+  std::vector<char16_t> out(strings.max_length + 1);
+  for (auto&& _ : state) {
+    for (const std::string& str : strings.utf8) {
+      benchmark::DoNotOptimize(util::DecodeModifiedUtf8(str.data(), str.size(), out.data()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * strings.utf8.size());
+}
+BENCHMARK(BM_StringPoolDecodeModifiedUtf8)->Arg(0)->Arg(1);
+
+static void BM_StringPoolEncodeUtf8Generic(benchmark::State& state) {
+  StringPoolStrings strings = LoadStrings(state);
+  std::vector<char> out(3 * strings.max_length + 1);
+  for (auto&& _ : state) {
+    for (const std::u16string& str : strings.utf16) {
+      ssize_t len = utf16_to_utf8_length(str.data(), str.size());
+      utf16_to_utf8(str.data(), str.size(), out.data(), len + 1);
+      benchmark::DoNotOptimize(out.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * strings.utf16.size());
+}
+BENCHMARK(BM_StringPoolEncodeUtf8Generic)->Arg(0)->Arg(1);
+
+static void BM_StringPoolEncodeModifiedUtf8(benchmark::State& state) {
+  StringPoolStrings strings = LoadStrings(state);
+  std::vector<char> out(3 * strings.max_length + 1);
+  for (auto&& _ : state) {
+    for (const std::u16string& str : strings.utf16) {
+      // Measured first, as CharsetUtils does when the destination might be too small.
+      benchmark::DoNotOptimize(util::ModifiedUtf8Length(str.data(), str.size()));
+      benchmark::DoNotOptimize(util::EncodeModifiedUtf8(str.data(), str.size(), out.data()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * strings.utf16.size());
+}
+BENCHMARK(BM_StringPoolEncodeModifiedUtf8)->Arg(0)->Arg(1);
+
+}  // namespace android
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "androidfw/Util.h"
+
+#include <string>
+
+#include "TestHelpers.h"
+
+namespace android {
+namespace util {
+
+static std::string Encode(const std::u16string& utf16) {
+  std::string out(3 * utf16.size(), '\0');
+  out.resize(EncodeModifiedUtf8(utf16.data(), utf16.size(), out.data()) - out.data());
+  EXPECT_EQ(out.size(), ModifiedUtf8Length(utf16.data(), utf16.size()));
+  return out;
+}
+
+static std::u16string Decode(const std::string& utf8) {
+  std::u16string out(utf8.size(), u'\0');
+  ssize_t len = DecodeModifiedUtf8(utf8.data(), utf8.size(), out.data());
+  EXPECT_GE(len, 0);
+  out.resize(len < 0 ? 0 : len);
+  return out;
+}
+
+TEST(UtilTest, AsciiPrefixLengthStopsAtFirstNonAsciiCharacter) {
+  // Long enough that every position is checked both in bulk and one at a time.
+  const std::string ascii = "The quick brown fox jumps over the lazy dog, twice over!";
+  EXPECT_EQ(ascii.size(), AsciiPrefixLength(ascii.data(), ascii.size()));
+  for (size_t i = 0; i < ascii.size(); i++) {
+    for (char c : {'\0', '\x80', '\xff'}) {
+      std::string str = ascii;
+      str[i] = c;
+      EXPECT_EQ(i, AsciiPrefixLength(str.data(), str.size()));
+    }
+  }
+
+  const std::u16string ascii16 = u"The quick brown fox jumps over the lazy dog, twice over!";
+  EXPECT_EQ(ascii16.size(), AsciiPrefixLength(ascii16.data(), ascii16.size()));
+  for (size_t i = 0; i < ascii16.size(); i++) {
+    for (char16_t c : {u'\0', u'\x80', u'\x100', u'\xd800', u'\xffff'}) {
+      std::u16string str = ascii16;
+      str[i] = c;
+      EXPECT_EQ(i, AsciiPrefixLength(str.data(), str.size()));
+    }
+  }
+}
+
+TEST(UtilTest, EncodeModifiedUtf8) {
+  EXPECT_EQ("", Encode(u""));
+  EXPECT_EQ("hello, world", Encode(u"hello, world"));
+  EXPECT_EQ(std::string("a\xc0\x80z", 4), Encode(std::u16string(u"a\0z", 3)));
+  EXPECT_EQ("caf\xc3\xa9 \xe2\x82\xac", Encode(u"café €"));
+  // A pair is one four byte sequence, but a lone surrogate is encoded on its own.
+  EXPECT_EQ("\xf0\x9f\x98\x80!", Encode(u"\U0001f600!"));
+  EXPECT_EQ("\xed\xa0\xbd!", Encode(u"\xd83d!"));
+  EXPECT_EQ("\xed\xb8\x80", Encode(u"\xde00"));
+}
+
+TEST(UtilTest, DecodeModifiedUtf8) {
+  EXPECT_EQ(u"hello, world", Decode("hello, world"));
+  EXPECT_EQ(std::u16string(u"a\0z", 3), Decode(std::string("a\xc0\x80z", 4)));
+  EXPECT_EQ(u"café €", Decode("caf\xc3\xa9 \xe2\x82\xac"));
+  EXPECT_EQ(u"\U0001f600!", Decode("\xf0\x9f\x98\x80!"));
+  // CESU-8 style pairs decode to the same surrogates.
+  EXPECT_EQ(u"\U0001f600", Decode("\xed\xa0\xbd\xed\xb8\x80"));
+  // Decoding stops at a NUL byte, like NewStringUTF.
+  EXPECT_EQ(u"ab", Decode(std::string("ab\0cd", 5)));
+
+  char16_t out[8];
+  EXPECT_EQ(-1, DecodeModifiedUtf8("\x80", 1, out));
+  EXPECT_EQ(-1, DecodeModifiedUtf8("\xc3", 1, out));
+  EXPECT_EQ(-1, DecodeModifiedUtf8("\xe2\x82", 2, out));
+  EXPECT_EQ(-1, DecodeModifiedUtf8("\xe2\x28\xa1", 3, out));
+  EXPECT_EQ(-1, DecodeModifiedUtf8("\xf4\x90\x80\x80", 4, out));
+  EXPECT_EQ(-1, DecodeModifiedUtf8("\xff", 1, out));
+}
+
+TEST(UtilTest, ModifiedUtf8RoundTrips) {
+  std::u16string str;
+  for (char16_t c = 1; c < 0x1000; c += 7) {
+    str += u"ascii run ";
+    str += c;
+  }
+  str += u"\U0001f600\U00010000\U0010ffff";
+  EXPECT_EQ(str, Decode(Encode(str)));
+}
+
+}  // namespace util
+}  // namespace android
@@ -57,6 +57,7 @@ void BaseRenderNodeAnimator::checkMutable() {
 void BaseRenderNodeAnimator::setInterpolator(Interpolator* interpolator) {
     checkMutable();
     mInterpolator.reset(interpolator);
+    mInterpolatorLUT.reset();
 }
 
 void BaseRenderNodeAnimator::setStartValue(float value) {
@@ -165,6 +166,9 @@ void BaseRenderNodeAnimator::pushStaging(AnimationContext& context) {
         if (mPlayState == PlayState::NotStarted && !mInterpolator) {
             mInterpolator.reset(Interpolator::createDefaultInterpolator());
         }
+        if (mPlayState == PlayState::NotStarted && !mInterpolatorLUT) {
+            mInterpolatorLUT = InterpolatorLUT::compile(*mInterpolator);
+        }
         // Keep track of the play state and play time before they are changed when
         // staging requests are resolved.
         nsecs_t currentPlayTime = mPlayTime;
@@ -231,34 +235,64 @@ void BaseRenderNodeAnimator::transitionToRunning(AnimationContext& context) {
 }
 
 bool BaseRenderNodeAnimator::animate(AnimationContext& context) {
+    float fraction;
+    bool finished;
+    if (beginAnimate(context, &fraction, &finished)) {
+        endAnimate(context, interpolate(fraction), finished);
+    }
+    return finished;
+}
+
+bool BaseRenderNodeAnimator::beginAnimate(AnimationContext& context, float* outFraction,
+                                          bool* outFinished) {
+    *outFinished = false;
     if (mPlayState < PlayState::Running) {
         return false;
     }
     if (mPlayState == PlayState::Finished) {
-        if (mPendingActionUponFinish == Action::Reset) {
+        const Action pendingAction = mPendingActionUponFinish;
+        // Reset pending action.
+        mPendingActionUponFinish = Action::None;
+        *outFinished = true;
+        // The skip is written by endAnimate(), so that it lands after the values of the
+        // animators batched before this one.
+        if (pendingAction == Action::Reset) {
             // Skip to start.
-            updatePlayTime(0);
-        } else if (mPendingActionUponFinish == Action::End) {
+            return beginPlayTime(0, outFraction);
+        } else if (pendingAction == Action::End) {
             // Skip to end.
-            updatePlayTime(mDuration);
+            return beginPlayTime(mDuration, outFraction);
         }
-        // Reset pending action.
-        mPendingActionUponFinish = Action::None;
-        return true;
+        return false;
     }
 
     // This should be set before setValue() so animators can query this time when setValue
     // is called.
     nsecs_t currentPlayTime = context.frameTimeMs() - mStartTime;
-    bool finished = updatePlayTime(currentPlayTime);
+    if (!beginPlayTime(currentPlayTime, outFraction)) {
+        return false;
+    }
+    *outFinished = currentPlayTime >= mDuration;
+    return true;
+}
+
+void BaseRenderNodeAnimator::endAnimate(AnimationContext& context, float interpolatedFraction,
+                                        bool finished) {
+    setValue(mTarget, mFromValue + (mDeltaValue * interpolatedFraction));
     if (finished && mPlayState != PlayState::Finished) {
         mPlayState = PlayState::Finished;
         callOnFinishedListener(context);
     }
-    return finished;
 }
 
-bool BaseRenderNodeAnimator::updatePlayTime(nsecs_t playTime) {
+float BaseRenderNodeAnimator::interpolate(float fraction) {
+    return mInterpolatorLUT ? mInterpolatorLUT->evaluate(fraction)
+                            : mInterpolator->interpolate(fraction);
+}
+
+// Advances to playTime and computes the fraction to interpolate, or returns false if the
+// animation has not reached its start yet.
+bool BaseRenderNodeAnimator::beginPlayTime(nsecs_t playTime, float* outFraction) {
     mPlayTime = mPlayState == PlayState::Reversing ? mDuration - playTime : playTime;
     onPlayTimeChanged(mPlayTime);
     // If BaseRenderNodeAnimator is handling the delay (not typical), then
@@ -276,12 +310,8 @@ bool BaseRenderNodeAnimator::updatePlayTime(nsecs_t playTime) {
     if ((mPlayState == PlayState::Running || mPlayState == PlayState::Reversing) && mDuration > 0) {
         fraction = mPlayTime / (float)mDuration;
     }
-    fraction = MathUtils::clamp(fraction, 0.0f, 1.0f);
-
-    fraction = mInterpolator->interpolate(fraction);
-    setValue(mTarget, mFromValue + (mDeltaValue * fraction));
-
-    return playTime >= mDuration;
+    *outFraction = MathUtils::clamp(fraction, 0.0f, 1.0f);
+    return true;
 }
 
 nsecs_t BaseRenderNodeAnimator::getRemainingPlayTime() {
@@ -34,6 +34,7 @@ namespace uirenderer {
 class AnimationContext;
 class BaseRenderNodeAnimator;
 class Interpolator;
+class InterpolatorLUT;
 class RenderNode;
 class RenderProperties;
 
@@ -80,6 +81,19 @@ public:
     void pushStaging(AnimationContext& context);
     bool animate(AnimationContext& context);
 
+    // animate() split in two, so that AnimatorManager can interpolate all of a node's animators in
+    // one batch. If beginAnimate() returns true, the caller must follow up with
+    // endAnimate(context, interpolate(*outFraction), *outFinished); otherwise the frame is done and
+    // *outFinished is what animate() would have returned. beginAnimate() never writes the target,
+    // so the caller decides the order in which the values of several animators land.
+    bool beginAnimate(AnimationContext& context, float* outFraction, bool* outFinished);
+    void endAnimate(AnimationContext& context, float interpolatedFraction, bool finished);
+    float interpolate(float fraction);
+    // Set once the animator has started, if its interpolator could be tabulated.
+    const InterpolatorLUT* interpolatorLUT() const { return mInterpolatorLUT.get(); }
+    // Without a start value, beginAnimate() reads the current value from the target.
+    bool hasStartValue() const { return mHasStartValue; }
+
     // Returns the remaining time in ms for the animation. Note this should only be called during
     // an animation on RenderThread.
     nsecs_t getRemainingPlayTime();
@@ -143,6 +157,7 @@ protected:
     float mFromValue;
 
     std::unique_ptr<Interpolator> mInterpolator;
+    std::shared_ptr<const InterpolatorLUT> mInterpolatorLUT;
     PlayState mStagingPlayState;
     PlayState mPlayState;
     bool mHasStartValue;
@@ -172,7 +187,7 @@ private:
     inline void checkMutable();
     virtual void transitionToRunning(AnimationContext& context);
     void doSetStartValue(float value);
-    bool updatePlayTime(nsecs_t playTime);
+    bool beginPlayTime(nsecs_t playTime, float* outFraction);
     void resolveStagingRequest(Request request);
 
     std::vector<Request> mStagingRequests;
@@ -15,11 +15,14 @@
  */
 #include "AnimatorManager.h"
 
+#include <ui/FatVector.h>
+
 #include <algorithm>
 
 #include "AnimationContext.h"
 #include "Animator.h"
 #include "DamageAccumulator.h"
+#include "Interpolator.h"
 #include "RenderNode.h"
 
 namespace android {
@@ -101,33 +104,6 @@ void AnimatorManager::onAnimatorTargetChanged(BaseRenderNodeAnimator* animator)
     mAnimators.erase(std::remove(mAnimators.begin(), mAnimators.end(), animator), mAnimators.end());
 }
 
-class AnimateFunctor {
-public:
-    AnimateFunctor(TreeInfo& info, AnimationContext& context, uint32_t* outDirtyMask)
-            : mInfo(info), mContext(context), mDirtyMask(outDirtyMask) {}
-
-    bool operator()(sp<BaseRenderNodeAnimator>& animator) {
-        *mDirtyMask |= animator->dirtyMask();
-        bool remove = animator->animate(mContext);
-        if (remove) {
-            animator->detach();
-        } else {
-            if (animator->isRunning()) {
-                mInfo.out.hasAnimations = true;
-            }
-            if (CC_UNLIKELY(!animator->mayRunAsync())) {
-                mInfo.out.requiresUiRedraw = true;
-            }
-        }
-        return remove;
-    }
-
-private:
-    TreeInfo& mInfo;
-    AnimationContext& mContext;
-    uint32_t* mDirtyMask;
-};
-
 uint32_t AnimatorManager::animate(TreeInfo& info) {
     if (!mAnimators.size()) return 0;
 
@@ -149,11 +125,82 @@ void AnimatorManager::animateNoDamage(TreeInfo& info) {
     animateCommon(info);
 }
 
+// Animators that are mid-flight, collected so that their interpolators are evaluated together.
+class AnimateBatch {
+public:
+    explicit AnimateBatch(AnimationContext& context) : mContext(context) {}
+
+    void add(BaseRenderNodeAnimator* animator, float fraction, bool finished) {
+        mAnimators.push_back(animator);
+        mLUTs.push_back(animator->interpolatorLUT());
+        mFractions.push_back(fraction);
+        mFinished.push_back(finished);
+    }
+
+    void flush() {
+        const size_t count = mAnimators.size();
+        InterpolatorLUT::evaluateAll(mLUTs.data(), mFractions.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            BaseRenderNodeAnimator* animator = mAnimators[i];
+            const float interpolated =
+                    mLUTs[i] ? mFractions[i] : animator->interpolate(mFractions[i]);
+            animator->endAnimate(mContext, interpolated, mFinished[i]);
+        }
+        mAnimators.clear();
+        mLUTs.clear();
+        mFractions.clear();
+        mFinished.clear();
+    }
+
+private:
+    AnimationContext& mContext;
+    FatVector<BaseRenderNodeAnimator*, 16> mAnimators;
+    FatVector<const InterpolatorLUT*, 16> mLUTs;
+    FatVector<float, 16> mFractions;
+    FatVector<uint8_t, 16> mFinished;
+};
+
 uint32_t AnimatorManager::animateCommon(TreeInfo& info) {
+    AnimationContext& context = mAnimationHandle->context();
     uint32_t dirtyMask = 0;
-    AnimateFunctor functor(info, mAnimationHandle->context(), &dirtyMask);
-    auto newEnd = std::remove_if(mAnimators.begin(), mAnimators.end(), functor);
-    mAnimators.erase(newEnd, mAnimators.end());
+    FatVector<uint8_t, 16> finished(mAnimators.size());
+    AnimateBatch batch(context);
+    for (size_t i = 0; i < mAnimators.size(); i++) {
+        BaseRenderNodeAnimator* animator = mAnimators[i].get();
+        dirtyMask |= animator->dirtyMask();
+        if (!animator->hasStartValue()) {
+            // Its start value is read from the target, which must include the values set by the
+            // animators before it.
+            batch.flush();
+        }
+        float fraction;
+        bool isFinished;
+        if (animator->beginAnimate(context, &fraction, &isFinished)) {
+            batch.add(animator, fraction, isFinished);
+        }
+        finished[i] = isFinished;
+    }
+    batch.flush();
+
+    size_t kept = 0;
+    for (size_t i = 0; i < mAnimators.size(); i++) {
+        sp<BaseRenderNodeAnimator>& animator = mAnimators[i];
+        if (finished[i]) {
+            animator->detach();
+            continue;
+        }
+        if (animator->isRunning()) {
+            info.out.hasAnimations = true;
+        }
+        if (CC_UNLIKELY(!animator->mayRunAsync())) {
+            info.out.requiresUiRedraw = true;
+        }
+        if (kept != i) {
+            mAnimators[kept] = std::move(animator);
+        }
+        kept++;
+    }
+    mAnimators.resize(kept);
     mAnimationHandle->notifyAnimationsRan();
     mParent.mProperties.updateMatrix();
     return dirtyMask;
@@ -112,7 +112,7 @@ void DamageAccumulator::popTransform() {
             applyMatrix4Transform(dirtyFrame);
             break;
         case TransformNone:
-            mHead->pendingDirty.join(dirtyFrame->pendingDirty);
+            joinDirty(dirtyFrame->pendingDirty);
             break;
         default:
             LOG_ALWAYS_FATAL("Tried to pop an invalid type: %d", dirtyFrame->type);
@@ -121,20 +121,37 @@ void DamageAccumulator::popTransform() {
 
 static inline void mapRect(const Matrix4* matrix, const SkRect& in, SkRect* out) {
     if (in.isEmpty()) return;
-    Rect temp(in);
-    if (CC_LIKELY(!matrix->isPerspective())) {
-        matrix->mapRect(temp);
-    } else {
+    const float* data = matrix->data;
+    if (CC_LIKELY(matrix->isPureTranslate())) {
+        // Nearly every transform in a view hierarchy is just a position or scroll offset
+        out->join(in.makeOffset(data[Matrix4::kTranslateX], data[Matrix4::kTranslateY]));
+        return;
+    }
+    if (CC_UNLIKELY(matrix->isPerspective())) {
         // Don't attempt to calculate damage for a perspective transform
         // as the numbers this works with can break the perspective
         // calculations. Just give up and expand to DIRTY_MIN/DIRTY_MAX
-        temp.set(DIRTY_MIN, DIRTY_MIN, DIRTY_MAX, DIRTY_MAX);
+        out->join(SkRect::MakeLTRB(DIRTY_MIN, DIRTY_MIN, DIRTY_MAX, DIRTY_MAX));
+        return;
+    }
+    if (matrix->isSimple()) {
+        Rect temp(in);
+        matrix->mapRect(temp);
+        out->join({RECT_ARGS(temp)});
+        return;
     }
-    out->join({RECT_ARGS(temp)});
+    // Rotations and skews: SkMatrix maps all four corners at once with SIMD rather than one
+    // at a time like Matrix4::mapRect
+    const SkMatrix affine = SkMatrix::MakeAll(
+            data[Matrix4::kScaleX], data[Matrix4::kSkewX], data[Matrix4::kTranslateX],
+            data[Matrix4::kSkewY], data[Matrix4::kScaleY], data[Matrix4::kTranslateY], 0, 0, 1);
+    out->join(affine.mapRect(in));
 }
 
 void DamageAccumulator::applyMatrix4Transform(DirtyStack* frame) {
-    mapRect(frame->matrix4, frame->pendingDirty, &mHead->pendingDirty);
+    SkRect mapped = SkRect::MakeEmpty();
+    mapRect(frame->matrix4, frame->pendingDirty, &mapped);
+    joinDirty(mapped);
 }
 
 static inline void applyMatrix(const SkMatrix* transform, SkRect* rect) {
@@ -157,6 +174,18 @@ static inline void applyMatrix(const SkMatrix& transform, SkRect* rect) {
 static inline void mapRect(const RenderProperties& props, const SkRect& in, SkRect* out) {
     if (in.isEmpty()) return;
     SkRect temp(in);
+    const SkMatrix* transform = props.getTransformMatrix();
+    if (CC_LIKELY((!transform || transform->isTranslate()) && !props.getStaticMatrix() &&
+                  !props.getAnimationMatrix() &&
+                  props.layerProperties().getStretchEffect().isEmpty())) {
+        // Only translated, so skip the matrix classification and mapping below
+        if (transform) {
+            temp.offset(transform->getTranslateX(), transform->getTranslateY());
+        }
+        temp.offset(props.getLeft(), props.getTop());
+        out->join(temp);
+        return;
+    }
     if (Properties::getStretchEffectBehavior() == StretchEffectBehavior::UniformScale) {
         const StretchEffect& stretch = props.layerProperties().getStretchEffect();
         if (!stretch.isEmpty()) {
@@ -225,7 +254,9 @@ void DamageAccumulator::applyRenderNodeTransform(DirtyStack* frame) {
     }
 
     // apply all transforms
-    mapRect(props, frame->pendingDirty, &mHead->pendingDirty);
+    SkRect mapped = SkRect::MakeEmpty();
+    mapRect(props, frame->pendingDirty, &mapped);
+    joinDirty(mapped);
 
     // project backwards if necessary
     if (props.getProjectBackwards() && !frame->pendingDirty.isEmpty()) {
@@ -284,7 +315,53 @@ SkRect DamageAccumulator::computeClipAndTransform(const SkRect& bounds, Matrix4*
 }
 
 void DamageAccumulator::dirty(float left, float top, float right, float bottom) {
-    mHead->pendingDirty.join({left, top, right, bottom});
+    joinDirty({left, top, right, bottom});
+}
+
+void DamageAccumulator::joinDirty(const SkRect& rect) {
+    mHead->pendingDirty.join(rect);
+    if (CC_UNLIKELY(mTrackDamageRects) && mHead->prev == mHead) {
+        addDamageRect(rect);
+    }
+}
+
+static float area(const SkRect& rect) {
+    return rect.width() * rect.height();
+}
+
+void DamageAccumulator::addDamageRect(SkRect rect) {
+    if (rect.isEmpty()) return;
+    rect.roundOut(&rect);
+    // Overlapping rects would be redrawn twice, so fold everything rect touches into it. Merging
+    // can make it touch rects it did not before, hence starting over after each merge.
+    for (size_t i = 0; i < mDamageRects.size();) {
+        if (mDamageRects[i].contains(rect)) return;
+        if (SkRect::Intersects(mDamageRects[i], rect)) {
+            rect.join(mDamageRects[i]);
+            mDamageRects.erase(mDamageRects.begin() + i);
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    if (mDamageRects.size() < kMaxDamageRects) {
+        mDamageRects.push_back(rect);
+        return;
+    }
+    size_t cheapest = 0;
+    float cheapestCost = SK_FloatInfinity;
+    for (size_t i = 0; i < mDamageRects.size(); i++) {
+        SkRect merged = mDamageRects[i];
+        merged.join(rect);
+        const float cost = area(merged) - area(mDamageRects[i]) - area(rect);
+        if (cost < cheapestCost) {
+            cheapest = i;
+            cheapestCost = cost;
+        }
+    }
+    rect.join(mDamageRects[cheapest]);
+    mDamageRects.erase(mDamageRects.begin() + cheapest);
+    addDamageRect(rect);
 }
 
 void DamageAccumulator::peekAtDirty(SkRect* dest) const {
@@ -298,6 +375,15 @@ void DamageAccumulator::finish(SkRect* totalDirty) {
     *totalDirty = mHead->pendingDirty;
     totalDirty->roundOut(totalDirty);
     mHead->pendingDirty.setEmpty();
+    mDamageRects.clear();
+}
+
+void DamageAccumulator::finish(SkRect* totalDirty, DamageRects* damageRects) {
+    damageRects->clear();
+    if (mTrackDamageRects) {
+        damageRects->insert(damageRects->end(), mDamageRects.begin(), mDamageRects.end());
+    }
+    finish(totalDirty);
 }
 
 DamageAccumulator::StretchResult DamageAccumulator::findNearestStretchEffect() const {
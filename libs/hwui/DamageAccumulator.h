@@ -22,6 +22,7 @@
 #include <SkMatrix.h>
 #include <SkRect.h>
 #include <effects/StretchEffect.h>
+#include <ui/FatVector.h>
 
 #include "utils/Macros.h"
 
@@ -41,6 +42,10 @@ class DamageAccumulator {
     PREVENT_COPY_AND_ASSIGN(DamageAccumulator);
 
 public:
+    // Most frames damage one or two unrelated areas, e.g. a ripple and a clock.
+    static constexpr size_t kMaxDamageRects = 4;
+    using DamageRects = FatVector<SkRect, kMaxDamageRects>;
+
     DamageAccumulator();
     // mAllocator will clean everything up for us, no need for a dtor
 
@@ -65,6 +70,16 @@ public:
 
     void finish(SkRect* totalDirty);
 
+    // When enabled, damage that reaches the root is also kept as up to kMaxDamageRects rects
+    // instead of only their union, so that the surface damage reported on swap does not cover
+    // everything in between several disjoint changes. Overlapping rects are merged, and once
+    // the limit is reached the pair whose union adds the least area is merged.
+    void setTrackDamageRects(bool track) { mTrackDamageRects = track; }
+
+    // As finish(SkRect*), also returning the separate damage rects if tracking is enabled. The
+    // rects are rounded out like totalDirty, and their union is totalDirty.
+    void finish(SkRect* totalDirty, DamageRects* damageRects);
+
     struct StretchResult {
         /**
          * Stretch parameters configured on the stretch container
@@ -93,9 +108,13 @@ private:
     void pushCommon();
     void applyMatrix4Transform(DirtyStack* frame);
     void applyRenderNodeTransform(DirtyStack* frame);
+    void joinDirty(const SkRect& rect);
+    void addDamageRect(SkRect rect);
 
     LinearAllocator mAllocator;
     DirtyStack* mHead;
+    bool mTrackDamageRects = false;
+    DamageRects mDamageRects;
 };
 
 } /* namespace uirenderer */
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "pipeline/skia/DisplayListPool.h"
 #include "pipeline/skia/SkiaDisplayList.h"
 #include "canvas/CanvasOpBuffer.h"
 
@@ -39,9 +40,12 @@ public:
     explicit SkiaDisplayListWrapper(std::unique_ptr<skiapipeline::SkiaDisplayList> impl)
         : mImpl(std::move(impl)) {}
 
+    ~SkiaDisplayListWrapper() { releaseImpl(); }
+
     // Move support
     SkiaDisplayListWrapper(SkiaDisplayListWrapper&& other) : mImpl(std::move(other.mImpl)) {}
     SkiaDisplayListWrapper& operator=(SkiaDisplayListWrapper&& other) {
+        releaseImpl();
         mImpl = std::move(other.mImpl);
         return *this;
     }
@@ -100,7 +104,7 @@ public:
             // Do something to cleanup reuseDisplayList passing itself to the RenderNode
             mImpl.release();
         } else {
-            mImpl = nullptr;
+            releaseImpl();
         }
     }
 
@@ -154,6 +158,13 @@ public:
     }
 
 private:
+    // Dropped lists go back to the pool so their storage can be reused by another node.
+    void releaseImpl() {
+        if (mImpl) {
+            skiapipeline::DisplayListPool::getInstance().release(std::move(mImpl));
+        }
+    }
+
     std::unique_ptr<skiapipeline::SkiaDisplayList> mImpl;
 };
 
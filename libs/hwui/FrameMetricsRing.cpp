@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameMetricsRing.h"
+
+#include <cutils/ashmem.h>
+#include <log/log.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace android {
+namespace uirenderer {
+
+static constexpr uint32_t kMagic = 0x464d5231;  // 'FMR1'
+static constexpr uint32_t kVersion = 1;
+// A couple of seconds at 120Hz is plenty for a client polling once a second.
+static constexpr uint32_t kMaxCapacity = 1024;
+static constexpr int kHistogramReadAttempts = 4;
+
+namespace {
+
+struct Record {
+    // 2 * index + 1 while frame 'index' is being written, 2 * index + 2 once it is complete.
+    std::atomic<uint64_t> seq;
+    std::atomic<int64_t> data[FrameMetricsRing::kRecordWords];
+};
+
+}  // namespace
+
+struct FrameMetricsRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordWords;
+    uint32_t capacity;
+    // Number of frames ever written; frame i lives in records[i % capacity].
+    std::atomic<uint64_t> writeIndex;
+    // Odd while the histogram is being updated.
+    std::atomic<uint32_t> histogramSeq;
+    uint32_t reserved;
+    ProfileData histogram;
+
+    Record* records() {
+        return reinterpret_cast<Record*>(reinterpret_cast<uint8_t*>(this) + recordsOffset());
+    }
+    const Record* records() const { return const_cast<Header*>(this)->records(); }
+
+    static constexpr size_t recordsOffset() {
+        return (sizeof(Header) + alignof(Record) - 1) & ~(alignof(Record) - 1);
+    }
+};
+
+size_t FrameMetricsRing::sizeForCapacity(uint32_t capacity) {
+    return Header::recordsOffset() + sizeof(Record) * capacity;
+}
+
+sp<FrameMetricsRing> FrameMetricsRing::create(uint32_t capacity, bool waitForPresentTime) {
+    capacity = std::clamp(capacity, 1u, kMaxCapacity);
+    const size_t size = sizeForCapacity(capacity);
+    base::unique_fd fd(ashmem_create_region("FrameMetricsRing", size));
+    if (fd.get() < 0) {
+        ALOGW("FrameMetricsRing: failed to create region: %s", strerror(errno));
+        return nullptr;
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+    if (base == MAP_FAILED) {
+        ALOGW("FrameMetricsRing: failed to map region: %s", strerror(errno));
+        return nullptr;
+    }
+    // Our mapping stays writable; anyone mapping the fd from now on only gets to read.
+    if (ashmem_set_prot_region(fd.get(), PROT_READ) < 0) {
+        ALOGW("FrameMetricsRing: failed to make region read-only: %s", strerror(errno));
+        munmap(base, size);
+        return nullptr;
+    }
+
+    Header* header = new (base) Header();
+    header->magic = kMagic;
+    header->version = kVersion;
+    header->recordWords = kRecordWords;
+    header->capacity = capacity;
+    for (uint32_t i = 0; i < capacity; i++) {
+        new (&header->records()[i]) Record();
+    }
+    return sp<FrameMetricsRing>(
+            new FrameMetricsRing(waitForPresentTime, std::move(fd), base, size));
+}
+
+FrameMetricsRing::FrameMetricsRing(bool waitForPresentTime, base::unique_fd fd, void* base,
+                                   size_t size)
+        : FrameMetricsObserver(waitForPresentTime)
+        , mFd(std::move(fd))
+        , mBase(base)
+        , mSize(size)
+        , mHeader(static_cast<Header*>(base)) {}
+
+FrameMetricsRing::~FrameMetricsRing() {
+    munmap(mBase, mSize);
+}
+
+void FrameMetricsRing::notify(const int64_t* buffer) {
+    const uint64_t index = mHeader->writeIndex.load(std::memory_order_relaxed);
+    Record& record = mHeader->records()[index % mHeader->capacity];
+    record.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < kRecordWords; i++) {
+        record.data[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    record.seq.store(2 * index + 2, std::memory_order_release);
+    mHeader->writeIndex.store(index + 1, std::memory_order_release);
+
+    // Same accounting as JankTracker::finishFrame. The deadline has already been adjusted for
+    // buffer stuffing by the time observers see the frame.
+    auto get = [buffer](FrameInfoIndex field) { return buffer[static_cast<int>(field)]; };
+    const int64_t totalDuration =
+            get(FrameInfoIndex::FrameCompleted) - get(FrameInfoIndex::IntendedVsync);
+    const int64_t gpuCompleted = get(FrameInfoIndex::GpuCompleted);
+
+    const uint32_t seq = mHeader->histogramSeq.load(std::memory_order_relaxed);
+    mHeader->histogramSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ProfileData& histogram = mHeader->histogram;
+    if (totalDuration > 0) {
+        histogram.reportFrame(totalDuration);
+    }
+    if (gpuCompleted >= get(FrameInfoIndex::FrameDeadline)) {
+        histogram.reportJank();
+        histogram.reportJankType(JankType::kMissedDeadline);
+    }
+    if (gpuCompleted > 0) {
+        histogram.reportGPUFrame(gpuCompleted - get(FrameInfoIndex::SwapBuffers));
+    }
+    mHeader->histogramSeq.store(seq + 2, std::memory_order_release);
+}
+
+FrameMetricsRing::Reader::Reader(const void* base, size_t size) {
+    if (base == nullptr || size < sizeof(Header)) {
+        return;
+    }
+    const Header* header = static_cast<const Header*>(base);
+    if (header->magic != kMagic || header->version != kVersion ||
+        header->recordWords != static_cast<uint32_t>(kRecordWords) || header->capacity == 0 ||
+        sizeForCapacity(header->capacity) > size) {
+        return;
+    }
+    mHeader = header;
+}
+
+uint64_t FrameMetricsRing::Reader::framesWritten() const {
+    return mHeader ? mHeader->writeIndex.load(std::memory_order_acquire) : 0;
+}
+
+size_t FrameMetricsRing::Reader::read(uint64_t* cursor, int64_t* out, size_t maxRecords,
+                                      uint64_t* dropped) const {
+    if (!mHeader) {
+        return 0;
+    }
+    const uint64_t written = mHeader->writeIndex.load(std::memory_order_acquire);
+    const uint32_t capacity = mHeader->capacity;
+    if (*cursor > written) {
+        *cursor = written;
+    }
+    if (written - *cursor > capacity) {
+        *dropped += written - capacity - *cursor;
+        *cursor = written - capacity;
+    }
+
+    size_t count = 0;
+    const Record* records = mHeader->records();
+    for (; *cursor < written && count < maxRecords; (*cursor)++) {
+        const Record& record = records[*cursor % capacity];
+        const uint64_t expected = 2 * *cursor + 2;
+        if (record.seq.load(std::memory_order_acquire) != expected) {
+            // Already being overwritten by a later frame.
+            (*dropped)++;
+            continue;
+        }
+        int64_t* dest = out + count * kRecordWords;
+        for (int i = 0; i < kRecordWords; i++) {
+            dest[i] = record.data[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (record.seq.load(std::memory_order_relaxed) != expected) {
+            (*dropped)++;
+            continue;
+        }
+        count++;
+    }
+    return count;
+}
+
+bool FrameMetricsRing::Reader::readHistogram(ProfileData* out) const {
+    if (!mHeader) {
+        return false;
+    }
+    for (int attempt = 0; attempt < kHistogramReadAttempts; attempt++) {
+        const uint32_t seq = mHeader->histogramSeq.load(std::memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        memcpy(static_cast<void*>(out), &mHeader->histogram, sizeof(ProfileData));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (mHeader->histogramSeq.load(std::memory_order_relaxed) == seq) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace uirenderer
+}  // namespace android
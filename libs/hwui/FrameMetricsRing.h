@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <android-base/unique_fd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "FrameInfo.h"
+#include "FrameMetricsObserver.h"
+#include "ProfileData.h"
+
+namespace android {
+namespace uirenderer {
+
+/**
+ * A FrameMetricsObserver that appends every frame's FrameInfo to a ring buffer in shared memory,
+ * and aggregates the frames into a ProfileData histogram stored alongside it.
+ *
+ * Unlike HardwareRendererObserver, nothing is called back per frame. Clients read whatever
+ * accumulated since their last read, in bulk and on their own schedule, through a Reader over any
+ * mapping of the region. The region is made read-only for everyone but the writer, so the fd can
+ * be handed to other processes.
+ *
+ * There is exactly one writer, the thread the FrameMetricsReporter notifies on. Readers never
+ * block it: each record and the histogram carry a sequence counter, and a reader that overlaps
+ * with a write retries or reports the record as dropped.
+ */
+class FrameMetricsRing : public FrameMetricsObserver {
+    struct Header;
+
+public:
+    static constexpr int kRecordWords = static_cast<int>(FrameInfoIndex::NumIndexes);
+
+    static sp<FrameMetricsRing> create(uint32_t capacity, bool waitForPresentTime);
+    ~FrameMetricsRing() override;
+
+    void notify(const int64_t* buffer) override;
+
+    // The shared memory region. Owned by the ring; dup it to hand it out.
+    int getFd() const { return mFd.get(); }
+    size_t getSize() const { return mSize; }
+    const void* getMapping() const { return mBase; }
+
+    static size_t sizeForCapacity(uint32_t capacity);
+
+    class Reader {
+    public:
+        Reader(const void* base, size_t size);
+
+        // False if the mapping does not hold a ring of a layout this Reader understands.
+        bool isValid() const { return mHeader != nullptr; }
+
+        /**
+         * Copies up to maxRecords frames, starting at *cursor, into out (kRecordWords each) and
+         * advances *cursor past them. Frames that were overwritten before they could be read are
+         * skipped and added to *dropped. Returns the number of frames copied.
+         *
+         * Start with *cursor = 0 to read everything still in the ring.
+         */
+        size_t read(uint64_t* cursor, int64_t* out, size_t maxRecords, uint64_t* dropped) const;
+
+        // Copies a consistent snapshot of the histogram. Returns false if the writer kept
+        // updating it for every attempt.
+        bool readHistogram(ProfileData* out) const;
+
+        uint64_t framesWritten() const;
+
+    private:
+        const Header* mHeader = nullptr;
+    };
+
+private:
+    FrameMetricsRing(bool waitForPresentTime, base::unique_fd fd, void* base, size_t size);
+
+    base::unique_fd mFd;
+    void* mBase;
+    size_t mSize;
+    Header* mHeader;
+};
+
+}  // namespace uirenderer
+}  // namespace android
@@ -40,6 +40,7 @@
 #include "renderthread/EglManager.h"
 #include "renderthread/VulkanManager.h"
 #include "thread/ThreadBase.h"
+#include "utils/EventTrace.h"
 #include "utils/TimeUtils.h"
 
 namespace android::uirenderer {
@@ -416,6 +417,7 @@ static void createUploader(bool usingGL) {
 
 sk_sp<Bitmap> HardwareBitmapUploader::allocateHardwareBitmap(const SkBitmap& sourceBitmap) {
     ATRACE_CALL();
+    HWUI_EVENT_SCOPE("HardwareBitmapUploader::allocateHardwareBitmap");
 
     bool usingGL = uirenderer::Properties::getRenderPipelineType() ==
             uirenderer::RenderPipelineType::SkiaGL;
@@ -17,6 +17,10 @@
 #include "Interpolator.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
 
 #include <log/log.h>
 
@@ -25,6 +29,26 @@
 namespace android {
 namespace uirenderer {
 
+// First element of every curve key, so curves of different types never share a table.
+enum class CurveType {
+    AccelerateDecelerate = 1,
+    Accelerate,
+    Anticipate,
+    AnticipateOvershoot,
+    Cycle,
+    Decelerate,
+    Overshoot,
+    Path,
+};
+
+static bool setCurveKey(std::vector<float>* key, CurveType type,
+                        std::initializer_list<float> params) {
+    key->clear();
+    key->push_back(static_cast<float>(type));
+    key->insert(key->end(), params);
+    return true;
+}
+
 Interpolator* Interpolator::createDefaultInterpolator() {
     return new AccelerateDecelerateInterpolator();
 }
@@ -33,6 +57,10 @@ float AccelerateDecelerateInterpolator::interpolate(float input) {
     return (float)(cosf((input + 1) * M_PI) / 2.0f) + 0.5f;
 }
 
+bool AccelerateDecelerateInterpolator::getCurveKey(std::vector<float>* key) const {
+    return setCurveKey(key, CurveType::AccelerateDecelerate, {});
+}
+
 float AccelerateInterpolator::interpolate(float input) {
     if (mFactor == 1.0f) {
         return input * input;
@@ -41,10 +69,19 @@ float AccelerateInterpolator::interpolate(float input) {
     }
 }
 
+bool AccelerateInterpolator::getCurveKey(std::vector<float>* key) const {
+    // Below a power of 1 the slope at 0 is unbounded, which linear segments follow poorly.
+    return mDoubleFactor >= 1 && setCurveKey(key, CurveType::Accelerate, {mDoubleFactor});
+}
+
 float AnticipateInterpolator::interpolate(float t) {
     return t * t * ((mTension + 1) * t - mTension);
 }
 
+bool AnticipateInterpolator::getCurveKey(std::vector<float>* key) const {
+    return setCurveKey(key, CurveType::Anticipate, {mTension});
+}
+
 static float a(float t, float s) {
     return t * t * ((s + 1) * t - s);
 }
@@ -60,6 +97,10 @@ float AnticipateOvershootInterpolator::interpolate(float t) {
         return 0.5f * (o(t * 2.0f - 2.0f, mTension) + 2.0f);
 }
 
+bool AnticipateOvershootInterpolator::getCurveKey(std::vector<float>* key) const {
+    return setCurveKey(key, CurveType::AnticipateOvershoot, {mTension});
+}
+
 static float bounce(float t) {
     return t * t * 8.0f;
 }
@@ -80,6 +121,11 @@ float CycleInterpolator::interpolate(float input) {
     return sinf(2 * mCycles * M_PI * input);
 }
 
+bool CycleInterpolator::getCurveKey(std::vector<float>* key) const {
+    // Each cycle needs enough samples to keep its peaks.
+    return std::abs(mCycles) <= 4 && setCurveKey(key, CurveType::Cycle, {mCycles});
+}
+
 float DecelerateInterpolator::interpolate(float input) {
     float result;
     if (mFactor == 1.0f) {
@@ -90,11 +136,20 @@ float DecelerateInterpolator::interpolate(float input) {
     return result;
 }
 
+bool DecelerateInterpolator::getCurveKey(std::vector<float>* key) const {
+    // As for AccelerateInterpolator, the slope at 1 is unbounded below a power of 1.
+    return 2 * mFactor >= 1 && setCurveKey(key, CurveType::Decelerate, {mFactor});
+}
+
 float OvershootInterpolator::interpolate(float t) {
     t -= 1.0f;
     return t * t * ((mTension + 1) * t + mTension) + 1.0f;
 }
 
+bool OvershootInterpolator::getCurveKey(std::vector<float>* key) const {
+    return setCurveKey(key, CurveType::Overshoot, {mTension});
+}
+
 float PathInterpolator::interpolate(float t) {
     if (t <= 0) {
         return 0;
@@ -127,6 +182,15 @@ float PathInterpolator::interpolate(float t) {
     return startY + (fraction * (endY - startY));
 }
 
+bool PathInterpolator::getCurveKey(std::vector<float>* key) const {
+    key->clear();
+    key->reserve(1 + mX.size() + mY.size());
+    key->push_back(static_cast<float>(CurveType::Path));
+    key->insert(key->end(), mX.begin(), mX.end());
+    key->insert(key->end(), mY.begin(), mY.end());
+    return true;
+}
+
 LUTInterpolator::LUTInterpolator(float* values, size_t size) : mValues(values), mSize(size) {}
 
 LUTInterpolator::~LUTInterpolator() {}
@@ -156,5 +220,99 @@ float LUTInterpolator::interpolate(float input) {
     return MathUtils::lerp(v1, v2, weight);
 }
 
+namespace {
+
+struct CurveKeyHash {
+    size_t operator()(const std::vector<float>& key) const {
+        // FNV-1a over the bit patterns; keys are compared exactly, so this only needs to be fast.
+        uint64_t hash = 14695981039346656037ull;
+        for (float value : key) {
+            // Adding 0 turns -0 into 0, which compares equal and so has to hash the same.
+            value += 0.0f;
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            hash = (hash ^ bits) * 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+struct LUTCache {
+    std::mutex lock;
+    std::unordered_map<std::vector<float>, std::weak_ptr<const InterpolatorLUT>, CurveKeyHash>
+            tables;
+};
+
+LUTCache& lutCache() {
+    static LUTCache* sCache = new LUTCache();
+    return *sCache;
+}
+
+}  // namespace
+
+std::shared_ptr<const InterpolatorLUT> InterpolatorLUT::compile(Interpolator& interpolator) {
+    std::vector<float> key;
+    if (!interpolator.getCurveKey(&key)) {
+        return nullptr;
+    }
+    LUTCache& cache = lutCache();
+    std::lock_guard lock(cache.lock);
+    auto& entry = cache.tables[key];
+    if (auto table = entry.lock()) {
+        return table;
+    }
+
+    // Animators are started from the UI thread, so tables come and go; drop the expired entries
+    // whenever a new one is built rather than keeping a weak_ptr per curve ever seen.
+    for (auto it = cache.tables.begin(); it != cache.tables.end();) {
+        if (it->second.expired() && &it->second != &entry) {
+            it = cache.tables.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::shared_ptr<InterpolatorLUT> table(new InterpolatorLUT());
+    for (size_t i = 0; i <= kSize; i++) {
+        table->mValues[i] = interpolator.interpolate(static_cast<float>(i) / kSize);
+    }
+    entry = table;
+    return table;
+}
+
+void InterpolatorLUT::evaluateAll(const InterpolatorLUT* const* luts, float* fractions,
+                                  size_t count) {
+    constexpr size_t kChunk = 64;
+    float positions[kChunk];
+    for (size_t start = 0; start < count; start += kChunk) {
+        const size_t n = std::min(kChunk, count - start);
+        float* chunk = fractions + start;
+        // Branch-free, so this loop is vectorized; only the table lookups below are scalar.
+        for (size_t i = 0; i < n; i++) {
+            positions[i] = std::min(1.0f, std::max(0.0f, chunk[i])) * kSize;
+        }
+        for (size_t i = 0; i < n; i++) {
+            const InterpolatorLUT* lut = luts[start + i];
+            if (lut == nullptr) {
+                continue;
+            }
+            const float position = positions[i];
+            const size_t index = std::min(static_cast<size_t>(position), kSize - 1);
+            const float weight = position - index;
+            chunk[i] = lut->mValues[index] * (1 - weight) + lut->mValues[index + 1] * weight;
+        }
+    }
+}
+
+size_t InterpolatorLUT::cachedCount() {
+    LUTCache& cache = lutCache();
+    std::lock_guard lock(cache.lock);
+    size_t count = 0;
+    for (const auto& [key, table] : cache.tables) {
+        count += table.expired() ? 0 : 1;
+    }
+    return count;
+}
+
 } /* namespace uirenderer */
 } /* namespace android */
@@ -17,6 +17,7 @@
 #define INTERPOLATOR_H
 
 #include <stddef.h>
+#include <algorithm>
 #include <memory>
 
 #include <cutils/compiler.h>
@@ -31,6 +32,11 @@ public:
 
     virtual float interpolate(float input) = 0;
 
+    // Describes this interpolator's curve, so that interpolators with the same curve can share an
+    // InterpolatorLUT. Returns false if the curve should not be tabulated, either because it is
+    // already cheap to compute or because InterpolatorLUT::kSize samples cannot follow it closely.
+    virtual bool getCurveKey(std::vector<float>* key) const { return false; }
+
     static Interpolator* createDefaultInterpolator();
 
 protected:
@@ -40,12 +46,14 @@ protected:
 class AccelerateDecelerateInterpolator : public Interpolator {
 public:
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 };
 
 class AccelerateInterpolator : public Interpolator {
 public:
     explicit AccelerateInterpolator(float factor) : mFactor(factor), mDoubleFactor(factor * 2) {}
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 
 private:
     const float mFactor;
@@ -56,6 +64,7 @@ class AnticipateInterpolator : public Interpolator {
 public:
     explicit AnticipateInterpolator(float tension) : mTension(tension) {}
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 
 private:
     const float mTension;
@@ -65,6 +74,7 @@ class AnticipateOvershootInterpolator : public Interpolator {
 public:
     explicit AnticipateOvershootInterpolator(float tension) : mTension(tension) {}
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 
 private:
     const float mTension;
@@ -72,6 +82,7 @@ private:
 
 class BounceInterpolator : public Interpolator {
 public:
+    // Not tabulated: the corners of its bounces fall between samples.
     virtual float interpolate(float input) override;
 };
 
@@ -79,6 +90,7 @@ class CycleInterpolator : public Interpolator {
 public:
     explicit CycleInterpolator(float cycles) : mCycles(cycles) {}
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 
 private:
     const float mCycles;
@@ -88,6 +100,7 @@ class DecelerateInterpolator : public Interpolator {
 public:
     explicit DecelerateInterpolator(float factor) : mFactor(factor) {}
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 
 private:
     const float mFactor;
@@ -102,6 +115,7 @@ class OvershootInterpolator : public Interpolator {
 public:
     explicit OvershootInterpolator(float tension) : mTension(tension) {}
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 
 private:
     const float mTension;
@@ -111,6 +125,7 @@ class PathInterpolator : public Interpolator {
 public:
     explicit PathInterpolator(std::vector<float>&& x, std::vector<float>&& y) : mX(x), mY(y) {}
     virtual float interpolate(float input) override;
+    virtual bool getCurveKey(std::vector<float>* key) const override;
 
 private:
     std::vector<float> mX;
@@ -129,6 +144,39 @@ private:
     size_t mSize;
 };
 
+/**
+ * An interpolator's curve sampled at kSize + 1 evenly spaced points and evaluated by linear
+ * interpolation between them, so render thread animators do not run the interpolator (or, for
+ * PathInterpolator, a binary search) for every animator on every frame. Tables are shared
+ * between all interpolators with the same curve for as long as any animator uses them.
+ */
+class InterpolatorLUT {
+public:
+    static constexpr size_t kSize = 256;
+
+    // Returns the table for interpolator's curve, or nullptr if it has to be evaluated directly.
+    static std::shared_ptr<const InterpolatorLUT> compile(Interpolator& interpolator);
+
+    float evaluate(float fraction) const {
+        const float position = fraction > 0 ? std::min(fraction, 1.0f) * kSize : 0;
+        const size_t index = std::min(static_cast<size_t>(position), kSize - 1);
+        const float weight = position - index;
+        // Not a + (b - a) * weight, so that a fraction of 1 lands exactly on the last sample.
+        return mValues[index] * (1 - weight) + mValues[index + 1] * weight;
+    }
+
+    // Replaces fractions[i] with luts[i]->evaluate(fractions[i]) wherever luts[i] is not null.
+    // The sample positions are computed for the whole batch in one loop the compiler vectorizes.
+    static void evaluateAll(const InterpolatorLUT* const* luts, float* fractions, size_t count);
+
+    static size_t cachedCount();
+
+private:
+    InterpolatorLUT() {}
+
+    float mValues[kSize + 1];
+};
+
 } /* namespace uirenderer */
 } /* namespace android */
 
@@ -40,6 +40,7 @@
 #ifdef __ANDROID__
 #include "include/gpu/ganesh/SkImageGanesh.h"
 #endif
+#include "utils/EventTrace.h"
 #include "utils/ForceDark.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
@@ -76,6 +77,7 @@ RenderNode::RenderNode()
 RenderNode::~RenderNode() {
     ImmediateRemoved observer(nullptr);
     deleteDisplayList(observer);
+    skiapipeline::DisplayListPool::getInstance().release(std::move(mAvailableDisplayList));
     LOG_ALWAYS_FATAL_IF(hasLayer(), "layer missed detachment!");
 }
 
@@ -138,6 +140,7 @@ int RenderNode::getAllocatedSize() {
 
 void RenderNode::prepareTree(TreeInfo& info) {
     ATRACE_CALL();
+    HWUI_EVENT_SCOPE("RenderNode::prepareTree");
     LOG_ALWAYS_FATAL_IF(!info.damageAccumulator, "DamageAccumulator missing");
     MarkAndSweepRemoved observer(&info);
 
@@ -34,6 +34,7 @@
 #include "DisplayList.h"
 #include "Matrix.h"
 #include "RenderProperties.h"
+#include "pipeline/skia/DisplayListPool.h"
 #include "pipeline/skia/HolePunch.h"
 #include "pipeline/skia/SkiaDisplayList.h"
 #include "pipeline/skia/SkiaLayer.h"
@@ -305,10 +306,17 @@ public:
 
     bool hasHolePunches() { return mHasHolePunches; }
 
+    /**
+     * Bytes of ops in the display list that is waiting to be synced, if any. Used to pick a
+     * pooled list of about the right size when there is no available list to record into.
+     */
+    size_t getStagingDisplayListUsedSize() const { return mStagingDisplayList.getUsedSize(); }
+
     /**
      * Attach unused displayList to this node for potential future reuse.
      */
     void attachAvailableList(skiapipeline::SkiaDisplayList* skiaDisplayList) {
+        skiapipeline::DisplayListPool::getInstance().release(std::move(mAvailableDisplayList));
         mAvailableDisplayList.reset(skiaDisplayList);
     }
 
@@ -382,7 +390,7 @@ private:
     /**
      * If this RenderNode has been used in a previous frame then the SkiaDisplayList
      * from that frame is cached here until one of the following conditions is met:
-     *  1) The RenderNode is deleted (causing this to be deleted)
+     *  1) The RenderNode is deleted (causing this to be returned to the DisplayListPool)
      *  2) It is replaced with the displayList from the next completed frame
      *  3) It is detached and used to to record a new displayList for a later frame
      */
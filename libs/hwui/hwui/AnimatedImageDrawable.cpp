@@ -25,15 +25,76 @@
 #include <SkPicture.h>
 #include <SkRefCnt.h>
 
+#include <algorithm>
 #include <optional>
+#include <unordered_set>
 
 namespace android {
 
+// Upper bounds for keeping every frame of a looping animation around. Each frame is a full size
+// copy, so this is meant for stickers, spinners and other short loops.
+static constexpr int kMaxDecodeAheadFrames = 8;
+static constexpr int kMaxCachedFrames = 64;
+static constexpr size_t kMaxFrameCacheBytes = 8 * 1024 * 1024;
+
+static std::mutex sDrawablesLock;
+static std::unordered_set<AnimatedImageDrawable*>& liveDrawables() {
+    static auto* sDrawables = new std::unordered_set<AnimatedImageDrawable*>();
+    return *sDrawables;
+}
+
 AnimatedImageDrawable::AnimatedImageDrawable(sk_sp<SkAnimatedImage> animatedImage, size_t bytesUsed,
                                              SkEncodedImageFormat format)
         : mSkAnimatedImage(std::move(animatedImage)), mBytesUsed(bytesUsed), mFormat(format) {
     mTimeToShowNextSnapshot = ms2ns(currentFrameDuration());
     setStagingBounds(mSkAnimatedImage->getBounds());
+    std::lock_guard lock{sDrawablesLock};
+    liveDrawables().insert(this);
+}
+
+AnimatedImageDrawable::~AnimatedImageDrawable() {
+    std::lock_guard lock{sDrawablesLock};
+    liveDrawables().erase(this);
+}
+
+void AnimatedImageDrawable::setDecodeAhead(int frameCount, bool cacheFrames) {
+    mDecodeAheadCount = std::clamp(frameCount, 1, kMaxDecodeAheadFrames);
+    mCacheFrames = cacheFrames;
+    if (!cacheFrames) {
+        trimFrameCache();
+    }
+}
+
+AnimatedImageDrawable::FrameStats AnimatedImageDrawable::getFrameStats() {
+    std::unique_lock lock{mSwapLock};
+    return mFrameStats;
+}
+
+void AnimatedImageDrawable::trimFrameCaches() {
+    std::lock_guard lock{sDrawablesLock};
+    for (AnimatedImageDrawable* drawable : liveDrawables()) {
+        drawable->trimFrameCache();
+    }
+}
+
+// Called on the RenderThread, which must not wait for a frame being decoded: if mImageLock is busy
+// the next decode drops the cache instead. The frames are released after unlocking.
+void AnimatedImageDrawable::trimFrameCache() {
+    std::vector<CachedFrame> frames;
+    std::unique_lock lock{mImageLock, std::try_to_lock};
+    if (!lock.owns_lock()) {
+        mTrimFrameCache = true;
+        return;
+    }
+    frames.swap(mFrameCache);
+    lock.unlock();
+}
+
+void AnimatedImageDrawable::dropTrimmedFrameCacheLocked() {
+    if (mTrimFrameCache.exchange(false)) {
+        mFrameCache.clear();
+        mFrameCache.shrink_to_fit();
+    }
 }
 
 void AnimatedImageDrawable::syncProperties() {
@@ -62,8 +123,19 @@ bool AnimatedImageDrawable::isRunning() {
 }
 
 bool AnimatedImageDrawable::nextSnapshotReady() const {
-    return mNextSnapshot.valid() &&
-           mNextSnapshot.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    return !mNextSnapshots.empty() &&
+           mNextSnapshots.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// Only called on the RenderThread.
+void AnimatedImageDrawable::queueDecodes() {
+#ifdef __ANDROID__ // Layoutlib does not support AnimatedImageThread
+    auto& thread = uirenderer::AnimatedImageThread::getInstance();
+    const size_t count = mDecodeAheadCount;
+    while (mNextSnapshots.size() < count) {
+        mNextSnapshots.push_back(thread.decodeNextFrame(sk_ref_sp(this)));
+    }
+#endif
 }
 
 // Only called on the RenderThread while UI thread is locked.
@@ -80,7 +152,7 @@ bool AnimatedImageDrawable::isDirty(nsecs_t* outDelay) {
     std::unique_lock lock{mSwapLock};
     mCurrentTime += currentTime - lastWallTime;
 
-    if (!mNextSnapshot.valid()) {
+    if (mNextSnapshots.empty()) {
         // Need to trigger onDraw in order to start decoding the next frame.
         *outDelay = mTimeToShowNextSnapshot - mCurrentTime;
         return true;
@@ -99,19 +171,100 @@ bool AnimatedImageDrawable::isDirty(nsecs_t* outDelay) {
         // The next snapshot has not yet been decoded, but we've already passed
         // time to draw it. There's not a good way to know when decoding will
         // finish, so request an update immediately.
+        if (!mLateFrameCounted) {
+            mFrameStats.framesLate++;
+            mLateFrameCounted = true;
+        }
         *outDelay = 0;
     }
 
     return false;
 }
 
+bool AnimatedImageDrawable::canCacheFramesLocked() const {
+    if (!mCacheFrames || !mFrameIndexValid ||
+        mSkAnimatedImage->getRepetitionCount() != SkAnimatedImage::kRepetitionInfinite) {
+        return false;
+    }
+    const int frameCount = mSkAnimatedImage->getFrameCount();
+    const SkRect& bounds = mSkAnimatedImage->getBounds();
+    const size_t frameBytes = static_cast<size_t>(bounds.width() * bounds.height()) * 4;
+    return frameCount > 1 && frameCount <= kMaxCachedFrames &&
+           frameBytes * frameCount <= kMaxFrameCacheBytes;
+}
+
+// Decodes forward until mSkAnimatedImage shows the frame last handed out, after frames have been
+// served from a cache that has since been trimmed.
+void AnimatedImageDrawable::syncImageToFrameIndexLocked() {
+    if (!mFrameIndexValid || mImageFrameIndex == mFrameIndex) {
+        return;
+    }
+    ATRACE_NAME("AnimatedImageDrawable resync");
+    const int frameCount = mSkAnimatedImage->getFrameCount();
+    while (mImageFrameIndex != mFrameIndex) {
+        mSkAnimatedImage->decodeNextFrame();
+        mImageFrameIndex = (mImageFrameIndex + 1) % frameCount;
+    }
+}
+
+void AnimatedImageDrawable::resetImageLocked() {
+    mSkAnimatedImage->reset();
+    mImageFrameIndex = 0;
+    mFrameIndex = 0;
+    mFrameIndexValid = true;
+}
+
+// Decodes the frame after the one last handed out into mSkAnimatedImage, and moves both indices to
+// it. Returns its duration, or kFinished.
+int AnimatedImageDrawable::decodeImageFrameLocked() {
+    syncImageToFrameIndexLocked();
+    const int durationMS = adjustFrameDuration(mSkAnimatedImage->decodeNextFrame());
+    if (durationMS == SkAnimatedImage::kFinished) {
+        mFrameIndexValid = false;
+        mFrameCache.clear();
+    } else if (mFrameIndexValid) {
+        mImageFrameIndex = (mImageFrameIndex + 1) % mSkAnimatedImage->getFrameCount();
+        mFrameIndex = mImageFrameIndex;
+    }
+    return durationMS;
+}
+
 // Only called on the AnimatedImageThread.
 AnimatedImageDrawable::Snapshot AnimatedImageDrawable::decodeNextFrame() {
     Snapshot snap;
     {
         std::unique_lock lock{mImageLock};
-        snap.mDurationMS = adjustFrameDuration(mSkAnimatedImage->decodeNextFrame());
+        dropTrimmedFrameCacheLocked();
+        const bool canCache = canCacheFramesLocked();
+        const int frameCount = mSkAnimatedImage->getFrameCount();
+        if (canCache && static_cast<int>(mFrameCache.size()) == frameCount) {
+            mFrameIndex = (mFrameIndex + 1) % frameCount;
+            const CachedFrame& frame = mFrameCache[mFrameIndex];
+            snap.mPic = frame.mPic;
+            snap.mDurationMS = frame.mDurationMS;
+            snap.mFromCache = true;
+            return snap;
+        }
+
+        syncImageToFrameIndexLocked();
+        if (canCache && mFrameCache.empty() && mImageFrameIndex == 0) {
+            // The first frame was shown without a snapshot; capture it before moving on.
+            mFrameCache.push_back({mSkAnimatedImage->makePictureSnapshot(),
+                                   currentFrameDuration()});
+        }
+
+        snap.mDurationMS = decodeImageFrameLocked();
         snap.mPic = mSkAnimatedImage->makePictureSnapshot();
+
+        if (snap.mDurationMS != SkAnimatedImage::kFinished && mFrameIndexValid) {
+            if (canCache && mFrameIndex != 0 &&
+                static_cast<int>(mFrameCache.size()) == mFrameIndex) {
+                mFrameCache.push_back({snap.mPic, snap.mDurationMS});
+            } else if (static_cast<int>(mFrameCache.size()) < frameCount) {
+                // Missed a frame (e.g. caching was enabled mid-loop); start over next loop.
+                mFrameCache.clear();
+            }
+        }
     }
 
     return snap;
@@ -122,7 +275,16 @@ AnimatedImageDrawable::Snapshot AnimatedImageDrawable::reset() {
     Snapshot snap;
     {
         std::unique_lock lock{mImageLock};
-        mSkAnimatedImage->reset();
+        dropTrimmedFrameCacheLocked();
+        mFrameIndex = 0;
+        if (canCacheFramesLocked() &&
+            static_cast<int>(mFrameCache.size()) == mSkAnimatedImage->getFrameCount()) {
+            snap.mPic = mFrameCache[0].mPic;
+            snap.mDurationMS = mFrameCache[0].mDurationMS;
+            snap.mFromCache = true;
+            return snap;
+        }
+        resetImageLocked();
         snap.mPic = mSkAnimatedImage->makePictureSnapshot();
         snap.mDurationMS = currentFrameDuration();
     }
@@ -185,9 +347,11 @@ void AnimatedImageDrawable::onDraw(SkCanvas* canvas) {
     } else if (starting) {
         // The image has animated, and now is being reset. Queue up the first
         // frame, but keep showing the current frame until the first is ready.
+        // Frames decoded ahead from the old position are no longer wanted.
+        mNextSnapshots.clear();
 #ifdef __ANDROID__ // Layoutlib does not support AnimatedImageThread
         auto& thread = uirenderer::AnimatedImageThread::getInstance();
-        mNextSnapshot = thread.reset(sk_ref_sp(this));
+        mNextSnapshots.push_back(thread.reset(sk_ref_sp(this)));
 #endif
     }
 
@@ -195,11 +359,19 @@ void AnimatedImageDrawable::onDraw(SkCanvas* canvas) {
     if (mRunning && nextSnapshotReady()) {
         std::unique_lock lock{mSwapLock};
         if (mCurrentTime >= mTimeToShowNextSnapshot) {
-            mSnapshot = mNextSnapshot.get();
+            mSnapshot = mNextSnapshots.front().get();
+            mNextSnapshots.pop_front();
+            mFrameStats.framesShown++;
+            if (mSnapshot.mFromCache) {
+                mFrameStats.framesFromCache++;
+            }
+            mLateFrameCounted = false;
             const nsecs_t timeToShowCurrentSnap = mTimeToShowNextSnapshot;
             if (mSnapshot.mDurationMS == SkAnimatedImage::kFinished) {
                 finalFrame = true;
                 mRunning = false;
+                // Anything decoded past the end is also kFinished.
+                mNextSnapshots.clear();
             } else {
                 mTimeToShowNextSnapshot += ms2ns(mSnapshot.mDurationMS);
                 if (mCurrentTime >= mTimeToShowNextSnapshot) {
@@ -213,11 +385,8 @@ void AnimatedImageDrawable::onDraw(SkCanvas* canvas) {
         }
     }
 
-    if (mRunning && !mNextSnapshot.valid()) {
-#ifdef __ANDROID__ // Layoutlib does not support AnimatedImageThread
-        auto& thread = uirenderer::AnimatedImageThread::getInstance();
-        mNextSnapshot = thread.decodeNextFrame(sk_ref_sp(this));
-#endif
+    if (mRunning) {
+        queueDecodes();
     }
 
     if (!drawDirectly) {
@@ -265,6 +434,7 @@ int AnimatedImageDrawable::drawStaging(SkCanvas* canvas) {
         // Continue drawing the current frame, and return 0 to indicate no need
         // to redraw.
         std::unique_lock lock{mImageLock};
+        syncImageToFrameIndexLocked();
         canvas->drawDrawable(mSkAnimatedImage.get());
         return 0;
     }
@@ -274,7 +444,7 @@ int AnimatedImageDrawable::drawStaging(SkCanvas* canvas) {
         int durationMS = 0;
         {
             std::unique_lock lock{mImageLock};
-            mSkAnimatedImage->reset();
+            resetImageLocked();
             durationMS = currentFrameDuration();
         }
         {
@@ -307,7 +477,13 @@ int AnimatedImageDrawable::drawStaging(SkCanvas* canvas) {
     {
         std::unique_lock lock{mImageLock};
         if (update) {
-            durationMS = adjustFrameDuration(mSkAnimatedImage->decodeNextFrame());
+            durationMS = decodeImageFrameLocked();
+            // No snapshot is taken of frames drawn here, so a loop being cached now has a gap.
+            if (mFrameCache.size() < static_cast<size_t>(mSkAnimatedImage->getFrameCount())) {
+                mFrameCache.clear();
+            }
+        } else {
+            syncImageToFrameIndexLocked();
         }
 
         canvas->drawDrawable(mSkAnimatedImage.get());
@@ -27,8 +27,11 @@
 #include <utils/RefBase.h>
 #include <utils/Timers.h>
 
+#include <atomic>
+#include <deque>
 #include <future>
 #include <mutex>
+#include <vector>
 
 namespace android {
 
@@ -50,6 +53,7 @@ public:
     // Snapshots.
     AnimatedImageDrawable(sk_sp<SkAnimatedImage> animatedImage, size_t bytesUsed,
                           SkEncodedImageFormat format);
+    ~AnimatedImageDrawable() override;
 
     /**
      * This updates the internal time and returns true if the image needs
@@ -92,9 +96,34 @@ public:
         mEndListener = std::move(listener);
     }
 
+    /**
+     * Configures how many frames are decoded ahead of the one being shown, and whether every
+     * frame of a short, infinitely looping animation is kept so later loops skip decoding
+     * entirely. Frames are full size pictures, so both trade memory for smoother playback.
+     *
+     * Only called on the UI thread.
+     */
+    void setDecodeAhead(int frameCount, bool cacheFrames);
+
+    struct FrameStats {
+        // Frames that were swapped in on the RenderThread.
+        uint32_t framesShown = 0;
+        // Frames whose decode had not finished by the time they were due.
+        uint32_t framesLate = 0;
+        // Frames served from the frame cache rather than decoded.
+        uint32_t framesFromCache = 0;
+    };
+
+    FrameStats getFrameStats();
+
+    // Drops the frame caches of every AnimatedImageDrawable in the process. Playback continues by
+    // decoding again.
+    static void trimFrameCaches();
+
     struct Snapshot {
         sk_sp<SkPicture> mPic;
         int mDurationMS;
+        bool mFromCache = false;
 
         Snapshot() = default;
 
@@ -124,9 +153,16 @@ private:
     // A snapshot of the current frame to draw.
     Snapshot mSnapshot;
 
-    std::future<Snapshot> mNextSnapshot;
+    // Upcoming frames, in display order. AnimatedImageThread decodes them one at a time, so they
+    // become ready front to back.
+    std::deque<std::future<Snapshot>> mNextSnapshots;
+
+    // How many entries mNextSnapshots is kept topped up to. Written on the UI thread, read on the
+    // RenderThread.
+    std::atomic<int> mDecodeAheadCount = 1;
 
     bool nextSnapshotReady() const;
+    void queueDecodes();
 
     // When to switch from mSnapshot to mNextSnapshot.
     nsecs_t mTimeToShowNextSnapshot = 0;
@@ -144,6 +180,35 @@ private:
     // Locked when mSkAnimatedImage is being updated or drawn.
     std::mutex mImageLock;
 
+    struct CachedFrame {
+        sk_sp<SkPicture> mPic;
+        int mDurationMS;
+    };
+
+    // Every frame of the animation, once a complete loop has been decoded. Guarded by mImageLock.
+    std::vector<CachedFrame> mFrameCache;
+    std::atomic<bool> mCacheFrames = false;
+    // Set when mFrameCache should be dropped but mImageLock was busy; the next decode drops it.
+    std::atomic<bool> mTrimFrameCache = false;
+
+    // The frame mSkAnimatedImage has decoded, and the frame the last snapshot showed. They only
+    // differ once frames have been served from mFrameCache. Guarded by mImageLock.
+    int mImageFrameIndex = 0;
+    int mFrameIndex = 0;
+    // False once the animation has finished, as the indices no longer wrap. Guarded by mImageLock.
+    bool mFrameIndexValid = true;
+
+    bool canCacheFramesLocked() const;
+    void syncImageToFrameIndexLocked();
+    void resetImageLocked();
+    int decodeImageFrameLocked();
+    void dropTrimmedFrameCacheLocked();
+    void trimFrameCache();
+
+    FrameStats mFrameStats;
+    // Whether mFrameStats.framesLate has been incremented for the currently due frame.
+    bool mLateFrameCounted = false;
+
     struct Properties {
         int mAlpha = SK_AlphaOPAQUE;
         sk_sp<SkColorFilter> mColorFilter;
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BandedJpegEncoder.h"
+
+#include <SkColorSpace.h>
+#include <SkPixmap.h>
+#include <gui/TraceUtils.h>
+#include <log/log.h>
+
+#include <csetjmp>
+#include <future>
+
+#include "thread/CommonPool.h"
+
+extern "C" {
+// We need to include stdio.h before jpeg because jpeg does not include it, but uses FILE
+// See https://github.com/libjpeg-turbo/libjpeg-turbo/issues/17
+#include <stdio.h>
+#include "jerror.h"
+#include "jpeglib.h"
+}
+
+namespace android {
+
+// 4:2:0 subsampling means an MCU covers 16x16 pixels.
+static constexpr int kMcuSize = 16;
+// DRI stores the restart interval, in MCUs, as a 16 bit value.
+static constexpr int kMaxRestartInterval = 0xFFFF;
+// Below this the thread hand-off costs more than it saves.
+static constexpr int kMinPixels = 1024 * 1024;
+
+static constexpr uint8_t kMarkerPrefix = 0xFF;
+static constexpr uint8_t kMarkerSOF0 = 0xC0;
+static constexpr uint8_t kMarkerRST0 = 0xD0;
+static constexpr uint8_t kMarkerEOI = 0xD9;
+static constexpr uint8_t kMarkerSOS = 0xDA;
+static constexpr uint8_t kMarkerDRI = 0xDD;
+
+namespace {
+
+struct ErrorMgr {
+    jpeg_error_mgr pub;
+    jmp_buf jmp;
+};
+
+void errorExit(j_common_ptr cinfo) {
+    ErrorMgr* err = reinterpret_cast<ErrorMgr*>(cinfo->err);
+    longjmp(err->jmp, 1);
+}
+
+struct VectorDestination : jpeg_destination_mgr {
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    explicit VectorDestination(std::vector<uint8_t>* out) : out(out) {
+        init_destination = [](j_compress_ptr cinfo) {
+            auto* dest = static_cast<VectorDestination*>(cinfo->dest);
+            dest->out->resize(kChunkSize);
+            dest->next_output_byte = dest->out->data();
+            dest->free_in_buffer = dest->out->size();
+        };
+        empty_output_buffer = [](j_compress_ptr cinfo) -> boolean {
+            auto* dest = static_cast<VectorDestination*>(cinfo->dest);
+            size_t used = dest->out->size();
+            dest->out->resize(used * 2);
+            dest->next_output_byte = dest->out->data() + used;
+            dest->free_in_buffer = dest->out->size() - used;
+            return TRUE;
+        };
+        term_destination = [](j_compress_ptr cinfo) {
+            auto* dest = static_cast<VectorDestination*>(cinfo->dest);
+            dest->out->resize(dest->out->size() - dest->free_in_buffer);
+        };
+    }
+
+    std::vector<uint8_t>* out;
+};
+
+struct EncodedBand {
+    std::vector<uint8_t> data;
+    // Offset of the SOS marker, i.e. where the DRI segment needs to go.
+    size_t sosOffset = 0;
+    // Offset of the SOF0 height field.
+    size_t heightOffset = 0;
+    size_t entropyBegin = 0;
+    size_t entropyEnd = 0;
+    bool ok = false;
+};
+
+bool encodeBand(const BandedJpegEncoder::Image& image, int firstRow, int rowCount, int quality,
+                std::vector<uint8_t>* out) {
+    jpeg_compress_struct cinfo;
+    ErrorMgr err;
+    VectorDestination dest(out);
+
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = errorExit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    cinfo.dest = &dest;
+    cinfo.image_width = image.width;
+    cinfo.image_height = rowCount;
+    cinfo.input_components = 4;
+    cinfo.in_color_space =
+            image.order == BandedJpegEncoder::PixelOrder::RGBA ? JCS_EXT_RGBA : JCS_EXT_BGRA;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    // Every band has to share the same Huffman tables to be stitched together.
+    cinfo.optimize_coding = FALSE;
+    jpeg_start_compress(&cinfo, TRUE);
+
+    const uint8_t* row = image.pixels + firstRow * image.rowBytes;
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW rowPointer = const_cast<JSAMPROW>(row);
+        jpeg_write_scanlines(&cinfo, &rowPointer, 1);
+        row += image.rowBytes;
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return true;
+}
+
+// Locates the frame header, the scan header and the entropy coded segment of a baseline JPEG
+// written by encodeBand.
+bool parseBand(EncodedBand* band) {
+    const std::vector<uint8_t>& data = band->data;
+    const size_t size = data.size();
+    if (size < 4 || data[size - 2] != kMarkerPrefix || data[size - 1] != kMarkerEOI) {
+        return false;
+    }
+    size_t pos = 2;  // Skip SOI
+    while (pos + 4 <= size) {
+        if (data[pos] != kMarkerPrefix) {
+            return false;
+        }
+        const uint8_t marker = data[pos + 1];
+        const size_t length = (data[pos + 2] << 8) | data[pos + 3];
+        if (marker == kMarkerSOF0) {
+            // FF C0 Lh Ll P Yh Yl ...
+            band->heightOffset = pos + 5;
+        } else if (marker == kMarkerSOS) {
+            band->sosOffset = pos;
+            band->entropyBegin = pos + 2 + length;
+            band->entropyEnd = size - 2;
+            return band->heightOffset != 0 && band->entropyBegin <= band->entropyEnd;
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+void runOnCommonPool(std::vector<std::function<void()>>& bands) {
+    std::vector<std::future<void>> pending;
+    pending.reserve(bands.size());
+    for (size_t i = 1; i < bands.size(); i++) {
+        pending.push_back(uirenderer::CommonPool::async(std::move(bands[i])));
+    }
+    if (!bands.empty()) {
+        bands[0]();
+    }
+    for (auto& future : pending) {
+        future.wait();
+    }
+}
+
+}  // namespace
+
+int BandedJpegEncoder::computeBandMcuRows(int width, int height, int maxBands) {
+    if (width <= 0 || height <= 0 || maxBands < 2 || width > 0xFFFF || height > 0xFFFF) {
+        return 0;
+    }
+    const int mcusPerRow = (width + kMcuSize - 1) / kMcuSize;
+    const int mcuRows = (height + kMcuSize - 1) / kMcuSize;
+    int bandMcuRows = (mcuRows + maxBands - 1) / maxBands;
+    // Wide images need shorter bands so the restart interval still fits in DRI.
+    bandMcuRows = std::min(bandMcuRows, kMaxRestartInterval / mcusPerRow);
+    if (bandMcuRows <= 0 || bandMcuRows >= mcuRows) {
+        return 0;
+    }
+    return bandMcuRows;
+}
+
+bool BandedJpegEncoder::canEncode(const SkPixmap& pixmap) {
+    if (pixmap.colorType() != kRGBA_8888_SkColorType &&
+        pixmap.colorType() != kBGRA_8888_SkColorType) {
+        return false;
+    }
+    // SkJpegEncoder embeds an ICC profile for anything else.
+    if (pixmap.colorSpace() != nullptr && !pixmap.colorSpace()->isSRGB()) {
+        return false;
+    }
+    if (static_cast<int64_t>(pixmap.width()) * pixmap.height() < kMinPixels) {
+        return false;
+    }
+    return computeBandMcuRows(pixmap.width(), pixmap.height(),
+                              uirenderer::CommonPool::THREAD_COUNT + 1) > 0;
+}
+
+bool BandedJpegEncoder::encode(const SkPixmap& pixmap, int quality, std::vector<uint8_t>* out) {
+    ATRACE_FORMAT("BandedJpegEncoder %dx%d", pixmap.width(), pixmap.height());
+    Image image{
+            .pixels = static_cast<const uint8_t*>(pixmap.addr()),
+            .rowBytes = pixmap.rowBytes(),
+            .width = pixmap.width(),
+            .height = pixmap.height(),
+            .order = pixmap.colorType() == kRGBA_8888_SkColorType ? PixelOrder::RGBA
+                                                                  : PixelOrder::BGRA,
+    };
+    return encode(image, quality, uirenderer::CommonPool::THREAD_COUNT + 1, out);
+}
+
+bool BandedJpegEncoder::encode(const Image& image, int quality, int maxBands,
+                               std::vector<uint8_t>* out, const BandRunner& runner) {
+    const int bandMcuRows = computeBandMcuRows(image.width, image.height, maxBands);
+    if (bandMcuRows == 0) {
+        return false;
+    }
+    const int bandRows = bandMcuRows * kMcuSize;
+    const int bandCount = (image.height + bandRows - 1) / bandRows;
+
+    std::vector<EncodedBand> bands(bandCount);
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        tasks.push_back([&, i]() {
+            const int firstRow = i * bandRows;
+            const int rowCount = std::min(bandRows, image.height - firstRow);
+            EncodedBand& band = bands[i];
+            band.ok = encodeBand(image, firstRow, rowCount, quality, &band.data) &&
+                      parseBand(&band);
+        });
+    }
+    if (runner) {
+        runner(tasks);
+    } else {
+        runOnCommonPool(tasks);
+    }
+
+    size_t totalSize = bands[0].sosOffset + 6 + 2;
+    for (const EncodedBand& band : bands) {
+        if (!band.ok) {
+            ALOGW("BandedJpegEncoder: failed to encode band");
+            return false;
+        }
+        totalSize += band.entropyEnd - band.entropyBegin + 2;
+    }
+
+    // Headers from the first band, with the full image height and a DRI segment matching the
+    // band size, followed by every band's entropy coded segment separated by RSTn markers.
+    const EncodedBand& first = bands[0];
+    out->clear();
+    out->reserve(totalSize);
+    out->insert(out->end(), first.data.begin(), first.data.begin() + first.sosOffset);
+    (*out)[first.heightOffset] = static_cast<uint8_t>(image.height >> 8);
+    (*out)[first.heightOffset + 1] = static_cast<uint8_t>(image.height & 0xFF);
+
+    const int restartInterval = bandMcuRows * ((image.width + kMcuSize - 1) / kMcuSize);
+    const uint8_t dri[] = {kMarkerPrefix,
+                           kMarkerDRI,
+                           0,
+                           4,
+                           static_cast<uint8_t>(restartInterval >> 8),
+                           static_cast<uint8_t>(restartInterval & 0xFF)};
+    out->insert(out->end(), std::begin(dri), std::end(dri));
+    out->insert(out->end(), first.data.begin() + first.sosOffset,
+                first.data.begin() + first.entropyEnd);
+    for (int i = 1; i < bandCount; i++) {
+        const EncodedBand& band = bands[i];
+        out->push_back(kMarkerPrefix);
+        out->push_back(static_cast<uint8_t>(kMarkerRST0 + ((i - 1) & 7)));
+        out->insert(out->end(), band.data.begin() + band.entropyBegin,
+                    band.data.begin() + band.entropyEnd);
+    }
+    out->push_back(kMarkerPrefix);
+    out->push_back(kMarkerEOI);
+    return true;
+}
+
+}  // namespace android
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class SkPixmap;
+
+namespace android {
+
+/**
+ * Baseline JPEG encoder that splits large images into horizontal bands and entropy codes them in
+ * parallel.
+ *
+ * Each band is a whole number of MCU rows and is encoded as an independent JPEG with the standard
+ * Huffman tables. The bands are then stitched into a single image using restart markers, which
+ * reset the DC predictors exactly like an encoder emitting a restart interval would. The result
+ * is byte for byte what libjpeg produces for the whole image with the same restart interval.
+ */
+class BandedJpegEncoder {
+public:
+    enum class PixelOrder {
+        RGBA,
+        BGRA,
+    };
+
+    struct Image {
+        const uint8_t* pixels;
+        size_t rowBytes;
+        int width;
+        int height;
+        PixelOrder order;
+    };
+
+    // Runs the given band encodes, returning once all of them have completed. The default runs
+    // all but the first band on the CommonPool and the first one on the calling thread.
+    using BandRunner = std::function<void(std::vector<std::function<void()>>& bands)>;
+
+    // Returns true if the pixmap is large enough to benefit from banding and is in a format the
+    // banded path handles identically to SkJpegEncoder.
+    static bool canEncode(const SkPixmap& pixmap);
+
+    // Encodes pixmap into out. Nothing is written anywhere else, so on failure the caller can
+    // still encode the image another way.
+    static bool encode(const SkPixmap& pixmap, int quality, std::vector<uint8_t>* out);
+
+    // Returns the number of MCU rows per band (and thus per restart interval) used for an image
+    // of the given size split into at most maxBands bands, or 0 if it cannot be banded.
+    static int computeBandMcuRows(int width, int height, int maxBands);
+
+    // Encodes image into out. Exposed separately from the Skia entry point for testing.
+    static bool encode(const Image& image, int quality, int maxBands, std::vector<uint8_t>* out,
+                       const BandRunner& runner = nullptr);
+};
+
+}  // namespace android
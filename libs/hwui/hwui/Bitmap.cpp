@@ -15,6 +15,7 @@
  */
 #include "Bitmap.h"
 
+#include "BandedJpegEncoder.h"
 #include "HardwareBitmapUploader.h"
 #include "Properties.h"
 #ifdef __ANDROID__  // Layoutlib does not support render thread
@@ -313,7 +314,9 @@ Bitmap::~Bitmap() {
 #ifndef _WIN32 // ashmem not implemented on Windows
             munmap(mPixelStorage.ashmem.address, mPixelStorage.ashmem.size);
 #endif
-            close(mPixelStorage.ashmem.fd);
+            if (mPixelStorage.ashmem.fd >= 0) {
+                close(mPixelStorage.ashmem.fd);
+            }
             break;
         case PixelStorageType::Heap:
             free(mPixelStorage.heap.address);
@@ -504,7 +507,8 @@ BitmapPalette Bitmap::computePalette(const SkImageInfo& info, const void* addr,
     return BitmapPalette::Unknown;
 }
 
-bool Bitmap::compress(JavaCompressFormat format, int32_t quality, SkWStream* stream) {
+bool Bitmap::compress(JavaCompressFormat format, int32_t quality, SkWStream* stream,
+                      bool allowBandedJpeg) {
 #ifdef __ANDROID__  // TODO: This isn't built for host for some reason?
     if (hasGainmap() && format == JavaCompressFormat::Jpeg) {
         SkBitmap baseBitmap = getSkBitmap();
@@ -524,11 +528,11 @@ bool Bitmap::compress(JavaCompressFormat format, int32_t quality, SkWStream* str
 
     SkBitmap skbitmap;
     getSkBitmap(&skbitmap);
-    return compress(skbitmap, format, quality, stream);
+    return compress(skbitmap, format, quality, stream, allowBandedJpeg);
 }
 
 bool Bitmap::compress(const SkBitmap& bitmap, JavaCompressFormat format,
-                      int32_t quality, SkWStream* stream) {
+                      int32_t quality, SkWStream* stream, bool allowBandedJpeg) {
     if (bitmap.colorType() == kAlpha_8_SkColorType) {
         // None of the JavaCompressFormats have a sensible way to compress an
         // ALPHA_8 Bitmap. SkPngEncoder will compress one, but it uses a non-
@@ -537,8 +541,20 @@ bool Bitmap::compress(const SkBitmap& bitmap, JavaCompressFormat format,
         return false;
     }
 
+    ATRACE_CALL();
     switch (format) {
         case JavaCompressFormat::Jpeg: {
+#ifdef __ANDROID__  // CommonPool is not available on host
+            if (allowBandedJpeg && BandedJpegEncoder::canEncode(bitmap.pixmap())) {
+                // Nothing reaches stream unless the banded encode succeeds, so on failure the
+                // image is simply encoded again below.
+                std::vector<uint8_t> banded;
+                if (BandedJpegEncoder::encode(bitmap.pixmap(), quality, &banded)) {
+                    return stream->write(banded.data(), banded.size());
+                }
+                ALOGW("Banded JPEG encode failed, falling back to SkJpegEncoder");
+            }
+#endif
             SkJpegEncoder::Options options;
             options.fQuality = quality;
             return SkJpegEncoder::Encode(stream, bitmap.pixmap(), options);
@@ -111,6 +111,9 @@ public:
         return ret;
     }
 
+    // Returns -1 if the pixels are not in shareable ashmem. That includes a mutable bitmap
+    // received through BitmapParcelCache: it is Ashmem storage, but a private copy-on-write mapping
+    // whose fd was dropped.
     int getAshmemFd() const;
     size_t getAllocationByteCount() const;
 
@@ -171,10 +174,13 @@ public:
     WebpLossless = 4,
   };
 
-  bool compress(JavaCompressFormat format, int32_t quality, SkWStream* stream);
+  // allowBandedJpeg lets large JPEGs be encoded in parallel bands. The output is a valid JPEG
+  // but, with its restart markers, not the bytes SkJpegEncoder would produce, so callers opt in.
+  bool compress(JavaCompressFormat format, int32_t quality, SkWStream* stream,
+                bool allowBandedJpeg = false);
 
   static bool compress(const SkBitmap& bitmap, JavaCompressFormat format,
-                       int32_t quality, SkWStream* stream);
+                       int32_t quality, SkWStream* stream, bool allowBandedJpeg = false);
 private:
     static sk_sp<Bitmap> allocateAshmemBitmap(size_t size, const SkImageInfo& i, size_t rowBytes);
 
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BitmapParcelCache.h"
+
+#include <fcntl.h>
+#include <log/log.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utils/Trace.h>
+
+#include <algorithm>
+#include <cinttypes>
+
+#include "renderthread/RenderThread.h"
+
+namespace android {
+
+// Regions are small compared to the Skia resource cache but can be several MB each for
+// full-screen notifications, so keep enough around for a handful of them.
+static constexpr size_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t mixLane(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+BitmapParcelCache& BitmapParcelCache::getInstance() {
+    // Expired regions are dropped on the RenderThread, but one is not started just for that; the
+    // next acquire() or trimMemory drops them instead.
+    static BitmapParcelCache* sInstance = new BitmapParcelCache(
+            kDefaultMaxBytes, kDefaultIdleTimeout, [](nsecs_t delay, std::function<void()> task) {
+                using uirenderer::renderthread::RenderThread;
+                if (!RenderThread::hasInstance()) {
+                    return false;
+                }
+                RenderThread::getInstance().queue().postDelayed(delay, std::move(task));
+                return true;
+            });
+    return *sInstance;
+}
+
+BitmapParcelCache::BitmapParcelCache(size_t maxBytes, nsecs_t idleTimeout, Scheduler scheduler)
+        : mMaxBytes(maxBytes), mIdleTimeout(idleTimeout), mScheduler(std::move(scheduler)) {}
+
+BitmapParcelCache::~BitmapParcelCache() {
+    trim();
+}
+
+uint64_t BitmapParcelCache::hash(const void* data, size_t size) {
+    // Four independent lanes so the multiplies can be pipelined; pixel buffers are large enough
+    // that the bulk loop dominates.
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    uint64_t h;
+    if (size >= 32) {
+        uint64_t v1 = kPrime1 + kPrime2;
+        uint64_t v2 = kPrime2;
+        uint64_t v3 = 0;
+        uint64_t v4 = -kPrime1;
+        const uint8_t* const limit = end - 32;
+        do {
+            uint64_t w[4];
+            memcpy(w, p, sizeof(w));
+            v1 = mixLane(v1, w[0]);
+            v2 = mixLane(v2, w[1]);
+            v3 = mixLane(v3, w[2]);
+            v4 = mixLane(v4, w[3]);
+            p += 32;
+        } while (p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    } else {
+        h = kPrime3;
+    }
+    h += static_cast<uint64_t>(size);
+    while (p + 8 <= end) {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h ^= mixLane(0, w);
+        h = rotl(h, 27) * kPrime1 + kPrime3;
+        p += 8;
+    }
+    while (p < end) {
+        h ^= (*p) * kPrime3;
+        h = rotl(h, 11) * kPrime1;
+        p++;
+    }
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool BitmapParcelCache::isWriteSealed(int fd) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    return seals >= 0 && (seals & F_SEAL_WRITE);
+}
+
+base::unique_fd BitmapParcelCache::createSealedRegion(const void* data, size_t size,
+                                                      void** outAddr) {
+    base::unique_fd fd(memfd_create("bitmap", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (fd.get() < 0) {
+        return {};
+    }
+    if (ftruncate(fd.get(), size) < 0) {
+        return {};
+    }
+    {
+        void* dest = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+        if (dest == MAP_FAILED) {
+            return {};
+        }
+        memcpy(dest, data, size);
+        // F_SEAL_WRITE is refused while any writable shared mapping exists.
+        munmap(dest, size);
+    }
+    if (fcntl(fd.get(), F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) <
+        0) {
+        ALOGW("BitmapParcelCache: failed to seal region: %s", strerror(errno));
+        return {};
+    }
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd.get(), 0);
+    if (addr == MAP_FAILED) {
+        return {};
+    }
+    *outAddr = addr;
+    return fd;
+}
+
+BitmapParcelCache::EntryList::iterator BitmapParcelCache::findLocked(uint64_t hash,
+                                                                     const void* data,
+                                                                     size_t size) {
+    auto range = mIndex.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& entry = *it->second;
+        if (entry.size == size && memcmp(entry.addr, data, size) == 0) {
+            return it->second;
+        }
+    }
+    return mEntries.end();
+}
+
+void BitmapParcelCache::eraseLocked(EntryList::iterator entry) {
+    auto range = mIndex.equal_range(entry->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == entry) {
+            mIndex.erase(it);
+            break;
+        }
+    }
+    munmap(entry->addr, entry->size);
+    mStats.cachedBytes -= entry->size;
+    mEntries.erase(entry);
+}
+
+void BitmapParcelCache::evictLocked(size_t incomingBytes) {
+    while (!mEntries.empty() && mStats.cachedBytes + incomingBytes > mMaxBytes) {
+        eraseLocked(std::prev(mEntries.end()));
+        mStats.evictions++;
+    }
+}
+
+void BitmapParcelCache::trimIdleLocked(nsecs_t now) {
+    // The least recently used entries are at the back.
+    while (!mEntries.empty() && now - mEntries.back().lastUsed >= mIdleTimeout) {
+        eraseLocked(std::prev(mEntries.end()));
+    }
+}
+
+// Schedules onExpiry() for when the least recently used entry expires, unless it already is.
+void BitmapParcelCache::scheduleExpiryLocked(nsecs_t now) {
+    if (!mScheduler || mExpiryScheduled || mEntries.empty()) {
+        return;
+    }
+    const nsecs_t delay = std::max<nsecs_t>(mEntries.back().lastUsed + mIdleTimeout - now, 0);
+    mExpiryScheduled = mScheduler(delay, [this]() { onExpiry(); });
+}
+
+void BitmapParcelCache::onExpiry() {
+    std::lock_guard lock(mLock);
+    mExpiryScheduled = false;
+    const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    trimIdleLocked(now);
+    scheduleExpiryLocked(now);
+}
+
+base::unique_fd BitmapParcelCache::acquire(const void* data, size_t size) {
+    if (size == 0 || size > mMaxBytes) {
+        return {};
+    }
+    ATRACE_CALL();
+    const uint64_t key = hash(data, size);
+    {
+        std::lock_guard lock(mLock);
+        const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+        trimIdleLocked(now);
+        auto entry = findLocked(key, data, size);
+        if (entry != mEntries.end()) {
+            entry->lastUsed = now;
+            mEntries.splice(mEntries.begin(), mEntries, entry);
+            mStats.hits++;
+            mStats.bytesSaved += size;
+            return base::unique_fd(fcntl(entry->fd.get(), F_DUPFD_CLOEXEC, 0));
+        }
+    }
+
+    // Create the region outside of the lock; the copy dominates and other threads may be
+    // sending unrelated bitmaps meanwhile.
+    void* addr = nullptr;
+    base::unique_fd fd = createSealedRegion(data, size, &addr);
+    if (fd.get() < 0) {
+        return {};
+    }
+    base::unique_fd result(fcntl(fd.get(), F_DUPFD_CLOEXEC, 0));
+
+    std::lock_guard lock(mLock);
+    mStats.misses++;
+    if (findLocked(key, data, size) != mEntries.end()) {
+        // Another thread raced us with identical contents; theirs is already cached.
+        munmap(addr, size);
+        return result;
+    }
+    evictLocked(size);
+    const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    mEntries.push_front(Entry{key, size, std::move(fd), addr, now});
+    mIndex.emplace(key, mEntries.begin());
+    mStats.cachedBytes += size;
+    scheduleExpiryLocked(now);
+    return result;
+}
+
+void BitmapParcelCache::trim() {
+    std::lock_guard lock(mLock);
+    while (!mEntries.empty()) {
+        eraseLocked(mEntries.begin());
+    }
+}
+
+void BitmapParcelCache::trimIdle(nsecs_t now) {
+    std::lock_guard lock(mLock);
+    trimIdleLocked(now);
+}
+
+BitmapParcelCache::Stats BitmapParcelCache::getStats() {
+    std::lock_guard lock(mLock);
+    Stats stats = mStats;
+    stats.entryCount = mEntries.size();
+    return stats;
+}
+
+void BitmapParcelCache::dump(String8& log) {
+    Stats stats = getStats();
+    log.appendFormat("Bitmap parcel cache:\n");
+    log.appendFormat("  Entries: %zu (%.2f MB of %.2f MB)\n", stats.entryCount,
+                     stats.cachedBytes / 1000000.f, mMaxBytes / 1000000.f);
+    log.appendFormat("  Hits: %" PRIu64 ", misses: %" PRIu64 ", evictions: %" PRIu64 "\n",
+                     stats.hits, stats.misses, stats.evictions);
+    log.appendFormat("  Bytes saved: %.2f MB\n", stats.bytesSaved / 1000000.f);
+}
+
+}  // namespace android
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <android-base/unique_fd.h>
+#include <utils/Macros.h>
+#include <utils/String8.h>
+#include <utils/Timers.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace android {
+
+/**
+ * Process-wide cache of sealed shared memory regions used to send bitmap pixels across a Parcel.
+ *
+ * Widgets and notifications tend to send the same pixels over and over again. Rather than copying
+ * them into a fresh ashmem region for every Parcel, the pixels are hashed and a previously sealed
+ * memfd with identical contents is handed out again. Regions are sealed against writes, so the
+ * receiving side maps them read-only when the bitmap is immutable and copy-on-write (MAP_PRIVATE)
+ * when it is mutable. Contents are always compared byte for byte on a hash match, so a collision
+ * can never hand out the wrong pixels.
+ *
+ * Regions not handed out for a while are dropped, and RenderProxy::trimMemory drops them all on
+ * memory pressure whether or not the process has a RenderThread.
+ */
+class BitmapParcelCache {
+    PREVENT_COPY_AND_ASSIGN(BitmapParcelCache);
+
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        // Number of pixel bytes that did not have to be copied into a new region.
+        uint64_t bytesSaved = 0;
+        size_t cachedBytes = 0;
+        size_t entryCount = 0;
+    };
+
+    // Runs task on another thread once delay has passed. Returns false if it cannot.
+    using Scheduler = std::function<bool(nsecs_t delay, std::function<void()> task)>;
+
+    static constexpr nsecs_t kDefaultIdleTimeout = 60 * 1000 * 1000 * 1000LL;
+
+    static BitmapParcelCache& getInstance();
+
+    // Regions not handed out for idleTimeout are dropped by the next acquire(), or by a task run
+    // through scheduler once they expire.
+    explicit BitmapParcelCache(size_t maxBytes, nsecs_t idleTimeout = kDefaultIdleTimeout,
+                               Scheduler scheduler = nullptr);
+    ~BitmapParcelCache();
+
+    /**
+     * Returns a new fd (owned by the caller) referring to a sealed region whose first size bytes
+     * are identical to data. Returns an invalid fd if the region could not be created, in which
+     * case the caller should fall back to an uncached copy.
+     */
+    base::unique_fd acquire(const void* data, size_t size);
+
+    // Drops every cached region. Regions that are still referenced by a receiver stay alive until
+    // the receiver releases them.
+    void trim();
+
+    // Drops the regions last handed out idleTimeout or longer before now.
+    void trimIdle(nsecs_t now);
+
+    Stats getStats();
+    void dump(String8& log);
+
+    // Returns true if fd refers to a region that has been sealed against writes, meaning a
+    // mutable receiver must map it privately.
+    static bool isWriteSealed(int fd);
+
+    static uint64_t hash(const void* data, size_t size);
+
+private:
+    struct Entry {
+        uint64_t hash;
+        size_t size;
+        base::unique_fd fd;
+        // Read-only mapping kept for verifying hash matches without another mmap.
+        void* addr;
+        nsecs_t lastUsed;
+    };
+    using EntryList = std::list<Entry>;
+
+    EntryList::iterator findLocked(uint64_t hash, const void* data, size_t size);
+    void evictLocked(size_t incomingBytes);
+    void eraseLocked(EntryList::iterator it);
+    void trimIdleLocked(nsecs_t now);
+    void scheduleExpiryLocked(nsecs_t now);
+    void onExpiry();
+
+    static base::unique_fd createSealedRegion(const void* data, size_t size, void** outAddr);
+
+    const size_t mMaxBytes;
+    const nsecs_t mIdleTimeout;
+    const Scheduler mScheduler;
+
+    std::mutex mLock;
+    // Most recently used entries are kept at the front.
+    EntryList mEntries;
+    std::unordered_multimap<uint64_t, EntryList::iterator> mIndex;
+    Stats mStats;
+    bool mExpiryScheduled = false;
+};
+
+}  // namespace android
@@ -255,6 +255,12 @@ static void AnimatedImageDrawable_nSetBounds(JNIEnv* env, jobject /*clazz*/, jlo
     drawable->setStagingBounds(rect);
 }
 
+static void AnimatedImageDrawable_nSetDecodeAhead(JNIEnv* env, jobject /*clazz*/, jlong nativePtr,
+                                                  jint frameCount, jboolean cacheFrames) {
+    auto* drawable = reinterpret_cast<AnimatedImageDrawable*>(nativePtr);
+    drawable->setDecodeAhead(frameCount, cacheFrames);
+}
+
 static const JNINativeMethod gAnimatedImageDrawableMethods[] = {
         {"nCreate", "(JLandroid/graphics/ImageDecoder;IIJZLandroid/graphics/Rect;)J",
          (void*)AnimatedImageDrawable_nCreate},
@@ -273,6 +279,7 @@ static const JNINativeMethod gAnimatedImageDrawableMethods[] = {
         {"nNativeByteSize", "(J)J", (void*)AnimatedImageDrawable_nNativeByteSize},
         {"nSetMirrored", "(JZ)V", (void*)AnimatedImageDrawable_nSetMirrored},
         {"nSetBounds", "(JLandroid/graphics/Rect;)V", (void*)AnimatedImageDrawable_nSetBounds},
+        {"nSetDecodeAhead", "(JIZ)V", (void*)AnimatedImageDrawable_nSetDecodeAhead},
 };
 
 int register_android_graphics_drawable_AnimatedImageDrawable(JNIEnv* env) {
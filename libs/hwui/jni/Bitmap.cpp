@@ -26,11 +26,13 @@
 
 #ifdef __ANDROID__ // Layoutlib does not support graphic buffer, parcel or render thread
 #include <android-base/unique_fd.h>
+#include <hwui/BitmapParcelCache.h>
 #include <renderthread/RenderProxy.h>
 #endif
 
 #include <inttypes.h>
 #include <string.h>
+#include <utils/Timers.h>
 
 #include <memory>
 
@@ -510,6 +512,102 @@ static jboolean Bitmap_compress(JNIEnv* env, jobject clazz, jlong bitmapHandle,
     return bitmap->bitmap().compress(fm, quality, strm.get()) ? JNI_TRUE : JNI_FALSE;
 }
 
+#ifdef __ANDROID__ // Layoutlib does not support compressing to a file descriptor
+// Large enough that a 4K JPEG is written with a handful of syscalls.
+static constexpr size_t kCompressToFdBufferSize = 256 * 1024;
+
+class FdWStream : public SkWStream {
+public:
+    explicit FdWStream(int fd)
+            : mFd(fd), mBuffer(std::make_unique<uint8_t[]>(kCompressToFdBufferSize)) {}
+
+    ~FdWStream() override { flush(); }
+
+    bool write(const void* buffer, size_t size) override {
+        const uint8_t* src = static_cast<const uint8_t*>(buffer);
+        while (size > 0 && !mFailed) {
+            if (mUsed == 0 && size >= kCompressToFdBufferSize) {
+                // Skip the copy for big chunks like the ones BandedJpegEncoder hands us.
+                writeFully(src, size);
+                return !mFailed;
+            }
+            const size_t chunk = std::min(size, kCompressToFdBufferSize - mUsed);
+            memcpy(mBuffer.get() + mUsed, src, chunk);
+            mUsed += chunk;
+            src += chunk;
+            size -= chunk;
+            if (mUsed == kCompressToFdBufferSize) {
+                flush();
+            }
+        }
+        return !mFailed;
+    }
+
+    void flush() override {
+        if (mUsed > 0) {
+            writeFully(mBuffer.get(), mUsed);
+            mUsed = 0;
+        }
+    }
+
+    size_t bytesWritten() const override { return mBytesWritten + mUsed; }
+
+    bool failed() const { return mFailed; }
+
+private:
+    void writeFully(const uint8_t* data, size_t size) {
+        while (size > 0 && !mFailed) {
+            ssize_t written = TEMP_FAILURE_RETRY(::write(mFd, data, size));
+            if (written <= 0) {
+                ALOGW("Bitmap.compress: write failed: %s", strerror(errno));
+                mFailed = true;
+                return;
+            }
+            data += written;
+            size -= written;
+            mBytesWritten += written;
+        }
+    }
+
+    const int mFd;
+    std::unique_ptr<uint8_t[]> mBuffer;
+    size_t mUsed = 0;
+    size_t mBytesWritten = 0;
+    bool mFailed = false;
+};
+#endif
+
+// Compresses straight into a file descriptor, avoiding the JNI upcall per buffer that the
+// OutputStream path needs. If banded is set, large JPEGs may be encoded in parallel bands.
+// Returns the time spent encoding in nanoseconds, or -1 on failure.
+static jlong Bitmap_compressToFd(JNIEnv* env, jobject clazz, jlong bitmapHandle, jint format,
+                                 jint quality, jobject fileDescriptor, jboolean banded) {
+#ifdef __ANDROID__ // Layoutlib does not support compressing to a file descriptor
+    LocalScopedBitmap bitmap(bitmapHandle);
+    if (!bitmap.valid()) {
+        return -1;
+    }
+    int descriptor = jniGetFDFromFileDescriptor(env, fileDescriptor);
+    if (descriptor < 0) {
+        doThrowIAE(env, "invalid file descriptor");
+        return -1;
+    }
+
+    const nsecs_t start = systemTime(SYSTEM_TIME_MONOTONIC);
+    auto fm = static_cast<Bitmap::JavaCompressFormat>(format);
+    FdWStream stream(descriptor);
+    bool success = bitmap->bitmap().compress(fm, quality, &stream, banded);
+    stream.flush();
+    if (!success || stream.failed()) {
+        return -1;
+    }
+    return systemTime(SYSTEM_TIME_MONOTONIC) - start;
+#else
+    doThrowRE(env, "Cannot compress to a file descriptor outside of Android");
+    return -1;
+#endif
+}
+
 static inline void bitmapErase(SkBitmap bitmap, const SkColor4f& color,
         const sk_sp<SkColorSpace>& colorSpace) {
     SkPaint p;
@@ -668,6 +766,17 @@ static binder_status_t writeBlob(AParcel* parcel, const int32_t size, const void
     }
     binder_status_t error = STATUS_OK;
     if (shouldUseAshmem(parcel, size)) {
+        // Reuse a sealed region with identical contents if we sent these pixels before. The
+        // receiver maps it copy-on-write if the bitmap is mutable.
+        base::unique_fd cachedFd = BitmapParcelCache::getInstance().acquire(data, size);
+        if (cachedFd.get() >= 0) {
+            // Workaround b/149851140 in AParcel_writeParcelFileDescriptor
+            int rawFd = cachedFd.release();
+            error = writeBlobFromFd(parcel, size, rawFd);
+            close(rawFd);
+            return error;
+        }
+
         // Create new ashmem region with read/write priv
         base::unique_fd fd(ashmem_create_region("bitmap", size));
         if (fd.get() < 0) {
@@ -795,12 +904,21 @@ static jobject Bitmap_createFromParcel(JNIEnv* env, jobject, jobject parcel) {
                 if (isMutable) {
                     flags |= PROT_WRITE;
                 }
-                void* addr = mmap(nullptr, size, flags, MAP_SHARED, fd.get(), 0);
+                // Regions handed out by BitmapParcelCache are sealed and may be shared with other
+                // receivers, so a mutable bitmap gets a private copy-on-write mapping instead.
+                const bool copyOnWrite = isMutable && BitmapParcelCache::isWriteSealed(fd.get());
+                void* addr = mmap(nullptr, size, flags, copyOnWrite ? MAP_PRIVATE : MAP_SHARED,
+                                  fd.get(), 0);
                 if (addr == MAP_FAILED) {
                     const int err = errno;
                     ALOGW("mmap failed, error %d (%s)", err, strerror(err));
                     return STATUS_NO_MEMORY;
                 }
+                if (copyOnWrite) {
+                    // The fd no longer reflects what the bitmap holds once it is written to, so
+                    // don't keep it around to be passed on by a later writeToParcel.
+                    fd.reset();
+                }
                 nativeBitmap =
                         Bitmap::createFrom(imageInfo, rowBytes, fd.release(), addr, size, !isMutable);
                 return STATUS_OK;
@@ -1179,8 +1297,9 @@ static jboolean Bitmap_isBackedByAshmem(CRITICAL_JNI_PARAMS_COMMA jlong bitmapHa
     LocalScopedBitmap bitmapHolder(bitmapHandle);
     if (!bitmapHolder.valid()) return JNI_FALSE;
 
-    return bitmapHolder->bitmap().pixelStorageType() == PixelStorageType::Ashmem ? JNI_TRUE
-                                                                                 : JNI_FALSE;
+    // A copy-on-write mapping of a region from BitmapParcelCache is ashmem storage without an fd
+    // to share, so it must not be treated as shareable.
+    return bitmapHolder->bitmap().getAshmemFd() >= 0 ? JNI_TRUE : JNI_FALSE;
 }
 
 static void Bitmap_setImmutable(JNIEnv* env, jobject, jlong bitmapHandle) {
@@ -1224,6 +1343,7 @@ static const JNINativeMethod gBitmapMethods[] = {
         {"nativeRecycle", "(J)V", (void*)Bitmap_recycle},
         {"nativeReconfigure", "(JIIIZ)V", (void*)Bitmap_reconfigure},
         {"nativeCompress", "(JIILjava/io/OutputStream;[B)Z", (void*)Bitmap_compress},
+        {"nativeCompressToFd", "(JIILjava/io/FileDescriptor;Z)J", (void*)Bitmap_compressToFd},
         {"nativeErase", "(JI)V", (void*)Bitmap_erase},
         {"nativeErase", "(JJJ)V", (void*)Bitmap_eraseLong},
         {"nativeRowBytes", "(J)I", (void*)Bitmap_rowBytes},
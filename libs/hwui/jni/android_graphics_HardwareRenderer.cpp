@@ -405,6 +405,10 @@ static void android_view_ThreadedRenderer_dumpGlobalProfileInfo(JNIEnv* env, job
                                                                 jobject javaFileDescriptor,
                                                                 jint dumpFlags) {
     int fd = jniGetFDFromFileDescriptor(env, javaFileDescriptor);
+    if (dumpFlags & DumpFlags::EventTrace) {
+        RenderProxy::dumpEventTrace(fd);
+        return;
+    }
     RenderProxy::dumpGraphicsMemory(fd, true, dumpFlags & DumpFlags::Reset);
 }
 
@@ -885,7 +889,8 @@ static jboolean android_view_ThreadedRenderer_isDrawingEnabled(JNIEnv*, jclass)
 
 static void android_view_ThreadedRenderer_addObserver(JNIEnv* env, jclass clazz,
         jlong proxyPtr, jlong observerPtr) {
-    HardwareRendererObserver* observer = reinterpret_cast<HardwareRendererObserver*>(observerPtr);
+    // Points at the FrameMetricsObserver base of a HardwareRendererObserver or FrameMetricsRing.
+    auto* observer = reinterpret_cast<FrameMetricsObserver*>(observerPtr);
     renderthread::RenderProxy* renderProxy =
             reinterpret_cast<renderthread::RenderProxy*>(proxyPtr);
 
@@ -894,7 +899,8 @@ static void android_view_ThreadedRenderer_addObserver(JNIEnv* env, jclass clazz,
 
 static void android_view_ThreadedRenderer_removeObserver(JNIEnv* env, jclass clazz,
         jlong proxyPtr, jlong observerPtr) {
-    HardwareRendererObserver* observer = reinterpret_cast<HardwareRendererObserver*>(observerPtr);
+    // Points at the FrameMetricsObserver base of a HardwareRendererObserver or FrameMetricsRing.
+    auto* observer = reinterpret_cast<FrameMetricsObserver*>(observerPtr);
     renderthread::RenderProxy* renderProxy =
             reinterpret_cast<renderthread::RenderProxy*>(proxyPtr);
 
@@ -16,6 +16,9 @@
 
 #include "android_graphics_HardwareRendererObserver.h"
 
+#include <FrameMetricsRing.h>
+#include <fcntl.h>
+
 #include "graphics_jni_helpers.h"
 #include "nativehelper/jni_macros.h"
 
@@ -87,6 +90,22 @@ void HardwareRendererObserver::notify(const int64_t* stats) {
     }
 }
 
+// Observer handles handed to Java point at the FrameMetricsObserver base, whichever the concrete
+// observer, since that is what nAddObserver/nRemoveObserver take.
+static jlong toHandle(uirenderer::FrameMetricsObserver* observer) {
+    return reinterpret_cast<jlong>(observer);
+}
+
+static HardwareRendererObserver* toObserver(jlong handle) {
+    return static_cast<HardwareRendererObserver*>(
+            reinterpret_cast<uirenderer::FrameMetricsObserver*>(handle));
+}
+
+static uirenderer::FrameMetricsRing* toRing(jlong handle) {
+    return static_cast<uirenderer::FrameMetricsRing*>(
+            reinterpret_cast<uirenderer::FrameMetricsObserver*>(handle));
+}
+
 static jlong android_graphics_HardwareRendererObserver_createObserver(JNIEnv* env,
                                                                       jobject /*clazz*/,
                                                                       jobject weakRefThis,
@@ -99,13 +118,13 @@ static jlong android_graphics_HardwareRendererObserver_createObserver(JNIEnv* en
 
     HardwareRendererObserver* observer =
             new HardwareRendererObserver(vm, weakRefThis, waitForPresentTime);
-    return reinterpret_cast<jlong>(observer);
+    return toHandle(observer);
 }
 
 static jint android_graphics_HardwareRendererObserver_getNextBuffer(JNIEnv* env, jobject,
                                                                     jlong observerPtr,
                                                                     jlongArray metrics) {
-    HardwareRendererObserver* observer = reinterpret_cast<HardwareRendererObserver*>(observerPtr);
+    HardwareRendererObserver* observer = toObserver(observerPtr);
     int dropCount = 0;
     if (observer->getNextBuffer(env, metrics, &dropCount)) {
         return dropCount;
@@ -114,11 +133,122 @@ static jint android_graphics_HardwareRendererObserver_getNextBuffer(JNIEnv* env,
     }
 }
 
+// The returned pointer holds a strong reference, released by nReleaseSharedObserver. It is also
+// what nAddObserver/nRemoveObserver take.
+static jlong android_graphics_HardwareRendererObserver_createSharedObserver(
+        JNIEnv* env, jobject /*clazz*/, jint capacity, jboolean waitForPresentTime) {
+    sp<uirenderer::FrameMetricsRing> ring =
+            uirenderer::FrameMetricsRing::create(capacity, waitForPresentTime);
+    if (ring == nullptr) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+                          "Failed to allocate frame metrics shared memory");
+        return 0;
+    }
+    ring->incStrong(nullptr);
+    return toHandle(ring.get());
+}
+
+static void android_graphics_HardwareRendererObserver_releaseSharedObserver(JNIEnv*, jobject,
+                                                                            jlong ringPtr) {
+    toRing(ringPtr)->decStrong(nullptr);
+}
+
+// Returns a new read-only fd for the region, owned by the caller.
+static jint android_graphics_HardwareRendererObserver_dupSharedMemoryFd(JNIEnv*, jobject,
+                                                                        jlong ringPtr) {
+    auto* ring = toRing(ringPtr);
+    return fcntl(ring->getFd(), F_DUPFD_CLOEXEC, 0);
+}
+
+// cursorAndDropped holds {cursor, dropped}; both are updated. metrics receives whole FrameInfo
+// records back to back. Returns the number of records copied.
+static jint android_graphics_HardwareRendererObserver_readFrames(JNIEnv* env, jobject,
+                                                                 jlong ringPtr,
+                                                                 jlongArray cursorAndDropped,
+                                                                 jlongArray metrics) {
+    if (cursorAndDropped == nullptr || metrics == nullptr) {
+        jniThrowNullPointerException(env, nullptr);
+        return 0;
+    }
+    if (env->GetArrayLength(cursorAndDropped) < 2) {
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                          "cursorAndDropped must hold a cursor and a dropped count");
+        return 0;
+    }
+
+    auto* ring = toRing(ringPtr);
+    uirenderer::FrameMetricsRing::Reader reader(ring->getMapping(), ring->getSize());
+    const size_t maxRecords =
+            env->GetArrayLength(metrics) / uirenderer::FrameMetricsRing::kRecordWords;
+
+    jlong state[2];
+    env->GetLongArrayRegion(cursorAndDropped, 0, 2, state);
+    if (env->ExceptionCheck()) {
+        return 0;
+    }
+    uint64_t cursor = state[0];
+    uint64_t dropped = state[1];
+    // Copy straight into the Java array; no JNI calls happen while it is held.
+    auto* out = static_cast<int64_t*>(env->GetPrimitiveArrayCritical(metrics, nullptr));
+    if (out == nullptr) {
+        return 0;
+    }
+    const size_t count = reader.read(&cursor, out, maxRecords, &dropped);
+    env->ReleasePrimitiveArrayCritical(metrics, out, 0);
+    state[0] = cursor;
+    state[1] = dropped;
+    env->SetLongArrayRegion(cursorAndDropped, 0, 2, state);
+    return count;
+}
+
+// histogram receives {total frames, janky frames, frame count per bucket...} with buckets in
+// ProfileData::histogramForEach order. Returns false if no consistent snapshot could be taken, or
+// with an exception pending if histogram is null or not of that size.
+static jboolean android_graphics_HardwareRendererObserver_readHistogram(JNIEnv* env, jobject,
+                                                                        jlong ringPtr,
+                                                                        jintArray histogram) {
+    constexpr jsize kSize = 2 + uirenderer::ProfileData::HistogramSize();
+    if (histogram == nullptr) {
+        jniThrowNullPointerException(env, nullptr);
+        return false;
+    }
+    if (env->GetArrayLength(histogram) != kSize) {
+        jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException",
+                             "histogram must hold %d values", kSize);
+        return false;
+    }
+    auto* ring = toRing(ringPtr);
+    uirenderer::FrameMetricsRing::Reader reader(ring->getMapping(), ring->getSize());
+    uirenderer::ProfileData data;
+    if (!reader.readHistogram(&data)) {
+        return false;
+    }
+    std::array<jint, kSize> values;
+    values[0] = data.totalFrameCount();
+    values[1] = data.jankFrameCount();
+    size_t i = 2;
+    data.histogramForEach([&](uirenderer::ProfileData::HistogramEntry entry) {
+        values[i++] = entry.frameCount;
+    });
+    env->SetIntArrayRegion(histogram, 0, kSize, values.data());
+    return !env->ExceptionCheck();
+}
+
 static const std::array gMethods = {
         MAKE_JNI_NATIVE_METHOD("nCreateObserver", "(Ljava/lang/ref/WeakReference;Z)J",
                                android_graphics_HardwareRendererObserver_createObserver),
         MAKE_JNI_NATIVE_METHOD("nGetNextBuffer", "(J[J)I",
                                android_graphics_HardwareRendererObserver_getNextBuffer),
+        MAKE_JNI_NATIVE_METHOD("nCreateSharedObserver", "(IZ)J",
+                               android_graphics_HardwareRendererObserver_createSharedObserver),
+        MAKE_JNI_NATIVE_METHOD("nReleaseSharedObserver", "(J)V",
+                               android_graphics_HardwareRendererObserver_releaseSharedObserver),
+        MAKE_JNI_NATIVE_METHOD("nDupSharedMemoryFd", "(J)I",
+                               android_graphics_HardwareRendererObserver_dupSharedMemoryFd),
+        MAKE_JNI_NATIVE_METHOD("nReadFrames", "(J[J[J)I",
+                               android_graphics_HardwareRendererObserver_readFrames),
+        MAKE_JNI_NATIVE_METHOD("nReadHistogram", "(J[I)Z",
+                               android_graphics_HardwareRendererObserver_readHistogram),
 };
 
 int register_android_graphics_HardwareRendererObserver(JNIEnv* env) {
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DisplayListPool.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <iterator>
+
+#include "SkiaDisplayList.h"
+
+namespace android {
+namespace uirenderer {
+namespace skiapipeline {
+
+// Most views record well under 4KB of ops, so this is a few hundred spare lists at most.
+static constexpr size_t kDefaultMaxBytes = 2 * 1024 * 1024;
+static constexpr size_t kSmallestClassBytes = 4096;
+
+DisplayListPool& DisplayListPool::getInstance() {
+    static DisplayListPool* sInstance = new DisplayListPool(kDefaultMaxBytes);
+    return *sInstance;
+}
+
+DisplayListPool::DisplayListPool(size_t maxBytes) : mMaxBytes(maxBytes) {}
+
+DisplayListPool::~DisplayListPool() {
+    trim();
+}
+
+int DisplayListPool::sizeClassFor(size_t bytes) {
+    int sizeClass = 0;
+    for (size_t limit = kSmallestClassBytes * 2; bytes >= limit && sizeClass < kSizeClassCount;
+         limit *= 2) {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+std::unique_ptr<SkiaDisplayList> DisplayListPool::acquire(size_t sizeHint) {
+    std::unique_ptr<SkiaDisplayList> displayList;
+    {
+        std::lock_guard lock(mLock);
+        mStats.acquired++;
+        const int wanted = std::min(sizeClassFor(sizeHint), kSizeClassCount - 1);
+        // Prefer a list that will not have to grow its op buffer, then the largest smaller one.
+        for (int i = wanted; i < kSizeClassCount && !displayList; i++) {
+            if (!mFreeLists[i].empty()) {
+                displayList = std::move(mFreeLists[i].back());
+                mFreeLists[i].pop_back();
+            }
+        }
+        for (int i = wanted - 1; i >= 0 && !displayList; i--) {
+            if (!mFreeLists[i].empty()) {
+                displayList = std::move(mFreeLists[i].back());
+                mFreeLists[i].pop_back();
+            }
+        }
+        if (displayList) {
+            mStats.reused++;
+            mStats.pooledBytes -= displayList->getAllocatedSize();
+            mStats.pooledLists--;
+            return displayList;
+        }
+    }
+    return std::make_unique<SkiaDisplayList>();
+}
+
+void DisplayListPool::release(std::unique_ptr<SkiaDisplayList> displayList) {
+    if (!displayList) {
+        return;
+    }
+    // Resetting runs the destructors of everything that was recorded, so keep it outside the lock.
+    displayList->reset();
+    const size_t bytes = displayList->getAllocatedSize();
+    const int sizeClass = sizeClassFor(bytes);
+
+    std::lock_guard lock(mLock);
+    mStats.released++;
+    if (sizeClass >= kSizeClassCount || mFreeLists[sizeClass].size() >= kMaxListsPerClass ||
+        mStats.pooledBytes + bytes > mMaxBytes) {
+        mStats.discarded++;
+        return;
+    }
+    mFreeLists[sizeClass].push_back(std::move(displayList));
+    mStats.pooledBytes += bytes;
+    mStats.pooledLists++;
+}
+
+void DisplayListPool::trim() {
+    std::vector<std::unique_ptr<SkiaDisplayList>> freed;
+    {
+        std::lock_guard lock(mLock);
+        for (auto& freeList : mFreeLists) {
+            std::move(freeList.begin(), freeList.end(), std::back_inserter(freed));
+            freeList.clear();
+        }
+        mStats.pooledBytes = 0;
+        mStats.pooledLists = 0;
+    }
+}
+
+DisplayListPool::Stats DisplayListPool::getStats() {
+    std::lock_guard lock(mLock);
+    return mStats;
+}
+
+void DisplayListPool::dump(String8& log) {
+    Stats stats = getStats();
+    log.appendFormat("Display list pool:\n");
+    log.appendFormat("  Lists: %zu (%.2f MB of %.2f MB)\n", stats.pooledLists,
+                     stats.pooledBytes / 1000000.f, mMaxBytes / 1000000.f);
+    log.appendFormat("  Acquired: %" PRIu64 " (reused %" PRIu64 "), released: %" PRIu64
+                     " (discarded %" PRIu64 ")\n",
+                     stats.acquired, stats.reused, stats.released, stats.discarded);
+}
+
+}  // namespace skiapipeline
+}  // namespace uirenderer
+}  // namespace android
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <utils/Macros.h>
+#include <utils/String8.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace android {
+namespace uirenderer {
+namespace skiapipeline {
+
+class SkiaDisplayList;
+
+/**
+ * Process-wide pool of reset SkiaDisplayLists.
+ *
+ * RenderNode only keeps a single spare list around for its own next recording, so every other
+ * display list that is dropped (a staging list replaced before it was synced, the list of a node
+ * that is destroyed, or a second spare) used to be freed, and a new node would malloc its op
+ * buffer, child lists and image lists from scratch. Dropped lists are instead reset and kept here,
+ * bucketed by the capacity of their op buffer, so a recording can pick up one whose storage is
+ * already about the right size.
+ */
+class DisplayListPool {
+    PREVENT_COPY_AND_ASSIGN(DisplayListPool);
+
+public:
+    struct Stats {
+        uint64_t acquired = 0;
+        // Acquisitions served from the pool rather than by allocating a new list.
+        uint64_t reused = 0;
+        uint64_t released = 0;
+        // Released lists that were freed because the pool was full or the list too large.
+        uint64_t discarded = 0;
+        size_t pooledBytes = 0;
+        size_t pooledLists = 0;
+    };
+
+    // Op buffers grow in 4KB pages; size class i holds lists with less than 4KB << (i + 1).
+    static constexpr int kSizeClassCount = 6;
+    static constexpr size_t kMaxListsPerClass = 32;
+
+    static DisplayListPool& getInstance();
+
+    explicit DisplayListPool(size_t maxBytes);
+    ~DisplayListPool();
+
+    /**
+     * Returns an empty display list, preferring a pooled one whose op buffer can already hold
+     * sizeHint bytes. Never returns nullptr.
+     */
+    std::unique_ptr<SkiaDisplayList> acquire(size_t sizeHint);
+
+    // Resets displayList and keeps it for a later acquire(), or frees it if the pool is full.
+    void release(std::unique_ptr<SkiaDisplayList> displayList);
+
+    // Frees every pooled list.
+    void trim();
+
+    Stats getStats();
+    void dump(String8& log);
+
+    static int sizeClassFor(size_t bytes);
+
+private:
+    const size_t mMaxBytes;
+
+    std::mutex mLock;
+    std::vector<std::unique_ptr<SkiaDisplayList>> mFreeLists[kSizeClassCount];
+    Stats mStats;
+};
+
+}  // namespace skiapipeline
+}  // namespace uirenderer
+}  // namespace android
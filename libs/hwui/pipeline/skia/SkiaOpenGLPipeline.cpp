@@ -192,8 +192,9 @@ IRenderPipeline::DrawResult SkiaOpenGLPipeline::draw(
 }
 
 bool SkiaOpenGLPipeline::swapBuffers(const Frame& frame, IRenderPipeline::DrawResult& drawResult,
-                                     const SkRect& screenDirty, FrameInfo* currentFrameInfo,
-                                     bool* requireSwap) {
+                                     const SkRect& screenDirty,
+                                     const DamageAccumulator::DamageRects& damageRects,
+                                     FrameInfo* currentFrameInfo, bool* requireSwap) {
     GL_CHECKPOINT(LOW);
 
     // Even if we decided to cancel the frame, from the perspective of jank
@@ -206,7 +207,7 @@ bool SkiaOpenGLPipeline::swapBuffers(const Frame& frame, IRenderPipeline::DrawRe
 
     *requireSwap = drawResult.success || mEglManager.damageRequiresSwap();
 
-    if (*requireSwap && (CC_UNLIKELY(!mEglManager.swapBuffers(frame, screenDirty)))) {
+    if (*requireSwap && (CC_UNLIKELY(!mEglManager.swapBuffers(frame, screenDirty, damageRects)))) {
         return false;
     }
 
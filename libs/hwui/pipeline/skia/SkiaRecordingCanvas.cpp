@@ -38,6 +38,7 @@
 #include "RenderNode.h"
 #include "pipeline/skia/AnimatedDrawables.h"
 #include "pipeline/skia/BackdropFilterDrawable.h"
+#include "pipeline/skia/DisplayListPool.h"
 #ifdef __ANDROID__ // Layoutlib does not support GL, Vulcan etc.
 #include "pipeline/skia/GLFunctorDrawable.h"
 #include "pipeline/skia/VkFunctorDrawable.h"
@@ -59,11 +60,13 @@ void SkiaRecordingCanvas::initDisplayList(uirenderer::RenderNode* renderNode, in
     mCurrentBarrier = nullptr;
     LOG_FATAL_IF(mDisplayList.get() != nullptr);
 
+    size_t sizeHint = 0;
     if (renderNode) {
         mDisplayList = renderNode->detachAvailableList();
+        sizeHint = renderNode->getStagingDisplayListUsedSize();
     }
     if (!mDisplayList) {
-        mDisplayList.reset(new SkiaDisplayList());
+        mDisplayList = DisplayListPool::getInstance().acquire(sizeHint);
     }
 
     mDisplayList->attachRecorder(&mRecorder, SkIRect::MakeWH(width, height));
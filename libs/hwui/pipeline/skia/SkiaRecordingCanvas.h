@@ -95,7 +95,8 @@ private:
     static void FilterForImage(SkPaint&);
 
     /**
-     *  A new SkiaDisplayList is created or recycled if available.
+     *  The renderNode's available SkiaDisplayList is recycled if it has one, otherwise one is
+     *  taken from the DisplayListPool.
      *
      *  @param renderNode is optional and used to recycle an old display list.
      *  @param width used to calculate recording bounds.
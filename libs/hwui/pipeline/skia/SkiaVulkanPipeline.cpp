@@ -127,8 +127,9 @@ IRenderPipeline::DrawResult SkiaVulkanPipeline::draw(
 }
 
 bool SkiaVulkanPipeline::swapBuffers(const Frame& frame, IRenderPipeline::DrawResult& drawResult,
-                                     const SkRect& screenDirty, FrameInfo* currentFrameInfo,
-                                     bool* requireSwap) {
+                                     const SkRect& screenDirty,
+                                     const DamageAccumulator::DamageRects& damageRects,
+                                     FrameInfo* currentFrameInfo, bool* requireSwap) {
     // Even if we decided to cancel the frame, from the perspective of jank
     // metrics the frame was swapped at this point
     currentFrameInfo->markSwapBuffers();
@@ -140,7 +141,8 @@ bool SkiaVulkanPipeline::swapBuffers(const Frame& frame, IRenderPipeline::DrawRe
     *requireSwap = drawResult.success;
 
     if (*requireSwap) {
-        vulkanManager().swapBuffers(mVkSurface, screenDirty, std::move(drawResult.presentFence));
+        vulkanManager().swapBuffers(mVkSurface, screenDirty, damageRects,
+                                    std::move(drawResult.presentFence));
     }
 
     return *requireSwap;
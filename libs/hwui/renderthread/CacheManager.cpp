@@ -31,11 +31,14 @@
 #include "Properties.h"
 #include "RenderThread.h"
 #include "VulkanManager.h"
+#include "hwui/AnimatedImageDrawable.h"
 #include "pipeline/skia/ATraceMemoryDump.h"
+#include "pipeline/skia/DisplayListPool.h"
 #include "pipeline/skia/ShaderCache.h"
 #include "pipeline/skia/SkiaMemoryTracer.h"
 #include "renderstate/RenderState.h"
 #include "thread/CommonPool.h"
+#include "utils/EventTrace.h"
 
 namespace android {
 namespace uirenderer {
@@ -120,17 +123,21 @@ void CacheManager::trimMemory(TrimLevel mode) {
     if (!mGrContext) {
         return;
     }
+    HWUI_EVENT_SCOPE("CacheManager::trimMemory");
 
     // flush and submit all work to the gpu and wait for it to finish
     mGrContext->flushAndSubmit(GrSyncCpu::kYes);
 
     switch (mode) {
         case TrimLevel::BACKGROUND:
+            AnimatedImageDrawable::trimFrameCaches();
+            skiapipeline::DisplayListPool::getInstance().trim();
             mGrContext->freeGpuResources();
             SkGraphics::PurgeAllCaches();
             mRenderThread.destroyRenderingContext();
             break;
         case TrimLevel::UI_HIDDEN:
+            AnimatedImageDrawable::trimFrameCaches();
             // Here we purge all the unlocked scratch resources and then toggle the resources cache
             // limits between the background and max amounts. This causes the unlocked resources
             // that have persistent data to be purged in LRU order.
@@ -146,6 +153,7 @@ void CacheManager::trimMemory(TrimLevel mode) {
 }
 
 void CacheManager::trimCaches(CacheTrimLevel mode) {
+    HWUI_EVENT_SCOPE("CacheManager::trimCaches");
     switch (mode) {
         case CacheTrimLevel::FONT_CACHE:
             SkGraphics::PurgeFontCache();
@@ -155,6 +163,8 @@ void CacheManager::trimCaches(CacheTrimLevel mode) {
             break;
         case CacheTrimLevel::ALL_CACHES:
             SkGraphics::PurgeAllCaches();
+            AnimatedImageDrawable::trimFrameCaches();
+            skiapipeline::DisplayListPool::getInstance().trim();
             if (mGrContext) {
                 mGrContext->purgeUnlockedResources(GrPurgeResourceOptions::kAllResources);
             }
@@ -168,6 +178,7 @@ void CacheManager::trimStaleResources() {
     if (!mGrContext) {
         return;
     }
+    HWUI_EVENT_SCOPE("CacheManager::trimStaleResources");
     mGrContext->flushAndSubmit();
     mGrContext->performDeferredCleanup(std::chrono::seconds(30),
                                        GrPurgeResourceOptions::kAllResources);
@@ -39,6 +39,7 @@
 #include "pipeline/skia/SkiaPipeline.h"
 #include "pipeline/skia/SkiaVulkanPipeline.h"
 #include "thread/CommonPool.h"
+#include "utils/EventTrace.h"
 #include "utils/GLUtils.h"
 #include "utils/TimeUtils.h"
 
@@ -129,6 +130,7 @@ CanvasContext::CanvasContext(RenderThread& thread, bool translucent, RenderNode*
     rootRenderNode->makeRoot();
     mRenderNodes.emplace_back(rootRenderNode);
     mProfiler.setDensity(DeviceInfo::getDensity());
+    mDamageAccumulator.setTrackDamageRects(true);
 }
 
 CanvasContext::~CanvasContext() {
@@ -407,6 +409,7 @@ bool CanvasContext::isSwapChainStuffed() {
 
 void CanvasContext::prepareTree(TreeInfo& info, int64_t* uiFrameInfo, int64_t syncQueued,
                                 RenderNode* target) {
+    HWUI_EVENT_SCOPE("CanvasContext::prepareTree");
     mRenderThread.removeFrameCallback(this);
 
     // If the previous frame was dropped we don't need to hold onto it, so
@@ -560,6 +563,7 @@ Frame CanvasContext::getFrame() {
 }
 
 void CanvasContext::draw(bool solelyTextureViewUpdates) {
+    HWUI_EVENT_SCOPE("CanvasContext::draw");
     if (auto grContext = getGrContext()) {
         if (grContext->abandoned()) {
             if (grContext->isDeviceLost()) {
@@ -571,7 +575,9 @@ void CanvasContext::draw(bool solelyTextureViewUpdates) {
         }
     }
     SkRect dirty;
-    mDamageAccumulator.finish(&dirty);
+    DamageAccumulator::DamageRects damageRects;
+    mDamageAccumulator.finish(&dirty, &damageRects);
+    const SkRect accumulatedDirty = dirty;
 
     // reset syncDelayDuration each time we draw
     nsecs_t syncDelayDuration = mSyncDelayDuration;
@@ -618,6 +624,10 @@ void CanvasContext::draw(bool solelyTextureViewUpdates) {
     Frame frame = getFrame();
 
     SkRect windowDirty = computeDirtyRect(frame, &dirty);
+    if (windowDirty != accumulatedDirty) {
+        // The window damage was clipped or grown, so the rects no longer add up to it.
+        damageRects.clear();
+    }
 
     ATRACE_FORMAT("Drawing " RECT_STRING, SK_RECT_ARGS(dirty));
 
@@ -659,8 +669,8 @@ void CanvasContext::draw(bool solelyTextureViewUpdates) {
     bool didDraw = false;
 
     int error = OK;
-    bool didSwap = mRenderPipeline->swapBuffers(frame, drawResult, windowDirty, mCurrentFrameInfo,
-                                                &requireSwap);
+    bool didSwap = mRenderPipeline->swapBuffers(frame, drawResult, windowDirty, damageRects,
+                                                mCurrentFrameInfo, &requireSwap);
 
     mCurrentFrameInfo->set(FrameInfoIndex::CommandSubmissionCompleted) = std::max(
             drawResult.commandSubmissionTime, mCurrentFrameInfo->get(FrameInfoIndex::SwapBuffers));
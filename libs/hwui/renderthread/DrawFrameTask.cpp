@@ -28,6 +28,7 @@
 #include "CanvasContext.h"
 #include "HardwareBufferRenderParams.h"
 #include "RenderThread.h"
+#include "utils/EventTrace.h"
 
 namespace android {
 namespace uirenderer {
@@ -89,6 +90,7 @@ void DrawFrameTask::postAndWait() {
 void DrawFrameTask::run() {
     const int64_t vsyncId = mFrameInfo[static_cast<int>(FrameInfoIndex::FrameTimelineVsyncId)];
     ATRACE_FORMAT("DrawFrames %" PRId64, vsyncId);
+    HWUI_EVENT_SCOPE("DrawFrameTask::run");
 
     mContext->setSyncDelayDuration(systemTime(SYSTEM_TIME_MONOTONIC) - mSyncQueued);
     mContext->setTargetSdrHdrRatio(mRenderSdrHdrRatio);
@@ -166,6 +168,7 @@ void DrawFrameTask::run() {
 
 bool DrawFrameTask::syncFrameState(TreeInfo& info) {
     ATRACE_CALL();
+    HWUI_EVENT_SCOPE("DrawFrameTask::syncFrameState");
     int64_t vsync = mFrameInfo[static_cast<int>(FrameInfoIndex::Vsync)];
     int64_t intendedVsync = mFrameInfo[static_cast<int>(FrameInfoIndex::IntendedVsync)];
     int64_t vsyncId = mFrameInfo[static_cast<int>(FrameInfoIndex::FrameTimelineVsyncId)];
@@ -599,15 +599,24 @@ bool EglManager::damageRequiresSwap() {
     return EglExtensions.setDamage && mSwapBehavior == SwapBehavior::BufferAge;
 }
 
-bool EglManager::swapBuffers(const Frame& frame, const SkRect& screenDirty) {
+bool EglManager::swapBuffers(const Frame& frame, const SkRect& screenDirty,
+                             const DamageAccumulator::DamageRects& damageRects) {
     if (CC_UNLIKELY(Properties::waitForGpuCompletion)) {
         ATRACE_NAME("Finishing GPU work");
         fence();
     }
 
-    EGLint rects[4];
-    frame.map(screenDirty, rects);
-    eglSwapBuffersWithDamageKHR(mEglDisplay, frame.mSurface, rects, screenDirty.isEmpty() ? 0 : 1);
+    EGLint rects[4 * DamageAccumulator::kMaxDamageRects];
+    EGLint rectCount = 0;
+    if (!damageRects.empty()) {
+        for (const SkRect& rect : damageRects) {
+            frame.map(rect, rects + 4 * rectCount++);
+        }
+    } else if (!screenDirty.isEmpty()) {
+        frame.map(screenDirty, rects);
+        rectCount = 1;
+    }
+    eglSwapBuffersWithDamageKHR(mEglDisplay, frame.mSurface, rects, rectCount);
 
     EGLint err = eglGetError();
     if (CC_LIKELY(err == EGL_SUCCESS)) {
@@ -63,7 +63,8 @@ public:
     // if damageFrame is called without subsequent calls to damageFrame().
     // See EGL_KHR_partial_update for more information
     bool damageRequiresSwap();
-    bool swapBuffers(const Frame& frame, const SkRect& screenDirty);
+    bool swapBuffers(const Frame& frame, const SkRect& screenDirty,
+                     const DamageAccumulator::DamageRects& damageRects);
 
     // Returns true iff the surface is now preserving buffers.
     bool setPreserveBuffer(EGLSurface surface, bool preserve);
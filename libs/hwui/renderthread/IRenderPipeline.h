@@ -70,9 +70,12 @@ public:
                             FrameInfoVisualizer* profiler,
                             const HardwareBufferRenderParams& bufferParams,
                             std::mutex& profilerLock) = 0;
+    // damageRects, if not empty, are the separate parts of screenDirty that changed, and are
+    // reported to the compositor as the surface damage instead of screenDirty.
     virtual bool swapBuffers(const Frame& frame, IRenderPipeline::DrawResult&,
-                             const SkRect& screenDirty, FrameInfo* currentFrameInfo,
-                             bool* requireSwap) = 0;
+                             const SkRect& screenDirty,
+                             const DamageAccumulator::DamageRects& damageRects,
+                             FrameInfo* currentFrameInfo, bool* requireSwap) = 0;
     virtual DeferredLayerUpdater* createTextureLayer() = 0;
     [[nodiscard]] virtual android::base::unique_fd flush() = 0;
     virtual void setHardwareBuffer(AHardwareBuffer* hardwareBuffer) = 0;
@@ -29,9 +29,11 @@
 #include "Readback.h"
 #include "Rect.h"
 #include "WebViewFunctorManager.h"
+#include "hwui/BitmapParcelCache.h"
 #include "renderthread/CanvasContext.h"
 #include "renderthread/RenderTask.h"
 #include "renderthread/RenderThread.h"
+#include "utils/EventTrace.h"
 #include "utils/Macros.h"
 #include "utils/TimeUtils.h"
 
@@ -224,6 +226,11 @@ void RenderProxy::destroyHardwareResources() {
 }
 
 void RenderProxy::trimMemory(int level) {
+    // Bitmaps are parceled whether or not anything is drawn, so the parcel cache is trimmed here
+    // rather than by the RenderThread's CacheManager, which only trims with a GrContext.
+    if (level >= static_cast<int>(TrimLevel::RUNNING_LOW)) {
+        BitmapParcelCache::getInstance().trim();
+    }
     // Avoid creating a RenderThread to do a trimMemory.
     if (RenderThread::hasInstance()) {
         RenderThread& thread = RenderThread::getInstance();
@@ -233,6 +240,9 @@ void RenderProxy::trimMemory(int level) {
 }
 
 void RenderProxy::trimCaches(int level) {
+    if (static_cast<CacheTrimLevel>(level) == CacheTrimLevel::ALL_CACHES) {
+        BitmapParcelCache::getInstance().trim();
+    }
     // Avoid creating a RenderThread to do a trimMemory.
     if (RenderThread::hasInstance()) {
         RenderThread& thread = RenderThread::getInstance();
@@ -331,6 +341,11 @@ void RenderProxy::dumpGraphicsMemory(int fd, bool includeProfileData, bool reset
     }
 }
 
+void RenderProxy::dumpEventTrace(int fd) {
+    // The trace is lock-free to read, so there is no need to bounce through the RenderThread.
+    EventTrace::dumpJson(fd);
+}
+
 void RenderProxy::getMemoryUsage(size_t* cpuUsage, size_t* gpuUsage) {
     if (RenderThread::hasInstance()) {
         auto& thread = RenderThread::getInstance();
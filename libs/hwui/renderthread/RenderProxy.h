@@ -58,6 +58,8 @@ enum {
     FrameStats = 1 << 0,
     Reset = 1 << 1,
     JankStats = 1 << 2,
+    // Instead of the usual text, dump the recorded HWUI_EVENT_SCOPEs as a JSON trace.
+    EventTrace = 1 << 3,
 };
 }
 
@@ -123,6 +125,7 @@ public:
     uint32_t frameTimePercentile(int p);
     static void dumpGraphicsMemory(int fd, bool includeProfileData = true,
                                    bool resetProfile = false);
+    static void dumpEventTrace(int fd);
     static void getMemoryUsage(size_t* cpuUsage, size_t* gpuUsage);
 
     static void rotateProcessStatsBuffer();
@@ -40,6 +40,8 @@
 #include "RenderProxy.h"
 #include "VulkanManager.h"
 #include "hwui/Bitmap.h"
+#include "hwui/BitmapParcelCache.h"
+#include "pipeline/skia/DisplayListPool.h"
 #include "pipeline/skia/SkiaOpenGLPipeline.h"
 #include "pipeline/skia/SkiaVulkanPipeline.h"
 #include "renderstate/RenderState.h"
@@ -358,6 +360,8 @@ void RenderThread::dumpGraphicsMemory(int fd, bool includeProfileData) {
 
     String8 cachesOutput;
     mCacheManager->dumpMemoryUsage(cachesOutput, mRenderState);
+    BitmapParcelCache::getInstance().dump(cachesOutput);
+    skiapipeline::DisplayListPool::getInstance().dump(cachesOutput);
     dprintf(fd, "\nPipeline=%s\n%s", pipelineToString(), cachesOutput.c_str());
     for (auto&& context : mCacheManager->mCanvasContexts) {
         context->visitAllRenderNodes([&](const RenderNode& node) {
@@ -635,13 +635,14 @@ VulkanManager::VkDrawResult VulkanManager::finishFrame(SkSurface* surface) {
 }
 
 void VulkanManager::swapBuffers(VulkanSurface* surface, const SkRect& dirtyRect,
+                                const DamageAccumulator::DamageRects& damageRects,
                                 android::base::unique_fd&& presentFence) {
     if (CC_UNLIKELY(Properties::waitForGpuCompletion)) {
         ATRACE_NAME("Finishing GPU work");
         mDeviceWaitIdle(mDevice);
     }
 
-    surface->presentCurrentBuffer(dirtyRect, presentFence.release());
+    surface->presentCurrentBuffer(dirtyRect, damageRects, presentFence.release());
 }
 
 void VulkanManager::destroySurface(VulkanSurface* surface) {
@@ -93,6 +93,7 @@ public:
     // Finishes the frame and submits work to the GPU
     VkDrawResult finishFrame(SkSurface* surface);
     void swapBuffers(VulkanSurface* surface, const SkRect& dirtyRect,
+                     const DamageAccumulator::DamageRects& damageRects,
                      android::base::unique_fd&& presentFence);
 
     // Inserts a wait on fence command into the Vulkan command buffer.
@@ -485,23 +485,37 @@ VulkanSurface::NativeBufferInfo* VulkanSurface::dequeueNativeBuffer() {
     return bufferInfo;
 }
 
-bool VulkanSurface::presentCurrentBuffer(const SkRect& dirtyRect, int semaphoreFd) {
+bool VulkanSurface::presentCurrentBuffer(const SkRect& dirtyRect,
+                                         const DamageAccumulator::DamageRects& damageRects,
+                                         int semaphoreFd) {
     if (!dirtyRect.isEmpty()) {
 
-        // native_window_set_surface_damage takes a rectangle in prerotated space
+        // native_window_set_surface_damage takes rectangles in prerotated space
         // with a bottom-left origin. That is, top > bottom.
-        // The dirtyRect is also in prerotated space, so we just need to switch it to
-        // a bottom-left origin space.
-
-        SkIRect irect;
-        dirtyRect.roundOut(&irect);
-        android_native_rect_t aRect;
-        aRect.left = irect.left();
-        aRect.top = logicalHeight() - irect.top();
-        aRect.right = irect.right();
-        aRect.bottom = logicalHeight() - irect.bottom();
-
-        int err = native_window_set_surface_damage(mNativeWindow.get(), &aRect, 1);
+        // The dirtyRect and damageRects are also in prerotated space, so we just need to
+        // switch them to a bottom-left origin space.
+        const auto toNativeRect = [this](const SkRect& rect) {
+            SkIRect irect;
+            rect.roundOut(&irect);
+            android_native_rect_t aRect;
+            aRect.left = irect.left();
+            aRect.top = logicalHeight() - irect.top();
+            aRect.right = irect.right();
+            aRect.bottom = logicalHeight() - irect.bottom();
+            return aRect;
+        };
+
+        android_native_rect_t aRects[DamageAccumulator::kMaxDamageRects];
+        size_t rectCount = 0;
+        if (!damageRects.empty()) {
+            for (const SkRect& rect : damageRects) {
+                aRects[rectCount++] = toNativeRect(rect);
+            }
+        } else {
+            aRects[rectCount++] = toNativeRect(dirtyRect);
+        }
+
+        int err = native_window_set_surface_damage(mNativeWindow.get(), aRects, rectCount);
         ALOGE_IF(err != 0, "native_window_set_surface_damage failed: %s (%d)", strerror(-err), err);
     }
 
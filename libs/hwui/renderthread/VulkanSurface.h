@@ -70,7 +70,8 @@ private:
 
     NativeBufferInfo* dequeueNativeBuffer();
     NativeBufferInfo* getCurrentBufferInfo() { return mCurrentBufferInfo; }
-    bool presentCurrentBuffer(const SkRect& dirtyRect, int semaphoreFd);
+    bool presentCurrentBuffer(const SkRect& dirtyRect,
+                              const DamageAccumulator::DamageRects& damageRects, int semaphoreFd);
 
     // The width and height are are the logical width and height for when submitting draws to the
     // surface. In reality if the window is rotated the underlying window may have the width and
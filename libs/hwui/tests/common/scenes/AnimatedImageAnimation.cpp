@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <SkAndroidCodec.h>
+#include <SkAnimatedImage.h>
+#include <SkBitmap.h>
+#include <SkBlendMode.h>
+#include <SkCodec.h>
+#include <SkData.h>
+#include <SkEncoder.h>
+#include <SkStream.h>
+#include <SkWebpEncoder.h>
+
+#include <cstdio>
+#include <vector>
+
+#include "TestSceneBase.h"
+#include "hwui/AnimatedImageDrawable.h"
+
+class AnimatedImageAnimation;
+
+static TestScene* createAnimatedImage(const TestScene::Options&);
+static TestScene* createAnimatedImageDecodeAhead(const TestScene::Options&);
+static TestScene* createAnimatedImageFrameCache(const TestScene::Options&);
+
+static TestScene::Registrar _AnimatedImage(TestScene::Info{
+        "animatedImage",
+        "Plays an expensive to decode animated WebP, decoding one frame ahead. Prints the number "
+        "of frames shown late at the end.",
+        createAnimatedImage});
+
+static TestScene::Registrar _AnimatedImageDecodeAhead(TestScene::Info{
+        "animatedImageDecodeAhead",
+        "Same as animatedImage, but keeps three frames decoded ahead of the one shown.",
+        createAnimatedImageDecodeAhead});
+
+static TestScene::Registrar _AnimatedImageFrameCache(TestScene::Info{
+        "animatedImageFrameCache",
+        "Same as animatedImageDecodeAhead, but keeps every decoded frame so later loops do not "
+        "decode at all.",
+        createAnimatedImageFrameCache});
+
+class AnimatedImageAnimation : public TestScene {
+public:
+    AnimatedImageAnimation(const char* name, int decodeAhead, bool cacheFrames)
+            : mName(name), mDecodeAhead(decodeAhead), mCacheFrames(cacheFrames) {}
+
+    ~AnimatedImageAnimation() override {
+        if (!mDrawable) return;
+        auto stats = mDrawable->getFrameStats();
+        printf("%s: %u frames shown, %u late, %u from cache\n", mName, stats.framesShown,
+               stats.framesLate, stats.framesFromCache);
+    }
+
+    void createContent(int width, int height, Canvas& canvas) override {
+        canvas.drawColor(Color::White, SkBlendMode::kSrcOver);
+
+        sk_sp<SkAnimatedImage> image = createAnimatedImage(kImageSize, kImageSize);
+        LOG_ALWAYS_FATAL_IF(!image, "Failed to create animated image");
+        mDrawable = sk_make_sp<AnimatedImageDrawable>(std::move(image), 0,
+                                                      SkEncodedImageFormat::kWEBP);
+        mDrawable->setStagingBounds(SkRect::MakeWH(width, height));
+        mDrawable->setDecodeAhead(mDecodeAhead, mCacheFrames);
+        mDrawable->start();
+
+        mCard = TestUtils::createNode(0, 0, width, height,
+                                      [this](RenderProperties& props, Canvas& canvas) {
+                                          canvas.drawAnimatedImage(mDrawable.get());
+                                      });
+        canvas.drawRenderNode(mCard.get());
+    }
+
+    void doFrame(int frameNr) override {}
+
+private:
+    // Small enough for all frames to fit in AnimatedImageDrawable's frame cache.
+    static constexpr int kImageSize = 512;
+    static constexpr int kFrameCount = 8;
+    static constexpr int kFrameDurationMs = 16;
+
+    // Noise compresses poorly, so each frame takes a while to decode, and lossless WebP keeps
+    // the frames full size rather than letting the encoder skip unchanged regions.
+    static sk_sp<SkAnimatedImage> createAnimatedImage(int width, int height) {
+        std::vector<SkBitmap> bitmaps(kFrameCount);
+        std::vector<SkEncoder::Frame> frames(kFrameCount);
+        uint32_t seed = 1;
+        for (int i = 0; i < kFrameCount; i++) {
+            bitmaps[i].allocPixels(SkImageInfo::MakeN32Premul(width, height));
+            for (int y = 0; y < height; y++) {
+                uint32_t* row = bitmaps[i].getAddr32(0, y);
+                for (int x = 0; x < width; x++) {
+                    seed = seed * 1664525 + 1013904223;
+                    row[x] = seed | 0xFF000000;
+                }
+            }
+            frames[i].pixmap = bitmaps[i].pixmap();
+            frames[i].duration = kFrameDurationMs;
+        }
+
+        SkDynamicMemoryWStream stream;
+        SkWebpEncoder::Options options;
+        options.fCompression = SkWebpEncoder::Compression::kLossless;
+        options.fQuality = 0;
+        if (!SkWebpEncoder::EncodeAnimated(&stream, frames, options)) {
+            return nullptr;
+        }
+        auto codec = SkAndroidCodec::MakeFromCodec(SkCodec::MakeFromData(stream.detachAsData()));
+        if (!codec) {
+            return nullptr;
+        }
+        return SkAnimatedImage::Make(std::move(codec));
+    }
+
+    const char* mName;
+    const int mDecodeAhead;
+    const bool mCacheFrames;
+    sk_sp<AnimatedImageDrawable> mDrawable;
+    sp<RenderNode> mCard;
+};
+
+static TestScene* createAnimatedImage(const TestScene::Options&) {
+    return new AnimatedImageAnimation("animatedImage", 1, false);
+}
+
+static TestScene* createAnimatedImageDecodeAhead(const TestScene::Options&) {
+    return new AnimatedImageAnimation("animatedImageDecodeAhead", 3, false);
+}
+
+static TestScene* createAnimatedImageFrameCache(const TestScene::Options&) {
+    return new AnimatedImageAnimation("animatedImageFrameCache", 3, true);
+}
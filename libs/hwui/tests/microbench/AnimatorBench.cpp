@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "AnimationContext.h"
+#include "Animator.h"
+#include "CanvasProperty.h"
+#include "IContextFactory.h"
+#include "Interpolator.h"
+#include "RenderNode.h"
+#include "TreeInfo.h"
+#include "renderthread/CanvasContext.h"
+#include "renderthread/RenderThread.h"
+#include "renderthread/TimeLord.h"
+#include "tests/common/TestUtils.h"
+
+#include <vector>
+
+using namespace android;
+using namespace android::uirenderer;
+using namespace android::uirenderer::renderthread;
+
+class AnimatorBenchContextFactory : public IContextFactory {
+public:
+    virtual AnimationContext* createAnimationContext(TimeLord& clock) override {
+        return new AnimationContext(clock);
+    }
+};
+
+static void advanceFrame(TimeLord& timeLord, nsecs_t* frameTime) {
+    constexpr nsecs_t kFrameInterval = 16666667;
+    *frameTime += kFrameInterval;
+    timeLord.vsyncReceived(*frameTime, *frameTime, 1, *frameTime + kFrameInterval,
+                           kFrameInterval);
+}
+
+// One frame of 1,000 animators running on a single node. range(0) picks the interpolator: the
+// default AccelerateDecelerate (0) or a 100 point PathInterpolator like the one a
+// PathInterpolator(0.4, 0, 0.2, 1) resolves to (1).
+void BM_AnimatorManager_animate1000(benchmark::State& state) {
+    constexpr int kAnimatorCount = 1000;
+    const bool usePath = state.range(0);
+    TestUtils::runOnRenderThreadUnmanaged([&](RenderThread& thread) {
+        auto node = TestUtils::createNode(0, 0, 100, 100, nullptr);
+        AnimatorBenchContextFactory factory;
+        std::unique_ptr<CanvasContext> canvasContext(
+                CanvasContext::create(thread, false, node.get(), &factory, 0, 0));
+        TreeInfo info(TreeInfo::MODE_RT_ONLY, *canvasContext);
+        AnimationContext context(thread.timeLord());
+
+        std::vector<sp<CanvasPropertyPrimitive>> properties;
+        for (int i = 0; i < kAnimatorCount; i++) {
+            sp<CanvasPropertyPrimitive> property = new CanvasPropertyPrimitive(0);
+            sp<BaseRenderNodeAnimator> animator =
+                    new CanvasPropertyPrimitiveAnimator(property.get(), 100);
+            animator->setStartValue(0);
+            animator->setDuration(1000 * 1000 * 1000);
+            if (usePath) {
+                std::vector<float> x, y;
+                for (int p = 0; p <= 100; p++) {
+                    const float t = p / 100.0f;
+                    x.push_back(3 * (1 - t) * (1 - t) * t * 0.4f + 3 * (1 - t) * t * t * 0.2f +
+                                t * t * t);
+                    y.push_back(3 * (1 - t) * t * t + t * t * t);
+                }
+                animator->setInterpolator(new PathInterpolator(std::move(x), std::move(y)));
+            }
+            animator->start();
+            node->addAnimator(animator);
+            properties.push_back(property);
+        }
+        context.addAnimatingRenderNode(*node);
+
+        nsecs_t frameTime = systemTime(SYSTEM_TIME_MONOTONIC);
+        advanceFrame(thread.timeLord(), &frameTime);
+        // The first frame starts the animators.
+        context.startFrame(TreeInfo::MODE_RT_ONLY);
+        context.runRemainingAnimations(info);
+
+        for (auto _ : state) {
+            advanceFrame(thread.timeLord(), &frameTime);
+            context.startFrame(TreeInfo::MODE_RT_ONLY);
+            context.runRemainingAnimations(info);
+            benchmark::DoNotOptimize(properties.back()->value);
+        }
+
+        context.destroy();
+    });
+}
+BENCHMARK(BM_AnimatorManager_animate1000)->Arg(0)->Arg(1);
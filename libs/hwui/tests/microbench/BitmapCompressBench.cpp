@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <SkCanvas.h>
+#include <SkColor.h>
+#include <SkJpegEncoder.h>
+#include <SkPaint.h>
+#include <SkStream.h>
+
+#include "hwui/Bitmap.h"
+
+using namespace android;
+
+// Something that compresses roughly like a 4K screenshot: flat backgrounds, cards and lots of
+// small high contrast shapes standing in for text.
+static SkBitmap createScreenshot() {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32Premul(3840, 2160));
+    SkCanvas canvas(bitmap);
+    canvas.clear(SK_ColorWHITE);
+    SkPaint paint;
+    for (int y = 0; y < 2160; y += 240) {
+        paint.setColor(SkColorSetRGB(y % 256, 180, 255 - y % 256));
+        canvas.drawRect(SkRect::MakeXYWH(40, y + 20, 3760, 200), paint);
+        paint.setColor(SK_ColorBLACK);
+        for (int x = 80; x < 3700; x += 14) {
+            canvas.drawRect(SkRect::MakeXYWH(x, y + 60 + (x % 5), 9, 18 + (x % 7)), paint);
+        }
+    }
+    return bitmap;
+}
+
+static void BM_BitmapCompress_jpeg(benchmark::State& state) {
+    SkBitmap bitmap = createScreenshot();
+    for (auto _ : state) {
+        SkNullWStream stream;
+        Bitmap::compress(bitmap, Bitmap::JavaCompressFormat::Jpeg, 90, &stream,
+                         /* allowBandedJpeg */ true);
+        benchmark::DoNotOptimize(stream.bytesWritten());
+    }
+    state.SetBytesProcessed(state.iterations() * bitmap.computeByteSize());
+}
+BENCHMARK(BM_BitmapCompress_jpeg)->Unit(benchmark::kMillisecond);
+
+static void BM_BitmapCompress_jpegSingleThreaded(benchmark::State& state) {
+    SkBitmap bitmap = createScreenshot();
+    SkJpegEncoder::Options options;
+    options.fQuality = 90;
+    for (auto _ : state) {
+        SkNullWStream stream;
+        SkJpegEncoder::Encode(&stream, bitmap.pixmap(), options);
+        benchmark::DoNotOptimize(stream.bytesWritten());
+    }
+    state.SetBytesProcessed(state.iterations() * bitmap.computeByteSize());
+}
+BENCHMARK(BM_BitmapCompress_jpegSingleThreaded)->Unit(benchmark::kMillisecond);
+
+static void BM_BitmapCompress_png(benchmark::State& state) {
+    SkBitmap bitmap = createScreenshot();
+    for (auto _ : state) {
+        SkNullWStream stream;
+        Bitmap::compress(bitmap, Bitmap::JavaCompressFormat::Png, 100, &stream);
+        benchmark::DoNotOptimize(stream.bytesWritten());
+    }
+    state.SetBytesProcessed(state.iterations() * bitmap.computeByteSize());
+}
+BENCHMARK(BM_BitmapCompress_png)->Unit(benchmark::kMillisecond);
+
+static void BM_BitmapCompress_webpLossy(benchmark::State& state) {
+    SkBitmap bitmap = createScreenshot();
+    for (auto _ : state) {
+        SkNullWStream stream;
+        Bitmap::compress(bitmap, Bitmap::JavaCompressFormat::WebpLossy, 90, &stream);
+        benchmark::DoNotOptimize(stream.bytesWritten());
+    }
+    state.SetBytesProcessed(state.iterations() * bitmap.computeByteSize());
+}
+BENCHMARK(BM_BitmapCompress_webpLossy)->Unit(benchmark::kMillisecond);
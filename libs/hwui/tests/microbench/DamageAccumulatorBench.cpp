@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "DamageAccumulator.h"
+#include "Matrix.h"
+#include "RenderNode.h"
+
+#include <vector>
+
+using namespace android;
+using namespace android::uirenderer;
+
+// A chain of range(0) nested nodes, each offset from its parent like a typical view hierarchy,
+// with every leaf-to-root path damaged once per frame. range(1) rotates every other node.
+void BM_DamageAccumulator_deepTree(benchmark::State& state) {
+    const int depth = state.range(0);
+    const bool rotated = state.range(1);
+    std::vector<sp<RenderNode>> nodes;
+    for (int i = 0; i < depth; i++) {
+        sp<RenderNode> node = new RenderNode();
+        node->animatorProperties().setLeftTopRightBottom(2, 2, 1000, 1000);
+        node->animatorProperties().setTranslationY(i % 3);
+        if (rotated && i % 2) {
+            node->animatorProperties().setRotation(1);
+        }
+        node->animatorProperties().updateMatrix();
+        nodes.push_back(node);
+    }
+
+    DamageAccumulator damageAccumulator;
+    SkRect dirty;
+    while (state.KeepRunning()) {
+        for (const auto& node : nodes) {
+            damageAccumulator.pushTransform(node.get());
+        }
+        damageAccumulator.dirty(0, 0, 10, 10);
+        for (int i = 0; i < depth; i++) {
+            damageAccumulator.popTransform();
+        }
+        damageAccumulator.finish(&dirty);
+        benchmark::DoNotOptimize(dirty);
+    }
+}
+BENCHMARK(BM_DamageAccumulator_deepTree)->Args({8, 0})->Args({32, 0})->Args({32, 1});
+
+// A wide tree of range(0) sibling subtrees, each four Matrix4 frames deep, damaging disjoint
+// areas. range(1) tracks the separate damage rects as well as their union.
+void BM_DamageAccumulator_wideTree(benchmark::State& state) {
+    const int width = state.range(0);
+    Matrix4 translate;
+    translate.loadTranslate(3, 5, 0);
+
+    DamageAccumulator damageAccumulator;
+    damageAccumulator.setTrackDamageRects(state.range(1));
+    SkRect dirty;
+    DamageAccumulator::DamageRects damageRects;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < width; i++) {
+            for (int j = 0; j < 4; j++) {
+                damageAccumulator.pushTransform(&translate);
+            }
+            damageAccumulator.dirty(i * 50, i * 20, i * 50 + 10, i * 20 + 10);
+            for (int j = 0; j < 4; j++) {
+                damageAccumulator.popTransform();
+            }
+        }
+        damageAccumulator.finish(&dirty, &damageRects);
+        benchmark::DoNotOptimize(damageRects);
+    }
+}
+BENCHMARK(BM_DamageAccumulator_wideTree)->Args({16, 0})->Args({16, 1});
@@ -19,6 +19,7 @@
 #include "DisplayList.h"
 #include "hwui/Canvas.h"
 #include "hwui/Paint.h"
+#include "pipeline/skia/DisplayListPool.h"
 #include "pipeline/skia/SkiaDisplayList.h"
 #include "tests/common/TestUtils.h"
 
@@ -150,3 +151,40 @@ void BM_SkiaDisplayListCanvas_basicViewGroupDraw(benchmark::State& benchState) {
     }
 }
 BENCHMARK(BM_SkiaDisplayListCanvas_basicViewGroupDraw)->Arg(1)->Arg(5)->Arg(10);
+
+// Re-records a set of nodes whose staging lists are never synced, so each recording drops the
+// previous list. With range(1) == 0 the pool is drained every frame to show the cost of
+// allocating fresh display list storage instead.
+void BM_SkiaDisplayListCanvas_rerecordNodes(benchmark::State& benchState) {
+    const int nodeCount = benchState.range(0);
+    const bool pooled = benchState.range(1);
+    std::vector<sp<RenderNode>> nodes;
+    for (int i = 0; i < nodeCount; i++) {
+        nodes.push_back(TestUtils::createNode(0, 0, 100, 100, nullptr));
+    }
+    Paint paint;
+    auto& pool = DisplayListPool::getInstance();
+    pool.trim();
+    const auto before = pool.getStats();
+
+    while (benchState.KeepRunning()) {
+        if (!pooled) {
+            pool.trim();
+        }
+        for (auto& node : nodes) {
+            SkiaRecordingCanvas canvas(node.get(), 100, 100);
+            for (int i = 0; i < 20; i++) {
+                canvas.drawRect(0, 0, i, i, paint);
+            }
+            canvas.finishRecording(node.get());
+        }
+    }
+
+    const auto after = pool.getStats();
+    const double recordings = static_cast<double>(after.acquired - before.acquired);
+    benchState.counters["newLists"] = benchmark::Counter(
+            recordings - (after.reused - before.reused), benchmark::Counter::kAvgIterations);
+    benchState.counters["reuseRate"] =
+            recordings > 0 ? (after.reused - before.reused) / recordings : 0;
+}
+BENCHMARK(BM_SkiaDisplayListCanvas_rerecordNodes)->Args({100, 0})->Args({100, 1});
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "AnimationContext.h"
+#include "Animator.h"
+#include "CanvasProperty.h"
+#include "IContextFactory.h"
+#include "TreeInfo.h"
+#include "renderthread/CanvasContext.h"
+#include "renderthread/TimeLord.h"
+#include "tests/common/TestUtils.h"
+
+using namespace android;
+using namespace android::uirenderer;
+using namespace android::uirenderer::renderthread;
+
+namespace {
+
+class AnimatorManagerContextFactory : public IContextFactory {
+public:
+    virtual AnimationContext* createAnimationContext(TimeLord& clock) override {
+        return new AnimationContext(clock);
+    }
+};
+
+void advanceFrame(TimeLord& timeLord, nsecs_t* frameTime) {
+    constexpr nsecs_t kFrameInterval = 16666667;
+    *frameTime += kFrameInterval;
+    timeLord.vsyncReceived(*frameTime, *frameTime, 1, *frameTime + kFrameInterval,
+                           kFrameInterval);
+}
+
+sp<BaseRenderNodeAnimator> startAnimator(RenderNode* node, CanvasPropertyPrimitive* property,
+                                         float from, float to) {
+    sp<BaseRenderNodeAnimator> animator = new CanvasPropertyPrimitiveAnimator(property, to);
+    animator->setStartValue(from);
+    animator->setDuration(1000);
+    animator->setInterpolator(new LinearInterpolator());
+    animator->start();
+    node->addAnimator(animator);
+    return animator;
+}
+
+}  // namespace
+
+// An animator ended from the UI thread skips to its end value on the next frame. That value
+// must land after the values of the animators before it on the same property, as it did when
+// each animator was run on its own.
+RENDERTHREAD_TEST(AnimatorManager, endedAnimatorWritesAfterEarlierAnimators) {
+    auto node = TestUtils::createNode(0, 0, 100, 100, nullptr);
+    AnimatorManagerContextFactory factory;
+    std::unique_ptr<CanvasContext> canvasContext(
+            CanvasContext::create(renderThread, false, node.get(), &factory, 0, 0));
+    TreeInfo info(TreeInfo::MODE_RT_ONLY, *canvasContext);
+    AnimationContext context(renderThread.timeLord());
+
+    sp<CanvasPropertyPrimitive> property = new CanvasPropertyPrimitive(0);
+    sp<BaseRenderNodeAnimator> running = startAnimator(node.get(), property.get(), 0, 100);
+    sp<BaseRenderNodeAnimator> ended = startAnimator(node.get(), property.get(), 0, 50);
+    context.addAnimatingRenderNode(*node);
+
+    nsecs_t frameTime = systemTime(SYSTEM_TIME_MONOTONIC);
+    advanceFrame(renderThread.timeLord(), &frameTime);
+    context.startFrame(TreeInfo::MODE_RT_ONLY);
+    context.runRemainingAnimations(info);
+
+    ended->end();
+    advanceFrame(renderThread.timeLord(), &frameTime);
+    context.startFrame(TreeInfo::MODE_RT_ONLY);
+    context.runRemainingAnimations(info);
+
+    EXPECT_TRUE(running->isRunning());
+    EXPECT_TRUE(ended->isFinished());
+    EXPECT_EQ(50, property->value);
+
+    context.destroy();
+    canvasContext->destroy();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "hwui/BandedJpegEncoder.h"
+
+extern "C" {
+#include <stdio.h>
+#include "jpeglib.h"
+}
+
+using namespace android;
+
+static std::vector<uint8_t> makePixels(int width, int height) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint8_t>((i * 7) ^ (i >> 9) ^ ((i >> 17) * 13));
+    }
+    return pixels;
+}
+
+// Encodes the whole image in one go with the given restart interval, which is what the banded
+// encoder has to reproduce exactly.
+static std::vector<uint8_t> encodeReference(const BandedJpegEncoder::Image& image, int quality,
+                                            unsigned int restartInterval) {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_compress(&cinfo);
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+    cinfo.image_width = image.width;
+    cinfo.image_height = image.height;
+    cinfo.input_components = 4;
+    cinfo.in_color_space = JCS_EXT_RGBA;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    cinfo.optimize_coding = FALSE;
+    cinfo.restart_interval = restartInterval;
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(image.pixels + cinfo.next_scanline * image.rowBytes);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    std::vector<uint8_t> result(buffer, buffer + size);
+    free(buffer);
+    return result;
+}
+
+static void runSerially(std::vector<std::function<void()>>& bands) {
+    for (auto& band : bands) {
+        band();
+    }
+}
+
+TEST(BandedJpegEncoder, computeBandMcuRows) {
+    // 2160 rows is 135 MCU rows, split in three.
+    EXPECT_EQ(45, BandedJpegEncoder::computeBandMcuRows(3840, 2160, 3));
+    // Too short to split.
+    EXPECT_EQ(0, BandedJpegEncoder::computeBandMcuRows(3840, 16, 3));
+    // 8000 pixels is 500 MCUs per row, so at most 131 rows fit in a restart interval.
+    EXPECT_EQ(131, BandedJpegEncoder::computeBandMcuRows(8000, 8000, 2));
+    EXPECT_EQ(0, BandedJpegEncoder::computeBandMcuRows(70000, 100, 2));
+    EXPECT_EQ(0, BandedJpegEncoder::computeBandMcuRows(100, 100, 1));
+}
+
+TEST(BandedJpegEncoder, matchesSinglePassEncode) {
+    const std::pair<int, int> sizes[] = {{1920, 1080}, {1001, 777}, {5000, 300}, {64, 40}};
+    for (auto [width, height] : sizes) {
+        auto pixels = makePixels(width, height);
+        BandedJpegEncoder::Image image{
+                .pixels = pixels.data(),
+                .rowBytes = static_cast<size_t>(width) * 4,
+                .width = width,
+                .height = height,
+                .order = BandedJpegEncoder::PixelOrder::RGBA,
+        };
+        for (int maxBands : {2, 3, 8}) {
+            const int bandMcuRows = BandedJpegEncoder::computeBandMcuRows(width, height, maxBands);
+            ASSERT_GT(bandMcuRows, 0);
+            std::vector<uint8_t> banded;
+            ASSERT_TRUE(BandedJpegEncoder::encode(image, 90, maxBands, &banded, runSerially));
+            auto reference = encodeReference(image, 90, bandMcuRows * ((width + 15) / 16));
+            EXPECT_EQ(reference, banded) << width << "x" << height << " bands " << maxBands;
+        }
+    }
+}
+
+TEST(BandedJpegEncoder, commonPoolMatchesSerial) {
+    auto pixels = makePixels(1280, 1280);
+    BandedJpegEncoder::Image image{
+            .pixels = pixels.data(),
+            .rowBytes = 1280 * 4,
+            .width = 1280,
+            .height = 1280,
+            .order = BandedJpegEncoder::PixelOrder::BGRA,
+    };
+    std::vector<uint8_t> serial, parallel;
+    ASSERT_TRUE(BandedJpegEncoder::encode(image, 75, 3, &serial, runSerially));
+    ASSERT_TRUE(BandedJpegEncoder::encode(image, 75, 3, &parallel));
+    EXPECT_EQ(serial, parallel);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "hwui/BitmapParcelCache.h"
+
+using namespace android;
+
+static std::vector<uint8_t> makePixels(size_t size, uint8_t seed) {
+    std::vector<uint8_t> pixels(size);
+    for (size_t i = 0; i < size; i++) {
+        pixels[i] = static_cast<uint8_t>(seed + i * 31);
+    }
+    return pixels;
+}
+
+static bool sameInode(int a, int b) {
+    struct stat sa, sb;
+    return fstat(a, &sa) == 0 && fstat(b, &sb) == 0 && sa.st_ino == sb.st_ino &&
+           sa.st_dev == sb.st_dev;
+}
+
+TEST(BitmapParcelCache, reusesIdenticalContents) {
+    BitmapParcelCache cache(1024 * 1024);
+    auto pixels = makePixels(64 * 1024, 3);
+
+    base::unique_fd first = cache.acquire(pixels.data(), pixels.size());
+    base::unique_fd second = cache.acquire(pixels.data(), pixels.size());
+    ASSERT_GE(first.get(), 0);
+    ASSERT_GE(second.get(), 0);
+    EXPECT_TRUE(sameInode(first.get(), second.get()));
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(pixels.size(), stats.bytesSaved);
+    EXPECT_EQ(1u, stats.entryCount);
+}
+
+TEST(BitmapParcelCache, differentContentsGetDifferentRegions) {
+    BitmapParcelCache cache(1024 * 1024);
+    auto a = makePixels(16 * 1024, 1);
+    auto b = a;
+    b.back() ^= 0xFF;
+
+    base::unique_fd fdA = cache.acquire(a.data(), a.size());
+    base::unique_fd fdB = cache.acquire(b.data(), b.size());
+    ASSERT_GE(fdA.get(), 0);
+    ASSERT_GE(fdB.get(), 0);
+    EXPECT_FALSE(sameInode(fdA.get(), fdB.get()));
+    EXPECT_EQ(0u, cache.getStats().hits);
+}
+
+TEST(BitmapParcelCache, regionIsSealedAndCopyOnWrite) {
+    BitmapParcelCache cache(1024 * 1024);
+    auto pixels = makePixels(32 * 1024, 7);
+    base::unique_fd fd = cache.acquire(pixels.data(), pixels.size());
+    ASSERT_GE(fd.get(), 0);
+    EXPECT_TRUE(BitmapParcelCache::isWriteSealed(fd.get()));
+
+    // A writable shared mapping must be refused...
+    void* shared = mmap(nullptr, pixels.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+    EXPECT_EQ(MAP_FAILED, shared);
+
+    // ...while a private one can be written without affecting the cached contents.
+    auto* cow = static_cast<uint8_t*>(
+            mmap(nullptr, pixels.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd.get(), 0));
+    ASSERT_NE(MAP_FAILED, cow);
+    EXPECT_EQ(0, memcmp(cow, pixels.data(), pixels.size()));
+    cow[0] ^= 0xFF;
+    munmap(cow, pixels.size());
+
+    base::unique_fd again = cache.acquire(pixels.data(), pixels.size());
+    EXPECT_TRUE(sameInode(fd.get(), again.get()));
+    auto* ro = static_cast<uint8_t*>(
+            mmap(nullptr, pixels.size(), PROT_READ, MAP_SHARED, again.get(), 0));
+    ASSERT_NE(MAP_FAILED, ro);
+    EXPECT_EQ(0, memcmp(ro, pixels.data(), pixels.size()));
+    munmap(ro, pixels.size());
+}
+
+TEST(BitmapParcelCache, evictsLeastRecentlyUsed) {
+    BitmapParcelCache cache(40 * 1024);
+    auto a = makePixels(16 * 1024, 1);
+    auto b = makePixels(16 * 1024, 2);
+    auto c = makePixels(16 * 1024, 3);
+
+    cache.acquire(a.data(), a.size());
+    cache.acquire(b.data(), b.size());
+    cache.acquire(a.data(), a.size());  // a is now the most recently used
+    cache.acquire(c.data(), c.size());  // evicts b
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(2u, stats.entryCount);
+
+    cache.acquire(a.data(), a.size());
+    EXPECT_EQ(2u, cache.getStats().hits);
+    cache.acquire(b.data(), b.size());
+    EXPECT_EQ(2u, cache.getStats().hits);
+}
+
+TEST(BitmapParcelCache, trimDropsEntries) {
+    BitmapParcelCache cache(1024 * 1024);
+    auto pixels = makePixels(8 * 1024, 9);
+    base::unique_fd fd = cache.acquire(pixels.data(), pixels.size());
+    cache.trim();
+    EXPECT_EQ(0u, cache.getStats().entryCount);
+    EXPECT_EQ(0u, cache.getStats().cachedBytes);
+    // Outstanding fds stay valid after the cache lets go of them.
+    EXPECT_TRUE(BitmapParcelCache::isWriteSealed(fd.get()));
+}
+
+TEST(BitmapParcelCache, trimIdleDropsExpiredEntries) {
+    constexpr nsecs_t kTimeout = 1000000000;
+    BitmapParcelCache cache(1024 * 1024, kTimeout);
+    auto a = makePixels(8 * 1024, 1);
+    auto b = makePixels(8 * 1024, 2);
+    cache.acquire(a.data(), a.size());
+    const nsecs_t aUsed = systemTime(SYSTEM_TIME_MONOTONIC);
+    cache.acquire(b.data(), b.size());
+
+    cache.trimIdle(aUsed);
+    EXPECT_EQ(2u, cache.getStats().entryCount);
+    cache.trimIdle(systemTime(SYSTEM_TIME_MONOTONIC) + kTimeout);
+    EXPECT_EQ(0u, cache.getStats().entryCount);
+    EXPECT_EQ(0u, cache.getStats().cachedBytes);
+}
+
+TEST(BitmapParcelCache, schedulesExpiry) {
+    constexpr nsecs_t kTimeout = 1000000000;
+    std::vector<std::pair<nsecs_t, std::function<void()>>> tasks;
+    BitmapParcelCache cache(1024 * 1024, kTimeout,
+                            [&tasks](nsecs_t delay, std::function<void()> task) {
+                                tasks.emplace_back(delay, std::move(task));
+                                return true;
+                            });
+    auto a = makePixels(8 * 1024, 1);
+    auto b = makePixels(8 * 1024, 2);
+    cache.acquire(a.data(), a.size());
+    cache.acquire(b.data(), b.size());
+    // One expiry is pending at a time, for the least recently used entry.
+    ASSERT_EQ(1u, tasks.size());
+    EXPECT_GT(tasks[0].first, 0);
+    EXPECT_LE(tasks[0].first, kTimeout);
+
+    // Nothing has expired yet, so running it early just schedules the next one.
+    auto task = std::move(tasks[0].second);
+    task();
+    EXPECT_EQ(2u, cache.getStats().entryCount);
+    EXPECT_EQ(2u, tasks.size());
+}
+
+TEST(BitmapParcelCache, hashIsContentSensitive) {
+    auto pixels = makePixels(1000, 5);
+    uint64_t h = BitmapParcelCache::hash(pixels.data(), pixels.size());
+    EXPECT_EQ(h, BitmapParcelCache::hash(pixels.data(), pixels.size()));
+    for (size_t i : {0u, 31u, 32u, 500u, 999u}) {
+        auto copy = pixels;
+        copy[i] ^= 1;
+        EXPECT_NE(h, BitmapParcelCache::hash(copy.data(), copy.size())) << "index " << i;
+    }
+    EXPECT_NE(h, BitmapParcelCache::hash(pixels.data(), pixels.size() - 1));
+}
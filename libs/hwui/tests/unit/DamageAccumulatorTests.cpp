@@ -23,6 +23,8 @@
 
 #include <SkRect.h>
 
+#include <algorithm>
+
 using namespace android;
 using namespace android::uirenderer;
 
@@ -127,3 +129,119 @@ TEST(DamageAccumulator, perspectiveTransform) {
     da.finish(&dirty);
     ASSERT_EQ(SkRect::MakeLTRB(50, 50, 500, 500), dirty);
 }
+
+TEST(DamageAccumulator, translatedRenderNode) {
+    DamageAccumulator da;
+    RenderNode node;
+    node.animatorProperties().setLeftTopRightBottom(50, 50, 500, 500);
+    node.animatorProperties().setTranslationX(10.5f);
+    node.animatorProperties().setTranslationY(-20);
+    node.animatorProperties().updateMatrix();
+    da.pushTransform(&node);
+    da.dirty(0, 0, 25, 25);
+    da.popTransform();
+    SkRect dirty;
+    da.finish(&dirty);
+    ASSERT_EQ(SkRect::MakeLTRB(60, 30, 86, 55), dirty);
+}
+
+TEST(DamageAccumulator, rotatedMatrix4) {
+    Matrix4 rotate;
+    rotate.loadTranslate(100, 50, 0);
+    rotate.rotate(30, 0, 0, 1);
+    Rect expected(10, 20, 60, 40);
+    rotate.mapRect(expected);
+
+    DamageAccumulator da;
+    da.pushTransform(&rotate);
+    da.dirty(10, 20, 60, 40);
+    da.popTransform();
+    SkRect dirty;
+    da.peekAtDirty(&dirty);
+    EXPECT_NEAR(expected.left, dirty.fLeft, 0.001f);
+    EXPECT_NEAR(expected.top, dirty.fTop, 0.001f);
+    EXPECT_NEAR(expected.right, dirty.fRight, 0.001f);
+    EXPECT_NEAR(expected.bottom, dirty.fBottom, 0.001f);
+}
+
+TEST(DamageAccumulator, damageRectsNotTrackedByDefault) {
+    DamageAccumulator da;
+    da.pushTransform(&Matrix4::identity());
+    da.dirty(0, 0, 10, 10);
+    da.popTransform();
+    SkRect dirty;
+    DamageAccumulator::DamageRects rects;
+    da.finish(&dirty, &rects);
+    ASSERT_EQ(SkRect::MakeLTRB(0, 0, 10, 10), dirty);
+    ASSERT_TRUE(rects.empty());
+}
+
+TEST(DamageAccumulator, disjointDamageRects) {
+    DamageAccumulator da;
+    da.setTrackDamageRects(true);
+    Matrix4 translate;
+    translate.loadTranslate(100, 0, 0);
+    da.pushTransform(&Matrix4::identity());
+    da.dirty(0, 0, 10, 10);
+    da.popTransform();
+    da.pushTransform(&translate);
+    da.dirty(0, 500, 10.5f, 510);
+    da.popTransform();
+    SkRect dirty;
+    DamageAccumulator::DamageRects rects;
+    da.finish(&dirty, &rects);
+    ASSERT_EQ(SkRect::MakeLTRB(0, 0, 111, 510), dirty);
+    ASSERT_EQ(2u, rects.size());
+    EXPECT_EQ(SkRect::MakeLTRB(0, 0, 10, 10), rects[0]);
+    EXPECT_EQ(SkRect::MakeLTRB(100, 500, 111, 510), rects[1]);
+
+    // Rects do not carry over into the next frame
+    da.finish(&dirty, &rects);
+    ASSERT_TRUE(dirty.isEmpty());
+    ASSERT_TRUE(rects.empty());
+}
+
+TEST(DamageAccumulator, overlappingDamageRectsMerge) {
+    DamageAccumulator da;
+    da.setTrackDamageRects(true);
+    da.pushTransform(&Matrix4::identity());
+    da.dirty(0, 0, 10, 10);
+    da.popTransform();
+    da.pushTransform(&Matrix4::identity());
+    da.dirty(100, 0, 110, 10);
+    da.popTransform();
+    // Bridges the first two, so all three become one
+    da.pushTransform(&Matrix4::identity());
+    da.dirty(5, 0, 105, 5);
+    da.popTransform();
+    SkRect dirty;
+    DamageAccumulator::DamageRects rects;
+    da.finish(&dirty, &rects);
+    ASSERT_EQ(1u, rects.size());
+    EXPECT_EQ(SkRect::MakeLTRB(0, 0, 110, 10), rects[0]);
+    EXPECT_EQ(dirty, rects[0]);
+}
+
+TEST(DamageAccumulator, damageRectsLimit) {
+    DamageAccumulator da;
+    da.setTrackDamageRects(true);
+    const size_t count = DamageAccumulator::kMaxDamageRects + 1;
+    for (size_t i = 0; i < count; i++) {
+        da.pushTransform(&Matrix4::identity());
+        // The last rect is closest to the first one
+        const float x = i == count - 1 ? 20 : i * 100;
+        da.dirty(x, 0, x + 10, 10);
+        da.popTransform();
+    }
+    SkRect dirty;
+    DamageAccumulator::DamageRects rects;
+    da.finish(&dirty, &rects);
+    ASSERT_EQ(DamageAccumulator::kMaxDamageRects, rects.size());
+    SkRect unioned = SkRect::MakeEmpty();
+    for (const SkRect& rect : rects) {
+        unioned.join(rect);
+    }
+    EXPECT_EQ(dirty, unioned);
+    EXPECT_NE(rects.end(),
+              std::find(rects.begin(), rects.end(), SkRect::MakeLTRB(0, 0, 30, 10)));
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "DisplayList.h"
+#include "hwui/Paint.h"
+#include "pipeline/skia/DisplayListPool.h"
+#include "pipeline/skia/SkiaDisplayList.h"
+#include "pipeline/skia/SkiaRecordingCanvas.h"
+#include "tests/common/TestUtils.h"
+
+using namespace android;
+using namespace android::uirenderer;
+using namespace android::uirenderer::skiapipeline;
+
+static std::unique_ptr<SkiaDisplayList> recordRects(int count) {
+    SkiaRecordingCanvas canvas(nullptr, 100, 100);
+    Paint paint;
+    for (int i = 0; i < count; i++) {
+        canvas.drawRect(0, 0, i, i, paint);
+    }
+    return canvas.finishRecording();
+}
+
+TEST(DisplayListPool, sizeClasses) {
+    EXPECT_EQ(0, DisplayListPool::sizeClassFor(0));
+    EXPECT_EQ(0, DisplayListPool::sizeClassFor(4096));
+    EXPECT_EQ(1, DisplayListPool::sizeClassFor(8192));
+    EXPECT_EQ(2, DisplayListPool::sizeClassFor(16384));
+    EXPECT_EQ(DisplayListPool::kSizeClassCount, DisplayListPool::sizeClassFor(64 * 1024 * 1024));
+}
+
+TEST(DisplayListPool, reusesReleasedLists) {
+    DisplayListPool pool(1024 * 1024);
+    auto displayList = recordRects(10);
+    ASSERT_FALSE(displayList->isEmpty());
+    SkiaDisplayList* released = displayList.get();
+    pool.release(std::move(displayList));
+
+    auto stats = pool.getStats();
+    EXPECT_EQ(1u, stats.released);
+    EXPECT_EQ(1u, stats.pooledLists);
+
+    auto acquired = pool.acquire(0);
+    EXPECT_EQ(released, acquired.get());
+    EXPECT_TRUE(acquired->isEmpty());
+    EXPECT_TRUE(acquired->mChildNodes.empty());
+
+    stats = pool.getStats();
+    EXPECT_EQ(1u, stats.acquired);
+    EXPECT_EQ(1u, stats.reused);
+    EXPECT_EQ(0u, stats.pooledLists);
+    EXPECT_EQ(0u, stats.pooledBytes);
+
+    auto fresh = pool.acquire(0);
+    ASSERT_NE(nullptr, fresh.get());
+    EXPECT_EQ(2u, pool.getStats().acquired);
+    EXPECT_EQ(1u, pool.getStats().reused);
+}
+
+TEST(DisplayListPool, prefersListsThatFitTheHint) {
+    DisplayListPool pool(1024 * 1024);
+    auto small = recordRects(1);
+    auto large = recordRects(1000);
+    const size_t largeBytes = large->getAllocatedSize();
+    ASSERT_GT(DisplayListPool::sizeClassFor(largeBytes),
+              DisplayListPool::sizeClassFor(small->getAllocatedSize()));
+    SkiaDisplayList* smallPtr = small.get();
+    SkiaDisplayList* largePtr = large.get();
+    pool.release(std::move(small));
+    pool.release(std::move(large));
+
+    EXPECT_EQ(largePtr, pool.acquire(largeBytes).get());
+    EXPECT_EQ(smallPtr, pool.acquire(0).get());
+}
+
+TEST(DisplayListPool, discardsWhenFull) {
+    auto displayList = recordRects(10);
+    DisplayListPool pool(displayList->getAllocatedSize() - 1);
+    pool.release(std::move(displayList));
+    auto stats = pool.getStats();
+    EXPECT_EQ(1u, stats.released);
+    EXPECT_EQ(1u, stats.discarded);
+    EXPECT_EQ(0u, stats.pooledLists);
+}
+
+TEST(DisplayListPool, trim) {
+    DisplayListPool pool(1024 * 1024);
+    pool.release(recordRects(10));
+    pool.release(recordRects(10));
+    EXPECT_EQ(2u, pool.getStats().pooledLists);
+    pool.trim();
+    EXPECT_EQ(0u, pool.getStats().pooledLists);
+    EXPECT_EQ(0u, pool.getStats().pooledBytes);
+}
+
+TEST(DisplayListPool, droppedStagingListIsPooled) {
+    auto& pool = DisplayListPool::getInstance();
+    pool.trim();
+    const auto before = pool.getStats();
+
+    auto node = TestUtils::createNode(0, 0, 100, 100, [](RenderProperties&, Canvas& canvas) {
+        canvas.drawColor(0xFFFFFFFF, SkBlendMode::kSrcOver);
+    });
+    // Replacing the unsynced staging list drops the previous one.
+    TestUtils::recordNode(*node, [](Canvas& canvas) {
+        canvas.drawColor(0xFF000000, SkBlendMode::kSrcOver);
+    });
+
+    const auto after = pool.getStats();
+    EXPECT_EQ(before.released + 1, after.released);
+    EXPECT_EQ(before.pooledLists + 1, after.pooledLists);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+#include "utils/EventTrace.h"
+
+using namespace android;
+using namespace android::uirenderer;
+
+static std::string dump() {
+    String8 out;
+    EventTrace::dumpJson(out);
+    return std::string(out.c_str());
+}
+
+static size_t countOccurrences(const std::string& haystack, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos;
+         pos = haystack.find(needle, pos + needle.size())) {
+        count++;
+    }
+    return count;
+}
+
+TEST(EventTrace, recordsCompleteEvents) {
+    EventTrace::record("EventTraceTest_complete", 5000, 7500);
+    std::string json = dump();
+    EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos,
+              json.find("\"name\":\"EventTraceTest_complete\",\"pid\":" +
+                        std::to_string(getpid()) + ",\"tid\":" + std::to_string(gettid()) +
+                        ",\"ts\":5.000,\"dur\":2.500}"));
+}
+
+TEST(EventTrace, scopeRecordsOnDestruction) {
+    {
+        EventTrace::Scope scope("EventTraceTest_scope");
+        EXPECT_EQ(0u, countOccurrences(dump(), "EventTraceTest_scope"));
+    }
+    EXPECT_EQ(1u, countOccurrences(dump(), "EventTraceTest_scope"));
+}
+
+TEST(EventTrace, keepsOnlyTheMostRecentEvents) {
+    std::thread thread([] {
+        pthread_setname_np(pthread_self(), "EventTraceWrap");
+        EventTrace::record("EventTraceTest_old", 0, 1);
+        for (size_t i = 0; i < EventTrace::kEventsPerThread; i++) {
+            EventTrace::record("EventTraceTest_new", 0, 1);
+        }
+        std::string json = dump();
+        EXPECT_EQ(0u, countOccurrences(json, "EventTraceTest_old"));
+        EXPECT_EQ(EventTrace::kEventsPerThread, countOccurrences(json, "EventTraceTest_new"));
+        EXPECT_NE(std::string::npos, json.find("\"args\":{\"name\":\"EventTraceWrap\"}"));
+    });
+    thread.join();
+}
+
+TEST(EventTrace, dropsEventsOfExitedThreads) {
+    std::thread([] { EventTrace::record("EventTraceTest_exited", 0, 1); }).join();
+    // The ring is handed to the next thread that records, without the previous owner's events.
+    std::thread([] {
+        EventTrace::record("EventTraceTest_reused", 0, 1);
+        std::string json = dump();
+        EXPECT_EQ(0u, countOccurrences(json, "EventTraceTest_exited"));
+        EXPECT_EQ(1u, countOccurrences(json, "EventTraceTest_reused"));
+    }).join();
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+
+#include <FrameMetricsRing.h>
+#include <FrameMetricsReporter.h>
+#include <utils/TimeUtils.h>
+
+#include <array>
+#include <vector>
+
+using namespace android;
+using namespace android::uirenderer;
+
+namespace {
+
+using Frame = std::array<int64_t, FrameMetricsRing::kRecordWords>;
+
+Frame makeFrame(int64_t id, nsecs_t duration, bool missedDeadline = false) {
+    Frame frame{};
+    auto set = [&](FrameInfoIndex index) -> int64_t& { return frame[static_cast<int>(index)]; };
+    set(FrameInfoIndex::FrameTimelineVsyncId) = id;
+    set(FrameInfoIndex::IntendedVsync) = 100_ms;
+    set(FrameInfoIndex::SwapBuffers) = 100_ms + duration - 2_ms;
+    set(FrameInfoIndex::FrameCompleted) = 100_ms + duration;
+    set(FrameInfoIndex::GpuCompleted) = 100_ms + duration;
+    set(FrameInfoIndex::FrameDeadline) = missedDeadline ? 100_ms : 200_ms;
+    return frame;
+}
+
+int64_t vsyncId(const int64_t* record) {
+    return record[static_cast<int>(FrameInfoIndex::FrameTimelineVsyncId)];
+}
+
+}  // namespace
+
+TEST(FrameMetricsRing, readsFramesInOrder) {
+    sp<FrameMetricsRing> ring = FrameMetricsRing::create(8, false);
+    ASSERT_NE(nullptr, ring.get());
+    FrameMetricsRing::Reader reader(ring->getMapping(), ring->getSize());
+    ASSERT_TRUE(reader.isValid());
+
+    for (int i = 0; i < 5; i++) {
+        ring->notify(makeFrame(i, 8_ms).data());
+    }
+
+    std::vector<int64_t> out(3 * FrameMetricsRing::kRecordWords);
+    uint64_t cursor = 0;
+    uint64_t dropped = 0;
+    ASSERT_EQ(3u, reader.read(&cursor, out.data(), 3, &dropped));
+    EXPECT_EQ(3u, cursor);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(i, vsyncId(&out[i * FrameMetricsRing::kRecordWords]));
+    }
+    ASSERT_EQ(2u, reader.read(&cursor, out.data(), 3, &dropped));
+    EXPECT_EQ(3, vsyncId(&out[0]));
+    EXPECT_EQ(4, vsyncId(&out[FrameMetricsRing::kRecordWords]));
+    EXPECT_EQ(0u, reader.read(&cursor, out.data(), 3, &dropped));
+    EXPECT_EQ(0u, dropped);
+}
+
+TEST(FrameMetricsRing, countsOverwrittenFramesAsDropped) {
+    sp<FrameMetricsRing> ring = FrameMetricsRing::create(4, false);
+    ASSERT_NE(nullptr, ring.get());
+    FrameMetricsRing::Reader reader(ring->getMapping(), ring->getSize());
+    for (int i = 0; i < 10; i++) {
+        ring->notify(makeFrame(i, 8_ms).data());
+    }
+
+    std::vector<int64_t> out(10 * FrameMetricsRing::kRecordWords);
+    uint64_t cursor = 0;
+    uint64_t dropped = 0;
+    ASSERT_EQ(4u, reader.read(&cursor, out.data(), 10, &dropped));
+    EXPECT_EQ(6u, dropped);
+    EXPECT_EQ(6, vsyncId(&out[0]));
+    EXPECT_EQ(10u, reader.framesWritten());
+}
+
+TEST(FrameMetricsRing, aggregatesHistogram) {
+    sp<FrameMetricsRing> ring = FrameMetricsRing::create(4, false);
+    ASSERT_NE(nullptr, ring.get());
+    for (int i = 0; i < 20; i++) {
+        ring->notify(makeFrame(i, i % 5 == 0 ? 40_ms : 8_ms, i % 5 == 0).data());
+    }
+
+    FrameMetricsRing::Reader reader(ring->getMapping(), ring->getSize());
+    ProfileData data;
+    ASSERT_TRUE(reader.readHistogram(&data));
+    // The histogram covers every frame, not just the ones still in the ring.
+    EXPECT_EQ(20u, data.totalFrameCount());
+    EXPECT_EQ(4u, data.jankFrameCount());
+    EXPECT_EQ(4u, data.jankTypeCount(kMissedDeadline));
+    uint32_t histogramFrames = 0;
+    data.histogramForEach([&](ProfileData::HistogramEntry entry) {
+        histogramFrames += entry.frameCount;
+    });
+    EXPECT_EQ(20u, histogramFrames);
+    uint32_t gpuFrames = 0;
+    data.histogramGPUForEach([&](ProfileData::HistogramEntry entry) {
+        gpuFrames += entry.frameCount;
+    });
+    EXPECT_EQ(20u, gpuFrames);
+}
+
+TEST(FrameMetricsRing, sharedMemoryIsReadOnlyForOthers) {
+    sp<FrameMetricsRing> ring = FrameMetricsRing::create(4, false);
+    ASSERT_NE(nullptr, ring.get());
+    ring->notify(makeFrame(42, 8_ms).data());
+
+    EXPECT_EQ(MAP_FAILED, mmap(nullptr, ring->getSize(), PROT_READ | PROT_WRITE, MAP_SHARED,
+                               ring->getFd(), 0));
+    void* mapping = mmap(nullptr, ring->getSize(), PROT_READ, MAP_SHARED, ring->getFd(), 0);
+    ASSERT_NE(MAP_FAILED, mapping);
+    FrameMetricsRing::Reader reader(mapping, ring->getSize());
+    ASSERT_TRUE(reader.isValid());
+    Frame out;
+    uint64_t cursor = 0;
+    uint64_t dropped = 0;
+    ASSERT_EQ(1u, reader.read(&cursor, out.data(), 1, &dropped));
+    EXPECT_EQ(42, vsyncId(out.data()));
+    munmap(mapping, ring->getSize());
+}
+
+TEST(FrameMetricsRing, rejectsForeignMemory) {
+    std::vector<uint8_t> garbage(FrameMetricsRing::sizeForCapacity(4), 0xAB);
+    EXPECT_FALSE(FrameMetricsRing::Reader(garbage.data(), garbage.size()).isValid());
+    EXPECT_FALSE(FrameMetricsRing::Reader(nullptr, 0).isValid());
+}
+
+TEST(FrameMetricsRing, receivesFramesFromReporter) {
+    auto reporter = std::make_shared<FrameMetricsReporter>();
+    sp<FrameMetricsRing> ring = FrameMetricsRing::create(4, false);
+    ASSERT_NE(nullptr, ring.get());
+    ring->reportMetricsFrom(0, 0);
+    reporter->addObserver(ring.get());
+
+    Frame frame = makeFrame(7, 8_ms);
+    reporter->reportFrameMetrics(frame.data(), false /* hasPresentTime */, 1, 0);
+    EXPECT_EQ(1u, FrameMetricsRing::Reader(ring->getMapping(), ring->getSize()).framesWritten());
+}
@@ -86,5 +86,53 @@ TEST(Interpolator, pathInterpolation) {
         }
     }
 }
+
+TEST(Interpolator, lutMatchesInterpolator) {
+    AccelerateDecelerateInterpolator accelerateDecelerate;
+    OvershootInterpolator overshoot(2.0f);
+    PathInterpolator path(getX(sTestDataSet[1]), getY(sTestDataSet[1]));
+    Interpolator* interpolators[] = {&accelerateDecelerate, &overshoot, &path};
+    for (Interpolator* interpolator : interpolators) {
+        auto lut = InterpolatorLUT::compile(*interpolator);
+        ASSERT_NE(nullptr, lut.get());
+        EXPECT_EQ(interpolator->interpolate(0), lut->evaluate(0));
+        EXPECT_EQ(interpolator->interpolate(1), lut->evaluate(1));
+        for (int i = 0; i <= 1000; i++) {
+            const float fraction = i / 1000.0f;
+            EXPECT_NEAR(interpolator->interpolate(fraction), lut->evaluate(fraction), 1e-3f);
+        }
+    }
+}
+
+TEST(Interpolator, lutIsSharedBetweenEqualCurves) {
+    OvershootInterpolator a(1.5f);
+    OvershootInterpolator b(1.5f);
+    OvershootInterpolator c(3.0f);
+    auto lutA = InterpolatorLUT::compile(a);
+    EXPECT_EQ(lutA, InterpolatorLUT::compile(b));
+    EXPECT_NE(lutA, InterpolatorLUT::compile(c));
+
+    LinearInterpolator linear;
+    EXPECT_EQ(nullptr, InterpolatorLUT::compile(linear));
+}
+
+TEST(Interpolator, lutEvaluateAll) {
+    AccelerateDecelerateInterpolator interpolator;
+    auto lut = InterpolatorLUT::compile(interpolator);
+    constexpr size_t kCount = 100;
+    const InterpolatorLUT* luts[kCount];
+    float fractions[kCount];
+    float expected[kCount];
+    for (size_t i = 0; i < kCount; i++) {
+        // Every third animator has no table and keeps its fraction.
+        luts[i] = i % 3 ? lut.get() : nullptr;
+        fractions[i] = i / 80.0f - 0.1f;
+        expected[i] = luts[i] ? lut->evaluate(fractions[i]) : fractions[i];
+    }
+    InterpolatorLUT::evaluateAll(luts, fractions, kCount);
+    for (size_t i = 0; i < kCount; i++) {
+        EXPECT_EQ(expected[i], fractions[i]);
+    }
+}
 }
 }
@@ -19,6 +19,7 @@
 #include <sys/resource.h>
 #include <utils/Trace.h>
 #include "renderthread/RenderThread.h"
+#include "utils/EventTrace.h"
 
 #include <array>
 
@@ -106,7 +107,10 @@ void CommonPool::workerLoop() {
         while (mWorkQueue.hasWork()) {
             auto work = mWorkQueue.pop();
             lock.unlock();
-            work();
+            {
+                HWUI_EVENT_SCOPE("CommonPool task");
+                work();
+            }
             lock.lock();
         }
     }
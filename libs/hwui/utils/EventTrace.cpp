@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EventTrace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace android {
+namespace uirenderer {
+
+namespace {
+
+struct Event {
+    // 2 * index + 1 while event 'index' is being written, 2 * index + 2 once it is complete.
+    std::atomic<uint64_t> seq{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<nsecs_t> start{0};
+    std::atomic<nsecs_t> end{0};
+};
+
+struct ThreadRing {
+    // Only written by the owning thread.
+    std::atomic<uint64_t> head{0};
+    Event events[EventTrace::kEventsPerThread];
+
+    // The fields below are guarded by sRingsLock.
+    bool inUse = false;
+    pid_t tid = 0;
+    char threadName[16] = {};
+    // Events before this index were recorded by a thread that has since exited.
+    uint64_t firstIndex = 0;
+};
+
+std::mutex sRingsLock;
+
+// Rings are never freed, only handed to the next new thread once their owner exits, so a dump
+// can always safely read them.
+std::vector<ThreadRing*>& rings() {
+    static auto* sRings = new std::vector<ThreadRing*>();
+    return *sRings;
+}
+
+ThreadRing* acquireRing() {
+    std::lock_guard lock(sRingsLock);
+    ThreadRing* ring = nullptr;
+    for (ThreadRing* candidate : rings()) {
+        if (!candidate->inUse) {
+            ring = candidate;
+            break;
+        }
+    }
+    if (!ring) {
+        ring = new ThreadRing();
+        rings().push_back(ring);
+    }
+    ring->inUse = true;
+    ring->tid = gettid();
+    ring->firstIndex = ring->head.load(std::memory_order_relaxed);
+    pthread_getname_np(pthread_self(), ring->threadName, sizeof(ring->threadName));
+    return ring;
+}
+
+class ThreadRingHolder {
+public:
+    ~ThreadRingHolder() {
+        if (mRing) {
+            std::lock_guard lock(sRingsLock);
+            mRing->inUse = false;
+        }
+    }
+
+    ThreadRing* get() {
+        if (!mRing) {
+            mRing = acquireRing();
+        }
+        return mRing;
+    }
+
+private:
+    ThreadRing* mRing = nullptr;
+};
+
+thread_local ThreadRingHolder sThreadRing;
+
+}  // namespace
+
+void EventTrace::record(const char* name, nsecs_t start, nsecs_t end) {
+    ThreadRing* ring = sThreadRing.get();
+    const uint64_t index = ring->head.load(std::memory_order_relaxed);
+    Event& event = ring->events[index % kEventsPerThread];
+    event.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    event.seq.store(2 * index + 2, std::memory_order_release);
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+void EventTrace::dumpJson(String8& out) {
+    // What a ring held when the dump started. Rings are never freed, so they can be read after
+    // the lock is released; only the events already recorded by then are dumped, all of which
+    // belong to the thread named here even if the ring changes hands meanwhile.
+    struct RingSnapshot {
+        const ThreadRing* ring;
+        pid_t tid;
+        char threadName[16];
+        uint64_t firstIndex;
+        uint64_t head;
+    };
+    std::vector<RingSnapshot> snapshots;
+    {
+        std::lock_guard lock(sRingsLock);
+        snapshots.reserve(rings().size());
+        for (const ThreadRing* ring : rings()) {
+            if (!ring->inUse) {
+                continue;
+            }
+            RingSnapshot& snapshot = snapshots.emplace_back();
+            snapshot.ring = ring;
+            snapshot.tid = ring->tid;
+            memcpy(snapshot.threadName, ring->threadName, sizeof(snapshot.threadName));
+            snapshot.firstIndex = ring->firstIndex;
+            snapshot.head = ring->head.load(std::memory_order_acquire);
+        }
+    }
+
+    const pid_t pid = getpid();
+    out.append("{\"traceEvents\":[");
+    bool first = true;
+    auto separator = [&first]() {
+        const char* s = first ? "\n" : ",\n";
+        first = false;
+        return s;
+    };
+    for (const RingSnapshot& snapshot : snapshots) {
+        const ThreadRing* ring = snapshot.ring;
+        out.appendFormat("%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,"
+                         "\"args\":{\"name\":\"%s\"}}",
+                         separator(), pid, snapshot.tid, snapshot.threadName);
+
+        const uint64_t head = snapshot.head;
+        uint64_t index = snapshot.firstIndex;
+        if (head - index > kEventsPerThread) {
+            index = head - kEventsPerThread;
+        }
+        for (; index < head; index++) {
+            const Event& event = ring->events[index % kEventsPerThread];
+            const uint64_t expected = 2 * index + 2;
+            if (event.seq.load(std::memory_order_acquire) != expected) {
+                continue;
+            }
+            const char* name = event.name.load(std::memory_order_relaxed);
+            const nsecs_t start = event.start.load(std::memory_order_relaxed);
+            const nsecs_t end = event.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (event.seq.load(std::memory_order_relaxed) != expected) {
+                continue;
+            }
+            // Timestamps are in microseconds; keep nanosecond precision.
+            out.appendFormat("%s{\"ph\":\"X\",\"name\":\"%s\",\"pid\":%d,\"tid\":%d,"
+                             "\"ts\":%.3f,\"dur\":%.3f}",
+                             separator(), name, pid, snapshot.tid, start / 1000.0,
+                             (end - start) / 1000.0);
+        }
+    }
+    out.append("\n],\"displayTimeUnit\":\"ns\"}\n");
+}
+
+void EventTrace::dumpJson(int fd) {
+    String8 out;
+    dumpJson(out);
+    dprintf(fd, "%s", out.c_str());
+}
+
+}  // namespace uirenderer
+}  // namespace android
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <utils/String8.h>
+#include <utils/Timers.h>
+
+#include <cstddef>
+
+#include "utils/Macros.h"
+
+namespace android {
+namespace uirenderer {
+
+/**
+ * In-process record of named scopes, for attributing frame time to render stages without taking
+ * a system trace.
+ *
+ * Every thread that records gets its own fixed-size ring of events, so recording never takes a
+ * lock and never contends with other threads; only the first event on a thread registers its
+ * ring. Dumping can run concurrently with recording and skips events that are overwritten while
+ * it reads them.
+ *
+ * Scopes are only recorded in builds with HWUI_EVENT_TRACE defined (see the hwui_event_trace
+ * defaults in Android.bp); otherwise HWUI_EVENT_SCOPE compiles to nothing.
+ */
+class EventTrace {
+public:
+    static constexpr size_t kEventsPerThread = 2048;
+
+    // name must outlive the trace, i.e. be a string literal.
+    static void record(const char* name, nsecs_t start, nsecs_t end);
+
+    // Appends every thread's events in the Chrome JSON trace format, which Perfetto's UI and
+    // trace_processor both open.
+    static void dumpJson(String8& out);
+    static void dumpJson(int fd);
+
+    class Scope {
+        PREVENT_COPY_AND_ASSIGN(Scope);
+
+    public:
+        explicit Scope(const char* name)
+                : mName(name), mStart(systemTime(SYSTEM_TIME_MONOTONIC)) {}
+        ~Scope() { record(mName, mStart, systemTime(SYSTEM_TIME_MONOTONIC)); }
+
+    private:
+        const char* mName;
+        const nsecs_t mStart;
+    };
+};
+
+}  // namespace uirenderer
+}  // namespace android
+
+#if defined(HWUI_EVENT_TRACE) && defined(__ANDROID__)
+#define HWUI_EVENT_SCOPE_CONCAT_(a, b) a##b
+#define HWUI_EVENT_SCOPE_CONCAT(a, b) HWUI_EVENT_SCOPE_CONCAT_(a, b)
+#define HWUI_EVENT_SCOPE(name)                                                              \
+    ::android::uirenderer::EventTrace::Scope HWUI_EVENT_SCOPE_CONCAT(__hwuiEventScope, \
+                                                                     __LINE__)(name)
+#else
+#define HWUI_EVENT_SCOPE(name)
+#endif
@@ -52,8 +52,8 @@ public:
         explicit Pointer(size_t chunkSize);
 
         size_t pos() const;
-        size_t index() const;
-        size_t offset() const;
+        inline size_t index() const { return mIndex; }
+        inline size_t offset() const { return mOffset; }
 
         Pointer* move(size_t amt);
         inline Pointer* move() { return move(1); };
@@ -96,6 +96,16 @@ public:
      */
     size_t currentToWrite();
 
+    /**
+     * Returns where to write the next size bytes if they all fit in the current write buffer,
+     * otherwise NULL, and they have to be written with the APIs below. The write pointer must
+     * then be moved past the bytes that were written.
+     */
+    inline uint8_t* writeBufferFor(size_t size) {
+        if (mWp.index() >= mBuffers.size() || size > mChunkSize - mWp.offset()) return NULL;
+        return mBuffers[mWp.index()] + mWp.offset();
+    }
+
     /**
      * Write a single byte to the buffer.
      */
@@ -18,7 +18,10 @@
 #define ANDROID_UTIL_PROTOOUTPUT_STREAM_H
 
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include <android/util/EncodedBuffer.h>
@@ -77,6 +80,17 @@ const uint64_t FIELD_COUNT_SINGLE = 1ULL << FIELD_COUNT_SHIFT;
 const uint64_t FIELD_COUNT_REPEATED = 2ULL << FIELD_COUNT_SHIFT;
 const uint64_t FIELD_COUNT_PACKED = 5ULL << FIELD_COUNT_SHIFT;
 
+/**
+ * The values the typed writers generated by protoc-gen-cppstream accept for each kind of field,
+ * so that e.g. a pointer or a bool written into an integer field fails to compile rather than
+ * being converted.
+ */
+template<typename T>
+constexpr bool is_proto_integer_v = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+        || std::is_enum_v<T>;
+template<typename T>
+constexpr bool is_proto_floating_point_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
 /**
  * Class to write to a protobuf stream.
  *
@@ -139,6 +153,20 @@ public:
     void writeLengthDelimitedHeader(uint32_t id, size_t size);
     void writeRawByte(uint8_t byte);
 
+    /**
+     * Write APIs for the typed writers generated by protoc-gen-cppstream with the typed_writers
+     * option. They check the field types when they are compiled, and pass the tag of the field
+     * already encoded: its tagSize bytes are in the low bytes of tag, the first one lowest.
+     * Returns true if the write succeeds. writeTaggedBytes writes an empty field for a null val
+     * with a size of 0, and nothing for a null val with any other size.
+     */
+    inline bool writeTaggedVarint(uint64_t tag, size_t tagSize, uint64_t val);
+    inline bool writeTaggedFixed32(uint64_t tag, size_t tagSize, uint32_t val);
+    inline bool writeTaggedFixed64(uint64_t tag, size_t tagSize, uint64_t val);
+    inline bool writeTaggedFloat(uint64_t tag, size_t tagSize, float val);
+    inline bool writeTaggedDouble(uint64_t tag, size_t tagSize, double val);
+    bool writeTaggedBytes(uint64_t tag, size_t tagSize, const char* val, size_t size);
+
 private:
     sp<EncodedBuffer> mBuffer;
     size_t mCopyBegin;
@@ -170,8 +198,92 @@ private:
 
     template<typename T>
     bool internalWrite(uint64_t fieldId, T val, const char* typeName);
+
+    void writeTag(uint64_t tag, size_t tagSize);
+    static inline uint8_t* putTag(uint8_t* buf, uint64_t tag, size_t tagSize);
 };
 
+inline uint8_t*
+ProtoOutputStream::putTag(uint8_t* buf, uint64_t tag, size_t tagSize)
+{
+    for (size_t i = 0; i < tagSize; i++) {
+        *buf++ = (uint8_t)(tag >> (8 * i));
+    }
+    return buf;
+}
+
+inline bool
+ProtoOutputStream::writeTaggedVarint(uint64_t tag, size_t tagSize, uint64_t val)
+{
+    if (mCompact) return false;
+    uint8_t* const buf = mBuffer->writeBufferFor(tagSize + 10);
+    if (buf == NULL) {
+        writeTag(tag, tagSize);
+        mBuffer->writeRawVarint64(val);
+        return true;
+    }
+    uint8_t* p = putTag(buf, tag, tagSize);
+    while (val >= 0x80) {
+        *p++ = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    *p++ = (uint8_t)val;
+    mBuffer->wp()->move(p - buf);
+    return true;
+}
+
+inline bool
+ProtoOutputStream::writeTaggedFixed32(uint64_t tag, size_t tagSize, uint32_t val)
+{
+    if (mCompact) return false;
+    uint8_t* const buf = mBuffer->writeBufferFor(tagSize + 4);
+    if (buf == NULL) {
+        writeTag(tag, tagSize);
+        mBuffer->writeRawFixed32(val);
+        return true;
+    }
+    uint8_t* p = putTag(buf, tag, tagSize);
+    for (int i = 0; i < 4; i++) {
+        *p++ = (uint8_t)(val >> (8 * i));
+    }
+    mBuffer->wp()->move(p - buf);
+    return true;
+}
+
+inline bool
+ProtoOutputStream::writeTaggedFixed64(uint64_t tag, size_t tagSize, uint64_t val)
+{
+    if (mCompact) return false;
+    uint8_t* const buf = mBuffer->writeBufferFor(tagSize + 8);
+    if (buf == NULL) {
+        writeTag(tag, tagSize);
+        mBuffer->writeRawFixed64(val);
+        return true;
+    }
+    uint8_t* p = putTag(buf, tag, tagSize);
+    for (int i = 0; i < 8; i++) {
+        *p++ = (uint8_t)(val >> (8 * i));
+    }
+    mBuffer->wp()->move(p - buf);
+    return true;
+}
+
+inline bool
+ProtoOutputStream::writeTaggedFloat(uint64_t tag, size_t tagSize, float val)
+{
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return writeTaggedFixed32(tag, tagSize, bits);
+}
+
+inline bool
+ProtoOutputStream::writeTaggedDouble(uint64_t tag, size_t tagSize, double val)
+{
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return writeTaggedFixed64(tag, tagSize, bits);
+}
+
 }
 }
 
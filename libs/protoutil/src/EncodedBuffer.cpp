@@ -46,18 +46,6 @@ EncodedBuffer::Pointer::pos() const
     return mIndex * mChunkSize + mOffset;
 }
 
-size_t
-EncodedBuffer::Pointer::index() const
-{
-    return mIndex;
-}
-
-size_t
-EncodedBuffer::Pointer::offset() const
-{
-    return mOffset;
-}
-
 EncodedBuffer::Pointer*
 EncodedBuffer::Pointer::move(size_t amt)
 {
@@ -544,6 +544,30 @@ ProtoOutputStream::writeRawByte(uint8_t byte)
     mBuffer->writeRawByte(byte);
 }
 
+bool
+ProtoOutputStream::writeTaggedBytes(uint64_t tag, size_t tagSize, const char* val, size_t size)
+{
+    if (mCompact) return false;
+    if (val == NULL) {
+        // An empty std::string_view has no data, and is still an empty field.
+        if (size != 0) return true;
+        val = "";
+    }
+    writeTag(tag, tagSize);
+    // reserves 64 bits for the size, as writeLengthDelimitedHeader does.
+    mBuffer->writeRawFixed32(size);
+    mBuffer->writeRawFixed32(size);
+    return mBuffer->writeRaw((const uint8_t*)val, size) == NO_ERROR;
+}
+
+void
+ProtoOutputStream::writeTag(uint64_t tag, size_t tagSize)
+{
+    for (size_t i = 0; i < tagSize; i++) {
+        mBuffer->writeRawByte((uint8_t)(tag >> (8 * i)));
+    }
+}
+
 
 // =========================================================================
 // Private functions
@@ -356,3 +356,71 @@ TEST(ProtoOutputStreamTest, NoStartCalled) {
     EXPECT_EQ(proto.size(), 0);
     EXPECT_FALSE(proto.flush(STDOUT_FILENO));
 }
+
+TEST(ProtoOutputStreamTest, TaggedWritesMatchWrites) {
+    const char b[5] = { 'a', 'p', 'p', 'l', 'e' };
+
+    ProtoOutputStream expected;
+    ProtoOutputStream tagged;
+    // Write enough to go over more than one buffer of the EncodedBuffer.
+    for (int i = 0; i < 1000; i++) {
+        expected.write(FIELD_TYPE_INT32 | PrimitiveProto::kValInt32FieldNumber, -i);
+        expected.write(FIELD_TYPE_UINT64 | PrimitiveProto::kValUint64FieldNumber, 57LL << i % 60);
+        expected.write(FIELD_TYPE_FLOAT | PrimitiveProto::kValFloatFieldNumber, -23.5f * i);
+        expected.write(FIELD_TYPE_DOUBLE | PrimitiveProto::kValDoubleFieldNumber, 324.5 * i);
+        expected.write(FIELD_TYPE_FIXED32 | PrimitiveProto::kValFixed32FieldNumber, -20 * i);
+        expected.write(FIELD_TYPE_SFIXED64 | PrimitiveProto::kValSfixed64FieldNumber, -54LL * i);
+        expected.write(FIELD_TYPE_BOOL | PrimitiveProto::kValBoolFieldNumber, i % 2 == 0);
+        expected.write(FIELD_TYPE_STRING | PrimitiveProto::kValStringFieldNumber,
+                std::string_view("hello"));
+        expected.write(FIELD_TYPE_BYTES | PrimitiveProto::kValBytesFieldNumber, b, 5);
+        expected.write(FIELD_TYPE_ENUM | PrimitiveProto::kValEnumFieldNumber, 2);
+
+        EXPECT_TRUE(tagged.writeTaggedVarint(0x08, 1, (uint32_t)-i));
+        EXPECT_TRUE(tagged.writeTaggedVarint(0x30, 1, 57ULL << i % 60));
+        EXPECT_TRUE(tagged.writeTaggedFloat(0x1d, 1, -23.5f * i));
+        EXPECT_TRUE(tagged.writeTaggedDouble(0x21, 1, 324.5 * i));
+        EXPECT_TRUE(tagged.writeTaggedFixed32(0x3d, 1, -20 * i));
+        EXPECT_TRUE(tagged.writeTaggedFixed64(0x69, 1, -54LL * i));
+        EXPECT_TRUE(tagged.writeTaggedVarint(0x48, 1, i % 2 == 0));
+        EXPECT_TRUE(tagged.writeTaggedBytes(0x52, 1, "hello", 5));
+        EXPECT_TRUE(tagged.writeTaggedBytes(0x5a, 1, b, 5));
+        EXPECT_TRUE(tagged.writeTaggedVarint(0x0180, 2, 2));
+    }
+
+    std::string expectedString;
+    std::string taggedString;
+    ASSERT_TRUE(expected.serializeToString(&expectedString));
+    ASSERT_TRUE(tagged.serializeToString(&taggedString));
+    EXPECT_EQ(expectedString, taggedString);
+
+    PrimitiveProto primitives;
+    ASSERT_TRUE(primitives.ParseFromString(taggedString));
+    EXPECT_EQ(primitives.val_uint64(), 57ULL << 999 % 60);
+    EXPECT_THAT(primitives.val_string(), StrEq("hello"));
+    EXPECT_EQ(primitives.val_enum(), PrimitiveProto_Count_TWO);
+
+    // Nothing can be written once the data is compacted.
+    EXPECT_FALSE(tagged.writeTaggedVarint(0x08, 1, 1));
+}
+
+TEST(ProtoOutputStreamTest, TaggedWritesEmptyStrings) {
+    // What a typed writer passes on for an empty std::string_view: no data, and no size.
+    const std::string_view empty;
+    ASSERT_EQ(nullptr, empty.data());
+
+    ProtoOutputStream tagged;
+    EXPECT_TRUE(tagged.writeTaggedBytes(0x52, 1, empty.data(), empty.size()));
+    EXPECT_TRUE(tagged.writeTaggedBytes(0x52, 1, "", 0));
+    // A null val with a size is not a string, and writes nothing.
+    EXPECT_TRUE(tagged.writeTaggedBytes(0x52, 1, nullptr, 3));
+
+    std::string taggedString;
+    ASSERT_TRUE(tagged.serializeToString(&taggedString));
+    EXPECT_EQ(std::string("\x52\x00\x52\x00", 4), taggedString);
+
+    PrimitiveProto primitives;
+    ASSERT_TRUE(primitives.ParseFromString(taggedString));
+    EXPECT_TRUE(primitives.has_val_string());
+    EXPECT_THAT(primitives.val_string(), StrEq(""));
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file sharedmem_pool.h
+ * @brief Recycles shared memory regions between short-lived users.
+ */
+
+#ifndef ANDROID_SHARED_MEMORY_POOL_H
+#define ANDROID_SHARED_MEMORY_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+/**
+ * A pool of shared memory regions, which hands out regions released to it instead of
+ * creating new ones. Regions are kept by size class: a region from the pool may be larger
+ * than was asked for, by up to a quarter, and ASharedMemory_getSize() gives its real size.
+ *
+ * A pool can be used from any thread.
+ *
+ * Introduced in API 35.
+ */
+typedef struct ASharedMemoryPool ASharedMemoryPool;
+
+/**
+ * What a pool does to a region released to it before handing it out again.
+ */
+enum {
+    /** The region is handed out again as it was released. */
+    ASHAREDMEMORY_POOL_RESET_NONE = 0,
+    /** The region is zeroed, as a new region would be. */
+    ASHAREDMEMORY_POOL_RESET_ZERO = 1,
+};
+
+/**
+ * Creates a pool.
+ *
+ * \param name an optional name for the regions it creates.
+ * \param maxCachedBytes how many bytes of released regions to keep at most. Regions
+ *        released beyond that are closed.
+ * \param resetMode one of ASHAREDMEMORY_POOL_RESET_*.
+ * \return the pool, or NULL if resetMode is not valid.
+ */
+ASharedMemoryPool* ASharedMemoryPool_create(const char* name, size_t maxCachedBytes,
+        int32_t resetMode) __INTRODUCED_IN(35);
+
+/**
+ * Closes the regions kept by the pool, and frees it. Regions handed out by the pool stay valid.
+ */
+void ASharedMemoryPool_destroy(ASharedMemoryPool* pool) __INTRODUCED_IN(35);
+
+/**
+ * Hands out a region of at least size bytes, like ASharedMemory_create() would.
+ *
+ * \return a file descriptor owned by the caller, or a negative value on error.
+ */
+int ASharedMemoryPool_acquire(ASharedMemoryPool* pool, size_t size) __INTRODUCED_IN(35);
+
+/**
+ * Gives a region back to the pool, which takes ownership of fd. The caller must have unmapped
+ * it, and must not have shared it with another process or kept a duplicate of fd, since the
+ * region is handed out again. Regions that can no longer be written, after
+ * ASharedMemory_setProt() removed PROT_WRITE, are closed instead of kept.
+ *
+ * \return 0 on success, or a negative value if fd is not a shared memory region. fd is closed
+ * in that case too.
+ */
+int ASharedMemoryPool_release(ASharedMemoryPool* pool, int fd) __INTRODUCED_IN(35);
+
+/**
+ * Closes the regions kept by the pool, for example when the process is asked to trim memory.
+ */
+void ASharedMemoryPool_trim(ASharedMemoryPool* pool) __INTRODUCED_IN(35);
+
+__END_DECLS
+
+#endif // ANDROID_SHARED_MEMORY_POOL_H
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <android/sharedmem_pool.h>
+
+#include <fcntl.h>
+#include <linux/ashmem.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cutils/ashmem.h>
+#include <utils/Errors.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ASharedMemoryPool {
+    std::string name;
+    size_t maxCachedBytes;
+    int32_t resetMode;
+
+    std::mutex lock;
+    std::map<size_t, std::vector<int>> regions;  // released regions by size class
+    size_t cachedBytes = 0;  // of regions, and of regions being released into it
+};
+
+// Rounds size up to whole pages, and then to one of four steps between powers of two, so
+// that a region handed out is at most a quarter larger than asked for.
+static size_t sizeClass(size_t size) {
+    static const size_t kPageSize = getpagesize();
+    size = (size + kPageSize - 1) & ~(kPageSize - 1);
+    if (size <= 4 * kPageSize) {
+        return size;
+    }
+    const size_t step = size_t(1) << (63 - __builtin_clzll(size - 1) - 2);
+    return (size + step - 1) & ~(step - 1);
+}
+
+// Whether a region can still be mapped writable: memfd regions lose it with a write seal, and
+// ashmem regions once PROT_WRITE is removed from their protection mask.
+static bool isWritable(int fd) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals >= 0) {
+        return (seals & (F_SEAL_WRITE | F_SEAL_FUTURE_WRITE)) == 0;
+    }
+    int prot = ioctl(fd, ASHMEM_GET_PROT_MASK);
+    return prot >= 0 && (prot & PROT_WRITE) != 0;
+}
+
+static bool zeroRegion(int fd, size_t size) {
+    // Punching out the pages of a memfd region frees them, and they read back as zeroes.
+    if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, size) == 0) {
+        return true;
+    }
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    memset(addr, 0, size);
+    munmap(addr, size);
+    return true;
+}
+
+static void closeRegions(ASharedMemoryPool* pool) {
+    std::map<size_t, std::vector<int>> regions;
+    size_t closedBytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(pool->lock);
+        regions.swap(pool->regions);
+        for (const auto& [size, fds] : regions) {
+            closedBytes += size * fds.size();
+        }
+        // Regions being released concurrently stay counted.
+        pool->cachedBytes -= closedBytes;
+    }
+    for (const auto& [size, fds] : regions) {
+        for (int fd : fds) {
+            close(fd);
+        }
+    }
+}
+
+ASharedMemoryPool* ASharedMemoryPool_create(const char* name, size_t maxCachedBytes,
+        int32_t resetMode) {
+    if (resetMode != ASHAREDMEMORY_POOL_RESET_NONE && resetMode != ASHAREDMEMORY_POOL_RESET_ZERO) {
+        return nullptr;
+    }
+    ASharedMemoryPool* pool = new ASharedMemoryPool();
+    pool->name = name != nullptr ? name : "";
+    pool->maxCachedBytes = maxCachedBytes;
+    pool->resetMode = resetMode;
+    return pool;
+}
+
+void ASharedMemoryPool_destroy(ASharedMemoryPool* pool) {
+    if (pool == nullptr) {
+        return;
+    }
+    closeRegions(pool);
+    delete pool;
+}
+
+int ASharedMemoryPool_acquire(ASharedMemoryPool* pool, size_t size) {
+    if (size == 0) {
+        return android::BAD_VALUE;
+    }
+    size = sizeClass(size);
+    {
+        std::lock_guard<std::mutex> lock(pool->lock);
+        auto it = pool->regions.find(size);
+        if (it != pool->regions.end() && !it->second.empty()) {
+            int fd = it->second.back();
+            it->second.pop_back();
+            pool->cachedBytes -= size;
+            return fd;
+        }
+    }
+    return ashmem_create_region(pool->name.empty() ? nullptr : pool->name.c_str(), size);
+}
+
+int ASharedMemoryPool_release(ASharedMemoryPool* pool, int fd) {
+    if (!ashmem_valid(fd)) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return android::BAD_VALUE;
+    }
+    const int size = ashmem_get_size_region(fd);
+    if (size <= 0 || size_t(size) != sizeClass(size) || !isWritable(fd)) {
+        close(fd);
+        return 0;
+    }
+
+    // Make room for the region before zeroing it, so that one about to be closed is not zeroed.
+    bool keep;
+    {
+        std::lock_guard<std::mutex> lock(pool->lock);
+        keep = pool->cachedBytes + size <= pool->maxCachedBytes;
+        if (keep) {
+            pool->cachedBytes += size;
+        }
+    }
+    if (keep && pool->resetMode == ASHAREDMEMORY_POOL_RESET_ZERO && !zeroRegion(fd, size)) {
+        std::lock_guard<std::mutex> lock(pool->lock);
+        pool->cachedBytes -= size;
+        keep = false;
+    }
+    if (!keep) {
+        close(fd);
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->lock);
+    pool->regions[size].push_back(fd);
+    return 0;
+}
+
+void ASharedMemoryPool_trim(ASharedMemoryPool* pool) {
+    closeRegions(pool);
+}
@@ -32,8 +32,12 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 struct XmlCharDeleter {
@@ -84,16 +88,57 @@ struct FontHasher {
     std::size_t combine(std::size_t l, std::size_t r) const { return l ^ (r << 1); }
 };
 
-struct ASystemFontIterator {
-    std::vector<AFont> fonts;
-    uint32_t index;
-
-    XmlDocUniquePtr mXmlDoc;
+// The system fonts in one flat block of memory that refers to its parts by offset, so that
+// iterators share it instead of resolving the fonts again each time one is opened.
+class FontCatalogue {
+public:
+    static std::shared_ptr<const FontCatalogue> create(const std::vector<AFont>& fonts);
+
+    uint32_t size() const { return header()->fontCount; }
+
+    void getFont(uint32_t index, AFont* out) const;
+
+private:
+    static constexpr uint32_t kNoLocale = UINT32_MAX;
+
+    struct Header {
+        uint32_t fontCount;
+        uint32_t axisCount;
+    };
+
+    struct Font {
+        uint32_t pathOffset;    // into the strings
+        uint32_t localeOffset;  // into the strings, or kNoLocale
+        uint32_t collectionIndex;
+        uint32_t firstAxis;
+        uint32_t axisCount;
+        uint16_t weight;
+        uint16_t italic;
+    };
+
+    struct Axis {
+        uint32_t tag;
+        float value;
+    };
+
+    FontCatalogue() = default;
+
+    const Header* header() const { return reinterpret_cast<const Header*>(mData.data()); }
+    const Font* fonts() const { return reinterpret_cast<const Font*>(header() + 1); }
+    const Axis* axes() const {
+        return reinterpret_cast<const Axis*>(fonts() + header()->fontCount);
+    }
+    const char* strings() const {
+        return reinterpret_cast<const char*>(axes() + header()->axisCount);
+    }
 
-    ParserState state;
+    // The header, the fonts, their axes, then the NUL terminated strings they refer to.
+    std::vector<uint32_t> mData;
+};
 
-    // The OEM customization XML.
-    XmlDocUniquePtr mCustomizationXmlDoc;
+struct ASystemFontIterator {
+    std::shared_ptr<const FontCatalogue> mCatalogue;
+    uint32_t mIndex = 0;
 };
 
 struct AFontMatcher {
@@ -236,39 +281,202 @@ bool findFirstFontNode(const XmlDocUniquePtr& doc, ParserState* state) {
 
 }  // namespace
 
-ASystemFontIterator* ASystemFontIterator_open() {
-    std::unique_ptr<ASystemFontIterator> ite(new ASystemFontIterator());
+std::shared_ptr<const FontCatalogue> FontCatalogue::create(const std::vector<AFont>& fonts) {
+    std::vector<Font> records;
+    records.reserve(fonts.size());
+    std::vector<Axis> axes;
+    std::string strings;
+    std::unordered_map<std::string, uint32_t> stringOffsets;
+    auto addString = [&strings, &stringOffsets](const std::string& str) {
+        auto [it, inserted] = stringOffsets.try_emplace(str, strings.size());
+        if (inserted) {
+            strings.append(str.c_str(), str.size() + 1);
+        }
+        return it->second;
+    };
+
+    for (const AFont& font : fonts) {
+        records.push_back({addString(font.mFilePath),
+                           font.mLocale ? addString(*font.mLocale) : kNoLocale,
+                           font.mCollectionIndex, static_cast<uint32_t>(axes.size()),
+                           static_cast<uint32_t>(font.mAxes.size()), font.mWeight,
+                           font.mItalic});
+        for (const auto& [tag, value] : font.mAxes) {
+            axes.push_back({tag, value});
+        }
+    }
+
+    const Header header = {static_cast<uint32_t>(records.size()),
+                           static_cast<uint32_t>(axes.size())};
+    const size_t size = sizeof(header) + records.size() * sizeof(Font) +
+            axes.size() * sizeof(Axis) + strings.size();
+    std::shared_ptr<FontCatalogue> catalogue(new FontCatalogue());
+    catalogue->mData.resize((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    uint8_t* out = reinterpret_cast<uint8_t*>(catalogue->mData.data());
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    memcpy(out, records.data(), records.size() * sizeof(Font));
+    out += records.size() * sizeof(Font);
+    memcpy(out, axes.data(), axes.size() * sizeof(Axis));
+    out += axes.size() * sizeof(Axis);
+    memcpy(out, strings.data(), strings.size());
+    return catalogue;
+}
+
+void FontCatalogue::getFont(uint32_t index, AFont* out) const {
+    const Font& font = fonts()[index];
+    out->mFilePath = strings() + font.pathOffset;
+    if (font.localeOffset != kNoLocale) {
+        out->mLocale.emplace(strings() + font.localeOffset);
+    }
+    out->mWeight = font.weight;
+    out->mItalic = font.italic != 0;
+    out->mCollectionIndex = font.collectionIndex;
+    const Axis* axis = axes() + font.firstAxis;
+    out->mAxes.reserve(font.axisCount);
+    for (uint32_t i = 0; i < font.axisCount; i++, axis++) {
+        out->mAxes.push_back(std::make_pair(axis->tag, axis->value));
+    }
+}
+
+bool findNextFontNode(const XmlDocUniquePtr& xmlDoc, ParserState* state) {
+    if (state->mFontNode == nullptr) {
+        if (!xmlDoc) {
+            return false;  // Already at the end.
+        } else {
+            // First time to query font.
+            return findFirstFontNode(xmlDoc, state);
+        }
+    } else {
+        xmlNode* nextNode = nextSibling(state->mFontNode, FONT_TAG);
+        while (nextNode == nullptr) {
+            xmlNode* family = nextSibling(state->mFontNode->parent, FAMILY_TAG);
+            if (family == nullptr) {
+                break;
+            }
+            state->mLocale.reset(xmlGetProp(family, LOCALE_ATTR_NAME));
+            nextNode = firstElement(family, FONT_TAG);
+        }
+        state->mFontNode = nextNode;
+        return nextNode != nullptr;
+    }
+}
 
+namespace {
+
+const char* FONTS_XML_PATH = "/system/etc/fonts.xml";
+const char* CUSTOMIZATION_XML_PATH = "/product/etc/fonts_customization.xml";
+
+// Identifies the XML files a catalogue was built from, so that it is only built again when they
+// change.
+using CatalogueStamp = std::vector<uint64_t>;
+
+struct CatalogueCache {
+    std::mutex mLock;
+    std::shared_ptr<const FontCatalogue> mCatalogue;
+    // What mCatalogue was built from: either the fonts loaded into minikin, held so that a font
+    // freed since cannot be mistaken for a new one at the same address, or the XML files.
+    std::vector<std::shared_ptr<minikin::Font>> mFontSet;
+    CatalogueStamp mStamp;
+};
+
+CatalogueCache& getCatalogueCache() {
+    static CatalogueCache* cache = new CatalogueCache();
+    return *cache;
+}
+
+void addFileStamp(const char* path, CatalogueStamp* stamp) {
+    struct stat st = {};
+    if (stat(path, &st) != 0) {
+        stamp->push_back(0);
+        return;
+    }
+    stamp->insert(stamp->end(),
+                  {static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino),
+                   static_cast<uint64_t>(st.st_size), static_cast<uint64_t>(st.st_mtim.tv_sec),
+                   static_cast<uint64_t>(st.st_mtim.tv_nsec)});
+}
+
+std::vector<AFont> fontsFromFontSet(const std::vector<std::shared_ptr<minikin::Font>>& fontSet) {
     std::unordered_set<AFont, FontHasher> fonts;
+    for (const auto& font : fontSet) {
+        std::optional<std::string> locale;
+        uint32_t localeId = font->getLocaleListId();
+        if (localeId != minikin::kEmptyLocaleListId) {
+            locale.emplace(minikin::getLocaleString(localeId));
+        }
+        std::vector<std::pair<uint32_t, float>> axes;
+        for (const auto& [tag, value] : font->baseTypeface()->GetAxes()) {
+            axes.push_back(std::make_pair(tag, value));
+        }
+
+        fonts.insert({font->baseTypeface()->GetFontPath(), std::move(locale),
+                      font->style().weight(),
+                      font->style().slant() == minikin::FontStyle::Slant::ITALIC,
+                      static_cast<uint32_t>(font->baseTypeface()->GetFontIndex()), axes});
+    }
+    return std::vector<AFont>(fonts.begin(), fonts.end());
+}
+
+// Only lists the fonts whose files exist. Font files live on read-only partitions, so the
+// catalogue keeps the result rather than checking again for every iterator.
+void addFontsFromXml(const char* xmlPath, const std::string& pathPrefix,
+                     std::vector<AFont>* out) {
+    XmlDocUniquePtr xmlDoc(xmlReadFile(xmlPath, nullptr, 0));
+    ParserState state;
+    while (findNextFontNode(xmlDoc, &state)) {
+        AFont font;
+        copyFont(xmlDoc, state, &font, pathPrefix);
+        if (isFontFileAvailable(font.mFilePath)) {
+            out->push_back(std::move(font));
+        }
+    }
+}
+
+// Returns the catalogue of the fonts loaded into minikin, or of the fonts listed in the XML
+// files if there are none, building it again only if they changed since it was last built.
+std::shared_ptr<const FontCatalogue> getSystemFontCatalogue() {
+    CatalogueCache& cache = getCatalogueCache();
+    std::lock_guard<std::mutex> lock(cache.mLock);
+
+    // Fonts are never modified, so the same fonts mean the same font set.
+    bool hasFontSet = false;
     minikin::SystemFonts::getFontSet(
-            [&fonts](const std::vector<std::shared_ptr<minikin::Font>>& fontSet) {
-                for (const auto& font : fontSet) {
-                    std::optional<std::string> locale;
-                    uint32_t localeId = font->getLocaleListId();
-                    if (localeId != minikin::kEmptyLocaleListId) {
-                        locale.emplace(minikin::getLocaleString(localeId));
-                    }
-                    std::vector<std::pair<uint32_t, float>> axes;
-                    for (const auto& [tag, value] : font->baseTypeface()->GetAxes()) {
-                        axes.push_back(std::make_pair(tag, value));
-                    }
-
-                    fonts.insert({font->baseTypeface()->GetFontPath(), std::move(locale),
-                                  font->style().weight(),
-                                  font->style().slant() == minikin::FontStyle::Slant::ITALIC,
-                                  static_cast<uint32_t>(font->baseTypeface()->GetFontIndex()),
-                                  axes});
+            [&](const std::vector<std::shared_ptr<minikin::Font>>& fontSet) {
+                if (fontSet.empty()) {
+                    return;
+                }
+                hasFontSet = true;
+                if (cache.mCatalogue == nullptr || fontSet != cache.mFontSet) {
+                    cache.mCatalogue = FontCatalogue::create(fontsFromFontSet(fontSet));
+                    cache.mFontSet = fontSet;
+                    cache.mStamp.clear();
                 }
             });
+    if (hasFontSet) {
+        return cache.mCatalogue;
+    }
 
-    if (fonts.empty()) {
-        ite->mXmlDoc.reset(xmlReadFile("/system/etc/fonts.xml", nullptr, 0));
-        ite->mCustomizationXmlDoc.reset(
-                xmlReadFile("/product/etc/fonts_customization.xml", nullptr, 0));
-    } else {
-        ite->index = 0;
-        ite->fonts.assign(fonts.begin(), fonts.end());
+    CatalogueStamp stamp;
+    addFileStamp(FONTS_XML_PATH, &stamp);
+    addFileStamp(CUSTOMIZATION_XML_PATH, &stamp);
+    if (cache.mCatalogue == nullptr || stamp != cache.mStamp) {
+        std::vector<AFont> fonts;
+        addFontsFromXml(FONTS_XML_PATH, "/system/fonts/", &fonts);
+        // TODO: Filter only customizationType="new-named-family"
+        addFontsFromXml(CUSTOMIZATION_XML_PATH, "/product/fonts/", &fonts);
+        cache.mCatalogue = FontCatalogue::create(fonts);
+        cache.mFontSet.clear();
+        cache.mStamp = std::move(stamp);
     }
+    return cache.mCatalogue;
+}
+
+}  // namespace
+
+ASystemFontIterator* ASystemFontIterator_open() {
+    std::unique_ptr<ASystemFontIterator> ite(new ASystemFontIterator());
+    ite->mCatalogue = getSystemFontCatalogue();
     return ite.release();
 }
 
@@ -338,67 +546,14 @@ AFont* _Nonnull AFontMatcher_match(
     return result.release();
 }
 
-bool findNextFontNode(const XmlDocUniquePtr& xmlDoc, ParserState* state) {
-    if (state->mFontNode == nullptr) {
-        if (!xmlDoc) {
-            return false;  // Already at the end.
-        } else {
-            // First time to query font.
-            return findFirstFontNode(xmlDoc, state);
-        }
-    } else {
-        xmlNode* nextNode = nextSibling(state->mFontNode, FONT_TAG);
-        while (nextNode == nullptr) {
-            xmlNode* family = nextSibling(state->mFontNode->parent, FAMILY_TAG);
-            if (family == nullptr) {
-                break;
-            }
-            state->mLocale.reset(xmlGetProp(family, LOCALE_ATTR_NAME));
-            nextNode = firstElement(family, FONT_TAG);
-        }
-        state->mFontNode = nextNode;
-        return nextNode != nullptr;
-    }
-}
-
 AFont* ASystemFontIterator_next(ASystemFontIterator* ite) {
     LOG_ALWAYS_FATAL_IF(ite == nullptr, "nullptr has passed as iterator argument");
-    if (!ite->fonts.empty()) {
-        if (ite->index >= ite->fonts.size()) {
-            return nullptr;
-        }
-        return new AFont(ite->fonts[ite->index++]);
-    }
-
-    if (ite->mXmlDoc) {
-        if (!findNextFontNode(ite->mXmlDoc, &ite->state)) {
-            // Reached end of the XML file. Continue OEM customization.
-            ite->mXmlDoc.reset();
-        } else {
-            std::unique_ptr<AFont> font = std::make_unique<AFont>();
-            copyFont(ite->mXmlDoc, ite->state, font.get(), "/system/fonts/");
-            if (!isFontFileAvailable(font->mFilePath)) {
-                return ASystemFontIterator_next(ite);
-            }
-            return font.release();
-        }
+    if (ite->mIndex >= ite->mCatalogue->size()) {
+        return nullptr;
     }
-    if (ite->mCustomizationXmlDoc) {
-        // TODO: Filter only customizationType="new-named-family"
-        if (!findNextFontNode(ite->mCustomizationXmlDoc, &ite->state)) {
-            // Reached end of the XML file. Finishing
-            ite->mCustomizationXmlDoc.reset();
-            return nullptr;
-        } else {
-            std::unique_ptr<AFont> font = std::make_unique<AFont>();
-            copyFont(ite->mCustomizationXmlDoc, ite->state, font.get(), "/product/fonts/");
-            if (!isFontFileAvailable(font->mFilePath)) {
-                return ASystemFontIterator_next(ite);
-            }
-            return font.release();
-        }
-    }
-    return nullptr;
+    std::unique_ptr<AFont> font = std::make_unique<AFont>();
+    ite->mCatalogue->getFont(ite->mIndex++, font.get());
+    return font.release();
 }
 
 void AFont_close(AFont* font) {
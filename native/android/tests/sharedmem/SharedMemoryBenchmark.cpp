@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <android/sharedmem.h>
+#include <android/sharedmem_pool.h>
+#include <benchmark/benchmark.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Touches every page of a region once mapped, as a producer filling a buffer would.
+static void fillRegion(benchmark::State& state, int fd, size_t size) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        state.SkipWithError("mmap failed");
+        return;
+    }
+    const size_t pageSize = getpagesize();
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        static_cast<char*>(addr)[offset] = 1;
+    }
+    benchmark::ClobberMemory();
+    munmap(addr, size);
+}
+
+static void BM_SharedMemoryCreate(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        int fd = ASharedMemory_create("benchmark", size);
+        if (fd < 0) {
+            state.SkipWithError("ASharedMemory_create failed");
+            break;
+        }
+        fillRegion(state, fd, size);
+        close(fd);
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_SharedMemoryCreate)->RangeMultiplier(16)->Range(4 << 10, 4 << 20);
+
+static void BM_SharedMemoryPool(benchmark::State& state) {
+    const size_t size = state.range(0);
+    ASharedMemoryPool* pool = ASharedMemoryPool_create("benchmark", 16 << 20,
+            state.range(1) ? ASHAREDMEMORY_POOL_RESET_ZERO : ASHAREDMEMORY_POOL_RESET_NONE);
+    for (auto _ : state) {
+        int fd = ASharedMemoryPool_acquire(pool, size);
+        if (fd < 0) {
+            state.SkipWithError("ASharedMemoryPool_acquire failed");
+            break;
+        }
+        fillRegion(state, fd, size);
+        ASharedMemoryPool_release(pool, fd);
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+    ASharedMemoryPool_destroy(pool);
+}
+BENCHMARK(BM_SharedMemoryPool)
+        ->ArgNames({"size", "zero"})
+        ->ArgsProduct({benchmark::CreateRange(4 << 10, 4 << 20, 16), {0, 1}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <android/sharedmem.h>
+#include <android/sharedmem_pool.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+namespace {
+
+const size_t kPageSize = getpagesize();
+
+// Fills the region with value, and returns false if it cannot be mapped writable.
+bool fill(int fd, uint8_t value) {
+    const size_t size = ASharedMemory_getSize(fd);
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    memset(addr, value, size);
+    munmap(addr, size);
+    return true;
+}
+
+// Whether every byte of the region is value.
+bool filledWith(int fd, uint8_t value) {
+    const size_t size = ASharedMemory_getSize(fd);
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(addr);
+    const bool filled = std::all_of(bytes, bytes + size, [value](uint8_t b) { return b == value; });
+    munmap(addr, size);
+    return filled;
+}
+
+struct PoolDeleter {
+    void operator()(ASharedMemoryPool* pool) { ASharedMemoryPool_destroy(pool); }
+};
+using Pool = std::unique_ptr<ASharedMemoryPool, PoolDeleter>;
+
+Pool createPool(size_t maxCachedBytes, int32_t resetMode) {
+    return Pool(ASharedMemoryPool_create("SharedMemoryPoolTest", maxCachedBytes, resetMode));
+}
+
+TEST(SharedMemoryPoolTest, RejectsBadArguments) {
+    EXPECT_EQ(nullptr, createPool(0, 2));
+    Pool pool = createPool(0, ASHAREDMEMORY_POOL_RESET_NONE);
+    ASSERT_NE(nullptr, pool);
+    EXPECT_LT(ASharedMemoryPool_acquire(pool.get(), 0), 0);
+    EXPECT_LT(ASharedMemoryPool_release(pool.get(), -1), 0);
+}
+
+TEST(SharedMemoryPoolTest, ClosesRejectedFds) {
+    Pool pool = createPool(0, ASHAREDMEMORY_POOL_RESET_NONE);
+    ASSERT_NE(nullptr, pool);
+    int pipeFds[2];
+    ASSERT_EQ(0, pipe(pipeFds));
+    close(pipeFds[1]);
+    EXPECT_LT(ASharedMemoryPool_release(pool.get(), pipeFds[0]), 0);
+    EXPECT_EQ(-1, fcntl(pipeFds[0], F_GETFD));
+}
+
+TEST(SharedMemoryPoolTest, RoundsUpToSizeClass) {
+    Pool pool = createPool(0, ASHAREDMEMORY_POOL_RESET_NONE);
+    ASSERT_NE(nullptr, pool);
+
+    const size_t sizes[] = {
+        1, kPageSize, kPageSize + 1, 4 * kPageSize, 4 * kPageSize + 1, 9 * kPageSize, 1000000,
+    };
+    const size_t expected[] = {
+        kPageSize, kPageSize, 2 * kPageSize, 4 * kPageSize, 5 * kPageSize, 10 * kPageSize,
+        1048576,
+    };
+    for (size_t i = 0; i < std::size(sizes); i++) {
+        int fd = ASharedMemoryPool_acquire(pool.get(), sizes[i]);
+        ASSERT_GE(fd, 0);
+        EXPECT_EQ(expected[i], ASharedMemory_getSize(fd)) << sizes[i];
+        close(fd);
+    }
+}
+
+TEST(SharedMemoryPoolTest, ResetNoneKeepsContents) {
+    Pool pool = createPool(1 << 20, ASHAREDMEMORY_POOL_RESET_NONE);
+    ASSERT_NE(nullptr, pool);
+
+    int fd = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(fill(fd, 0x5a));
+    ASSERT_EQ(0, ASharedMemoryPool_release(pool.get(), fd));
+
+    // The same size class gets the region back.
+    fd = ASharedMemoryPool_acquire(pool.get(), kPageSize / 2);
+    ASSERT_GE(fd, 0);
+    EXPECT_TRUE(filledWith(fd, 0x5a));
+    close(fd);
+}
+
+TEST(SharedMemoryPoolTest, ResetZeroHandsOutZeroedPages) {
+    Pool pool = createPool(1 << 20, ASHAREDMEMORY_POOL_RESET_ZERO);
+    ASSERT_NE(nullptr, pool);
+
+    for (size_t size : {kPageSize, 16 * kPageSize}) {
+        int fd = ASharedMemoryPool_acquire(pool.get(), size);
+        ASSERT_GE(fd, 0);
+        ASSERT_TRUE(fill(fd, 0xff));
+        ASSERT_EQ(0, ASharedMemoryPool_release(pool.get(), fd));
+
+        fd = ASharedMemoryPool_acquire(pool.get(), size);
+        ASSERT_GE(fd, 0);
+        EXPECT_TRUE(filledWith(fd, 0)) << size;
+        close(fd);
+    }
+}
+
+TEST(SharedMemoryPoolTest, ClosesReadOnlyRegions) {
+    Pool pool = createPool(1 << 20, ASHAREDMEMORY_POOL_RESET_NONE);
+    ASSERT_NE(nullptr, pool);
+
+    int fd = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(fill(fd, 0x5a));
+    ASSERT_EQ(0, ASharedMemory_setProt(fd, PROT_READ));
+    ASSERT_EQ(0, ASharedMemoryPool_release(pool.get(), fd));
+
+    // A new region is handed out, which can be written.
+    fd = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(fd, 0);
+    EXPECT_TRUE(filledWith(fd, 0));
+    EXPECT_TRUE(fill(fd, 0x5a));
+    close(fd);
+}
+
+TEST(SharedMemoryPoolTest, KeepsAtMostMaxCachedBytes) {
+    Pool pool = createPool(kPageSize, ASHAREDMEMORY_POOL_RESET_NONE);
+    ASSERT_NE(nullptr, pool);
+
+    int first = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    int second = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(first, 0);
+    ASSERT_GE(second, 0);
+    ASSERT_TRUE(fill(first, 1));
+    ASSERT_TRUE(fill(second, 2));
+    ASSERT_EQ(0, ASharedMemoryPool_release(pool.get(), first));
+    ASSERT_EQ(0, ASharedMemoryPool_release(pool.get(), second));  // over the cap, closed
+
+    first = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    second = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(first, 0);
+    ASSERT_GE(second, 0);
+    EXPECT_TRUE(filledWith(first, 1));
+    EXPECT_TRUE(filledWith(second, 0));
+    close(first);
+    close(second);
+}
+
+TEST(SharedMemoryPoolTest, TrimClosesKeptRegions) {
+    Pool pool = createPool(1 << 20, ASHAREDMEMORY_POOL_RESET_NONE);
+    ASSERT_NE(nullptr, pool);
+
+    int fd = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(fill(fd, 0x5a));
+    ASSERT_EQ(0, ASharedMemoryPool_release(pool.get(), fd));
+    ASharedMemoryPool_trim(pool.get());
+
+    fd = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(fd, 0);
+    EXPECT_TRUE(filledWith(fd, 0));
+    ASSERT_TRUE(fill(fd, 0x5a));
+
+    // Trimming leaves room for as much as before.
+    ASSERT_EQ(0, ASharedMemoryPool_release(pool.get(), fd));
+    fd = ASharedMemoryPool_acquire(pool.get(), kPageSize);
+    ASSERT_GE(fd, 0);
+    EXPECT_TRUE(filledWith(fd, 0x5a));
+    close(fd);
+}
+
+} // namespace
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android/font.h>
+#include <android/system_fonts.h>
+#include <benchmark/benchmark.h>
+
+static void BM_SystemFontIteratorOpen(benchmark::State& state) {
+    for (auto _ : state) {
+        ASystemFontIterator* ite = ASystemFontIterator_open();
+        benchmark::DoNotOptimize(ite);
+        ASystemFontIterator_close(ite);
+    }
+}
+BENCHMARK(BM_SystemFontIteratorOpen);
+
+// Enumerates every system font and its axes, as an app picking fonts at startup would.
+static void BM_SystemFontIteratorNext(benchmark::State& state) {
+    size_t fonts = 0;
+    for (auto _ : state) {
+        ASystemFontIterator* ite = ASystemFontIterator_open();
+        while (AFont* font = ASystemFontIterator_next(ite)) {
+            benchmark::DoNotOptimize(AFont_getFontFilePath(font));
+            benchmark::DoNotOptimize(AFont_getAxisCount(font));
+            AFont_close(font);
+            fonts++;
+        }
+        ASystemFontIterator_close(ite);
+    }
+    state.SetItemsProcessed(fonts);
+}
+BENCHMARK(BM_SystemFontIteratorNext);
+
+BENCHMARK_MAIN();
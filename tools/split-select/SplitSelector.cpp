@@ -14,10 +14,13 @@
  * limitations under the License.
  */
 
+#include <string.h>
+
 #include <utils/KeyedVector.h>
 #include <utils/SortedVector.h>
 #include <utils/Vector.h>
 
+#include "Abi.h"
 #include "Grouper.h"
 #include "Rule.h"
 #include "RuleGenerator.h"
@@ -27,11 +30,82 @@ namespace split {
 
 using namespace android;
 
+static const size_t kAbiVariantCount = abi::Variant_mips64 + 1;
+
+static uint16_t languageKey(const char language[2]) {
+    return uint8_t(language[0]) | (uint8_t(language[1]) << 8);
+}
+
+static uint16_t packedLanguageKey(const char* language) {
+    ResTable_config config;
+    memset(&config, 0, sizeof(config));
+    config.packLanguage(language);
+    return languageKey(config.language);
+}
+
+// Tagalog and Filipino match each other, see langsAreEquivalent() in ResourceTypes.cpp.
+static uint16_t equivalentLanguageKey(uint16_t key) {
+    static const uint16_t kTagalog = packedLanguageKey("tl");
+    static const uint16_t kFilipino = packedLanguageKey("fil");
+    if (key == kTagalog) {
+        return kFilipino;
+    } else if (key == kFilipino) {
+        return kTagalog;
+    }
+    return key;
+}
+
+static void addToGroupSet(Vector<uint32_t>& set, size_t groupCount, size_t group) {
+    if (set.isEmpty()) {
+        set.insertAt(0u, 0, (groupCount + 31) / 32);
+    }
+    set.editItemAt(group / 32) |= 1u << (group % 32);
+}
+
 SplitSelector::SplitSelector() {
+    buildIndex();
 }
 
 SplitSelector::SplitSelector(const Vector<SplitDescription>& splits)
     : mGroups(groupByMutualExclusivity(splits)) {
+    buildIndex();
+}
+
+void SplitSelector::buildIndex() {
+    const size_t groupCount = mGroups.size();
+    const size_t wordCount = (groupCount + 31) / 32;
+    mAnyLanguageGroups.insertAt(0u, 0, wordCount);
+    mAbiGroups.insertAt(mAnyLanguageGroups, 0, kAbiVariantCount);
+
+    for (size_t i = 0; i < groupCount; i++) {
+        const SortedVector<SplitDescription>& splits = mGroups[i];
+        const size_t splitCount = splits.size();
+        for (size_t j = 0; j < splitCount; j++) {
+            const SplitDescription& split = splits[j];
+
+            // A split with a locale only matches targets of the same language.
+            if (split.config.locale == 0) {
+                addToGroupSet(mAnyLanguageGroups, groupCount, i);
+            } else {
+                const uint16_t key = languageKey(split.config.language);
+                ssize_t idx = mLanguageGroups.indexOfKey(key);
+                if (idx < 0) {
+                    idx = mLanguageGroups.add(key, GroupSet());
+                }
+                addToGroupSet(mLanguageGroups.editValueAt(idx), groupCount, i);
+            }
+
+            // A split with an ABI only matches targets of the same family, and at least
+            // as recent a variant.
+            for (size_t variant = 0; variant < kAbiVariantCount; variant++) {
+                if (split.abi == abi::Variant_none
+                        || (abi::getFamily(split.abi) == abi::getFamily(abi::Variant(variant))
+                                && size_t(split.abi) <= variant)) {
+                    addToGroupSet(mAbiGroups.editItemAt(variant), groupCount, i);
+                }
+            }
+        }
+    }
 }
 
 static void selectBestFromGroup(const SortedVector<SplitDescription>& splits,
@@ -58,9 +132,41 @@ static void selectBestFromGroup(const SortedVector<SplitDescription>& splits,
 
 Vector<SplitDescription> SplitSelector::getBestSplits(const SplitDescription& target) const {
     Vector<SplitDescription> bestSplits;
-    const size_t groupCount = mGroups.size();
-    for (size_t i = 0; i < groupCount; i++) {
-        selectBestFromGroup(mGroups[i], target, bestSplits);
+    if (size_t(target.abi) >= mAbiGroups.size()) {
+        return bestSplits;
+    }
+
+    const GroupSet* languageGroups[2] = {};
+    const uint16_t key = languageKey(target.config.language);
+    ssize_t idx = mLanguageGroups.indexOfKey(key);
+    if (idx >= 0) {
+        languageGroups[0] = &mLanguageGroups.valueAt(idx);
+    }
+    if (equivalentLanguageKey(key) != key) {
+        idx = mLanguageGroups.indexOfKey(equivalentLanguageKey(key));
+        if (idx >= 0) {
+            languageGroups[1] = &mLanguageGroups.valueAt(idx);
+        }
+    }
+
+    // Only the groups that can match both the target's language and ABI are left to compare,
+    // in the same order as mGroups.
+    const GroupSet& abiGroups = mAbiGroups[target.abi];
+    const size_t wordCount = mAnyLanguageGroups.size();
+    for (size_t w = 0; w < wordCount; w++) {
+        uint32_t candidates = mAnyLanguageGroups[w];
+        for (const GroupSet* groups : languageGroups) {
+            if (groups != NULL) {
+                candidates |= (*groups)[w];
+            }
+        }
+        candidates &= abiGroups[w];
+
+        while (candidates != 0) {
+            const int bit = __builtin_ctz(candidates);
+            candidates &= candidates - 1;
+            selectBestFromGroup(mGroups[w * 32 + bit], target, bestSplits);
+        }
     }
     return bestSplits;
 }
@@ -36,7 +36,19 @@ public:
     android::KeyedVector<SplitDescription, android::sp<Rule> > getRules() const;
 
 private:
+    // A set of indices into mGroups, one bit per group.
+    typedef android::Vector<uint32_t> GroupSet;
+
+    void buildIndex();
+
     android::Vector<android::SortedVector<SplitDescription> > mGroups;
+
+    // The groups holding a split that can match a target with a given language or ABI.
+    // getBestSplits() only compares the splits of the groups in both of the sets for its
+    // target, rather than every split.
+    GroupSet mAnyLanguageGroups;
+    android::KeyedVector<uint16_t, GroupSet> mLanguageGroups;
+    android::Vector<GroupSet> mAbiGroups;
 };
 
 } // namespace split
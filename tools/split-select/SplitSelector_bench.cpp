@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include "Grouper.h"
+#include "SplitDescription.h"
+#include "SplitSelector.h"
+#include "TestSplits.h"
+
+using android::SortedVector;
+using android::Vector;
+
+namespace split {
+
+static void BM_SplitSelectorGetBestSplits(benchmark::State& state) {
+    const Vector<SplitDescription> splits = test::makeLargeSplitSet();
+    const Vector<SplitDescription> targets = test::makeTargets();
+    SplitSelector selector(splits);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        Vector<SplitDescription> bestSplits = selector.getBestSplits(targets[i]);
+        benchmark::DoNotOptimize(bestSplits.array());
+        i = (i + 1) % targets.size();
+    }
+}
+BENCHMARK(BM_SplitSelectorGetBestSplits);
+
+// The same selection made by matching every split, for comparison.
+static void BM_SplitSelectorScan(benchmark::State& state) {
+    const Vector<SortedVector<SplitDescription> > groups =
+            groupByMutualExclusivity(test::makeLargeSplitSet());
+    const Vector<SplitDescription> targets = test::makeTargets();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        Vector<SplitDescription> bestSplits = test::selectByScan(groups, targets[i]);
+        benchmark::DoNotOptimize(bestSplits.array());
+        i = (i + 1) % targets.size();
+    }
+}
+BENCHMARK(BM_SplitSelectorScan);
+
+} // namespace split
+
+BENCHMARK_MAIN();
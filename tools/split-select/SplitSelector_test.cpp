@@ -18,9 +18,11 @@
 #include <utils/String8.h>
 #include <utils/Vector.h>
 
+#include "Grouper.h"
 #include "SplitDescription.h"
 #include "SplitSelector.h"
 #include "TestRules.h"
+#include "TestSplits.h"
 
 namespace split {
 
@@ -69,4 +71,70 @@ TEST(SplitSelectorTest, rulesShouldMatchSelection) {
     EXPECT_RULES_EQ(rule, expectedRule);
 }
 
+static ::testing::AssertionResult selectionMatchesScan(const Vector<SplitDescription>& splits,
+        const SplitDescription& target) {
+    Vector<SplitDescription> actual = SplitSelector(splits).getBestSplits(target);
+    Vector<SplitDescription> expected = test::selectByScan(
+            groupByMutualExclusivity(splits), target);
+    if (actual.size() != expected.size()) {
+        return ::testing::AssertionFailure() << target.toString() << ": selected "
+                << actual.size() << " splits, expected " << expected.size();
+    }
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (actual[i] != expected[i]) {
+            return ::testing::AssertionFailure() << target.toString() << ": selected "
+                    << actual[i].toString() << ", expected " << expected[i].toString();
+        }
+    }
+    return ::testing::AssertionSuccess();
+}
+
+TEST(SplitSelectorTest, indexShouldMatchScanOfEverySplit) {
+    Vector<SplitDescription> splits = test::makeLargeSplitSet();
+    ASSERT_EQ(500u, splits.size());
+
+    Vector<SplitDescription> targets = test::makeTargets();
+    for (size_t i = 0; i < targets.size(); i++) {
+        EXPECT_TRUE(selectionMatchesScan(splits, targets[i]));
+    }
+}
+
+TEST(SplitSelectorTest, shouldSelectEquivalentLanguages) {
+    Vector<SplitDescription> splits;
+    ASSERT_TRUE(addSplit(splits, "tl"));
+    ASSERT_TRUE(addSplit(splits, "fr"));
+
+    SplitDescription target;
+    ASSERT_TRUE(SplitDescription::parse(String8("fil-rPH"), &target));
+
+    Vector<SplitDescription> bestSplits = SplitSelector(splits).getBestSplits(target);
+    ASSERT_EQ(1u, bestSplits.size());
+    EXPECT_EQ(String8("tl"), bestSplits[0].toString());
+}
+
+TEST(SplitSelectorTest, shouldSelectOnlyCompatibleAbis) {
+    Vector<SplitDescription> splits;
+    ASSERT_TRUE(addSplit(splits, ":armeabi"));
+    ASSERT_TRUE(addSplit(splits, ":armeabi-v7a"));
+    ASSERT_TRUE(addSplit(splits, ":arm64-v8a"));
+    ASSERT_TRUE(addSplit(splits, ":x86"));
+    ASSERT_TRUE(addSplit(splits, "hdpi"));
+
+    SplitDescription target;
+    ASSERT_TRUE(SplitDescription::parse(String8("hdpi:armeabi-v7a"), &target));
+    EXPECT_TRUE(selectionMatchesScan(splits, target));
+
+    SortedVector<SplitDescription> bestSplits;
+    bestSplits.merge(SplitSelector(splits).getBestSplits(target));
+    ASSERT_EQ(2u, bestSplits.size());
+    EXPECT_EQ(String8("hdpi-v4"), bestSplits[0].toString());
+    EXPECT_EQ(String8(":armeabi-v7a"), bestSplits[1].toString());
+}
+
+TEST(SplitSelectorTest, emptySelectorShouldSelectNothing) {
+    SplitDescription target;
+    ASSERT_TRUE(SplitDescription::parse(String8("en-rUS-xhdpi:x86"), &target));
+    EXPECT_EQ(0u, SplitSelector().getBestSplits(target).size());
+}
+
 } // namespace split
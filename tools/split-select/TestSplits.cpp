@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "TestSplits.h"
+
+#include <utils/String8.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using android::SortedVector;
+using android::String8;
+using android::Vector;
+
+namespace split {
+namespace test {
+
+static const char* kDensities[] = {
+    "ldpi", "mdpi", "tvdpi", "hdpi", "xhdpi", "xxhdpi", "xxxhdpi",
+};
+
+static const char* kAbis[] = {
+    "armeabi", "armeabi-v7a", "arm64-v8a", "x86", "x86_64", "mips", "mips64",
+};
+
+static const char* kLanguages[] = {
+    "af", "am", "ar", "az", "be", "bg", "bn", "bs", "ca", "cs",
+    "da", "de", "el", "en", "es", "et", "eu", "fa", "fi", "fil",
+    "fr", "gl", "gu", "hi", "hr", "hu", "hy", "in", "is", "it",
+    "iw", "ja", "ka", "kk", "km", "kn", "ko", "ky", "lo", "lt",
+    "lv", "mk", "ml", "mn", "mr", "ms", "my", "nb", "ne", "nl",
+    "pa", "pl", "pt", "ro", "ru", "si", "sk", "sl", "tl", "zh",
+};
+
+static const char* kLocales[] = {
+    "en-rUS", "en-rGB", "fr-rCA", "pt-rBR", "zh-rTW", "es-rUS",
+};
+
+static const size_t kDensityCount = sizeof(kDensities) / sizeof(kDensities[0]);
+static const size_t kAbiCount = sizeof(kAbis) / sizeof(kAbis[0]);
+static const size_t kLanguageCount = sizeof(kLanguages) / sizeof(kLanguages[0]);
+static const size_t kLocaleCount = sizeof(kLocales) / sizeof(kLocales[0]);
+
+static void addSplit(Vector<SplitDescription>& splits, const String8& str) {
+    SplitDescription split;
+    if (!SplitDescription::parse(str, &split)) {
+        fprintf(stderr, "%s is not a valid configuration.\n", str.c_str());
+        abort();
+    }
+    splits.add(split);
+}
+
+Vector<SplitDescription> makeLargeSplitSet() {
+    Vector<SplitDescription> splits;
+    for (size_t i = 0; i < kDensityCount; i++) {
+        addSplit(splits, String8(kDensities[i]));
+    }
+    for (size_t i = 0; i < kAbiCount; i++) {
+        addSplit(splits, String8::format(":%s", kAbis[i]));
+    }
+    for (size_t i = 0; i < kLanguageCount; i++) {
+        addSplit(splits, String8(kLanguages[i]));
+        for (size_t j = 0; j < kDensityCount; j++) {
+            addSplit(splits, String8::format("%s-%s", kLanguages[i], kDensities[j]));
+        }
+    }
+    for (size_t i = 0; i < kLocaleCount; i++) {
+        addSplit(splits, String8(kLocales[i]));
+    }
+    return splits;
+}
+
+Vector<SplitDescription> makeTargets() {
+    static const char* kTargetLocales[] = {
+        "en-rUS", "en-rAU", "fr", "fr-rCA", "tl", "fil", "zh-rTW", "sw",
+    };
+    static const char* kTargetDensities[] = { "mdpi", "xhdpi", "420dpi" };
+    static const char* kTargetAbis[] = { "armeabi-v7a", "arm64-v8a", "x86_64", "mips" };
+
+    Vector<SplitDescription> targets;
+    for (const char* locale : kTargetLocales) {
+        for (const char* density : kTargetDensities) {
+            for (const char* abi : kTargetAbis) {
+                addSplit(targets, String8::format("%s-%s-v21:%s", locale, density, abi));
+            }
+        }
+    }
+    addSplit(targets, String8("xhdpi"));
+    addSplit(targets, String8(":x86"));
+    return targets;
+}
+
+Vector<SplitDescription> selectByScan(const Vector<SortedVector<SplitDescription> >& groups,
+        const SplitDescription& target) {
+    Vector<SplitDescription> bestSplits;
+    const size_t groupCount = groups.size();
+    for (size_t i = 0; i < groupCount; i++) {
+        const SortedVector<SplitDescription>& group = groups[i];
+        ssize_t best = -1;
+        for (size_t j = 0; j < group.size(); j++) {
+            if (group[j].match(target)
+                    && (best < 0 || group[j].isBetterThan(group[best], target))) {
+                best = j;
+            }
+        }
+        if (best >= 0) {
+            bestSplits.add(group[best]);
+        }
+    }
+    return bestSplits;
+}
+
+} // namespace test
+} // namespace split
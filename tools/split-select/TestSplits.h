@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef H_AAPT_SPLIT_TEST_SPLITS
+#define H_AAPT_SPLIT_TEST_SPLITS
+
+#include "SplitDescription.h"
+
+#include <utils/SortedVector.h>
+#include <utils/Vector.h>
+
+namespace split {
+namespace test {
+
+/**
+ * A set of 500 splits shaped like those of a large app: density and ABI splits,
+ * language splits, and density splits for each of a few dozen languages.
+ */
+android::Vector<SplitDescription> makeLargeSplitSet();
+
+/**
+ * Configurations to select splits for, covering the attributes of makeLargeSplitSet().
+ */
+android::Vector<SplitDescription> makeTargets();
+
+/**
+ * Selects the best split of each group by matching every split against the target,
+ * without SplitSelector's index.
+ */
+android::Vector<SplitDescription> selectByScan(
+        const android::Vector<android::SortedVector<SplitDescription> >& groups,
+        const SplitDescription& target);
+
+} // namespace test
+} // namespace split
+
+#endif // H_AAPT_SPLIT_TEST_SPLITS
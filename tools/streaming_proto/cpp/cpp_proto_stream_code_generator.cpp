@@ -0,0 +1,480 @@
+#include "cpp_proto_stream_code_generator.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "Errors.h"
+
+using namespace android::stream_proto;
+using namespace google::protobuf::io;
+using namespace std;
+
+const bool GENERATE_MAPPING = true;
+
+// The values of the generated _FIELD_HASH tables, per line.
+const int HASH_VALUES_PER_LINE = 8;
+
+struct Options {
+    bool typed_writers = false;
+};
+
+static string
+make_filename(const FileDescriptorProto& file_descriptor)
+{
+    return file_descriptor.name() + ".h";
+}
+
+static void
+write_enum(stringstream& text, const EnumDescriptorProto& enu, const string& indent)
+{
+    const int N = enu.value_size();
+    text << indent << "// enum " << enu.name() << endl;
+    for (int i=0; i<N; i++) {
+        const EnumValueDescriptorProto& value = enu.value(i);
+        text << indent << "const int "
+                << make_constant_name(value.name())
+                << " = " << value.number() << ";" << endl;
+    }
+
+    if (GENERATE_MAPPING) {
+        string name = make_constant_name(enu.name());
+        string prefix = name + "_";
+        text << indent << "static const int _ENUM_" << name << "_COUNT = " << N << ";" << endl;
+        text << indent << "static const char* _ENUM_" << name << "_NAMES[" << N << "] = {" << endl;
+        for (int i=0; i<N; i++) {
+            text << indent << INDENT << "\"" << stripPrefix(enu.value(i).name(), prefix) << "\"," << endl;
+        }
+        text << indent << "};" << endl;
+        text << indent << "static const int _ENUM_" << name << "_VALUES[" << N << "] = {" << endl;
+        for (int i=0; i<N; i++) {
+            text << indent << INDENT << make_constant_name(enu.value(i).name()) << "," << endl;
+        }
+        text << indent << "};" << endl;
+    }
+
+    text << endl;
+}
+
+static void
+write_field(stringstream& text, const FieldDescriptorProto& field, const string& indent)
+{
+    string optional_comment = field.label() == FieldDescriptorProto::LABEL_OPTIONAL
+            ? "optional " : "";
+    string repeated_comment = field.label() == FieldDescriptorProto::LABEL_REPEATED
+            ? "repeated " : "";
+    string proto_type = get_proto_type(field);
+    string packed_comment = field.options().packed()
+            ? " [packed=true]" : "";
+    text << indent << "// " << optional_comment << repeated_comment << proto_type << ' '
+            << field.name() << " = " << field.number() << packed_comment << ';' << endl;
+
+    text << indent << "const uint64_t " << make_constant_name(field.name()) << " = 0x";
+
+    ios::fmtflags fmt(text.flags());
+    text << setfill('0') << setw(16) << hex << get_field_id(field);
+    text.flags(fmt);
+
+    text << "LL;" << endl;
+
+    text << endl;
+}
+
+template<typename T>
+static void
+write_hash_values(stringstream& text, const vector<T>& values, const string& indent)
+{
+    const size_t N = values.size();
+    for (size_t i=0; i<N; i++) {
+        if (i % HASH_VALUES_PER_LINE == 0) {
+            text << indent;
+        }
+        text << values[i] << ",";
+        text << ((i % HASH_VALUES_PER_LINE == HASH_VALUES_PER_LINE - 1 || i == N - 1) ? "\n" : " ");
+    }
+}
+
+/**
+ * Writes the perfect hash table of the field names, and _FIELD_ID() to look names up in it.
+ */
+static void
+write_field_name_table(stringstream& text, const DescriptorProto& message, const string& indent)
+{
+    vector<string> names;
+    for (int i=0; i<message.field_size(); i++) {
+        names.push_back(message.field(i).name());
+    }
+    const FieldNameTable table = build_field_name_table(names);
+    const size_t seeds = table.seeds.size();
+    const size_t slots = table.slots.size();
+
+    text << indent << "static const uint32_t _FIELD_HASH_SEEDS[" << seeds << "] = {" << endl;
+    write_hash_values(text, table.seeds, indent + INDENT);
+    text << indent << "};" << endl;
+    text << indent << "static const int _FIELD_HASH_SLOTS[" << slots << "] = {" << endl;
+    write_hash_values(text, table.slots, indent + INDENT);
+    text << indent << "};" << endl;
+    text << indent << "// Returns the id of the field called name, or 0 if there is none." << endl;
+    text << indent << "static inline uint64_t _FIELD_ID(const char* name, size_t size) {" << endl;
+    text << indent << INDENT << "const int i = ::android::stream_proto::find_field_name(name, size, "
+            << "_FIELD_NAMES," << endl;
+    text << indent << INDENT << INDENT << INDENT << "_FIELD_HASH_SEEDS, " << seeds
+            << ", _FIELD_HASH_SLOTS, " << slots << ");" << endl;
+    text << indent << INDENT << "return i < 0 ? 0 : _FIELD_IDS[i];" << endl;
+    text << indent << "}" << endl;
+}
+
+/**
+ * Returns the wire type that ProtoOutputStream writes for the field.
+ */
+static int
+get_wire_type(const FieldDescriptorProto& field)
+{
+    switch (field.type()) {
+        case FieldDescriptorProto::TYPE_DOUBLE:
+        case FieldDescriptorProto::TYPE_FIXED64:
+        case FieldDescriptorProto::TYPE_SFIXED64:
+            return 1;
+        case FieldDescriptorProto::TYPE_FLOAT:
+        case FieldDescriptorProto::TYPE_FIXED32:
+        case FieldDescriptorProto::TYPE_SFIXED32:
+            return 5;
+        case FieldDescriptorProto::TYPE_STRING:
+        case FieldDescriptorProto::TYPE_BYTES:
+        case FieldDescriptorProto::TYPE_MESSAGE:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Returns the encoded tag of the field as the arguments the ProtoOutputStream::writeTagged*
+ * functions take, e.g. "0x52, 1".
+ */
+static string
+make_tag_arguments(const FieldDescriptorProto& field)
+{
+    uint64_t varint = ((uint64_t)(uint32_t)field.number() << 3) | get_wire_type(field);
+    uint64_t tag = 0;
+    int size = 0;
+    do {
+        uint64_t byte = varint & 0x7f;
+        varint >>= 7;
+        if (varint != 0) {
+            byte |= 0x80;
+        }
+        tag |= byte << (8 * size++);
+    } while (varint != 0);
+
+    stringstream result;
+    result << "0x" << hex << tag << dec << ", " << size;
+    return result.str();
+}
+
+/**
+ * Writes the typed write function of a field, which has the same result as calling
+ * ProtoOutputStream::write() with the field id, without looking at the id when it runs.
+ */
+static void
+write_typed_field_writer(stringstream& text, const FieldDescriptorProto& field,
+                         const string& indent)
+{
+    const string name = to_camel_case(field.name());
+    const string tag = make_tag_arguments(field);
+    const string check = "\"" + field.name() + " is a field of type " + get_proto_type(field)
+            + "\"";
+    const string indented = indent + INDENT;
+
+    string value_check;
+    string call;
+    switch (field.type()) {
+        case FieldDescriptorProto::TYPE_DOUBLE:
+            value_check = "::android::util::is_proto_floating_point_v<T>";
+            call = "writeTaggedDouble(" + tag + ", (double)val)";
+            break;
+        case FieldDescriptorProto::TYPE_FLOAT:
+            value_check = "::android::util::is_proto_floating_point_v<T>";
+            call = "writeTaggedFloat(" + tag + ", (float)val)";
+            break;
+        case FieldDescriptorProto::TYPE_INT64:
+        case FieldDescriptorProto::TYPE_UINT64:
+            value_check = "::android::util::is_proto_integer_v<T>";
+            call = "writeTaggedVarint(" + tag + ", (uint64_t)val)";
+            break;
+        case FieldDescriptorProto::TYPE_INT32:
+        case FieldDescriptorProto::TYPE_UINT32:
+        case FieldDescriptorProto::TYPE_ENUM:
+            // Negative values take 5 bytes, as ProtoOutputStream::write() writes them.
+            value_check = "::android::util::is_proto_integer_v<T>";
+            call = "writeTaggedVarint(" + tag + ", (uint32_t)val)";
+            break;
+        case FieldDescriptorProto::TYPE_FIXED64:
+        case FieldDescriptorProto::TYPE_SFIXED64:
+            value_check = "::android::util::is_proto_integer_v<T>";
+            call = "writeTaggedFixed64(" + tag + ", (uint64_t)val)";
+            break;
+        case FieldDescriptorProto::TYPE_FIXED32:
+        case FieldDescriptorProto::TYPE_SFIXED32:
+            value_check = "::android::util::is_proto_integer_v<T>";
+            call = "writeTaggedFixed32(" + tag + ", (uint32_t)val)";
+            break;
+        case FieldDescriptorProto::TYPE_SINT32:
+            value_check = "::android::util::is_proto_integer_v<T>";
+            call = "writeTaggedVarint(" + tag
+                    + ", ((uint32_t)(int32_t)val << 1) ^ (uint32_t)((int32_t)val >> 31))";
+            break;
+        case FieldDescriptorProto::TYPE_SINT64:
+            value_check = "::android::util::is_proto_integer_v<T>";
+            call = "writeTaggedVarint(" + tag
+                    + ", ((uint64_t)(int64_t)val << 1) ^ (uint64_t)((int64_t)val >> 63))";
+            break;
+        case FieldDescriptorProto::TYPE_BOOL:
+            value_check = "std::is_same_v<T, bool>";
+            call = "writeTaggedVarint(" + tag + ", val ? 1 : 0)";
+            break;
+        case FieldDescriptorProto::TYPE_STRING:
+            text << indent << "bool write" << name << "(std::string_view val) {" << endl;
+            text << indented << "return mProto->writeTaggedBytes(" << tag
+                    << ", val.data(), val.size());" << endl;
+            text << indent << "}" << endl;
+            return;
+        case FieldDescriptorProto::TYPE_BYTES:
+            text << indent << "bool write" << name << "(const char* val, size_t size) {" << endl;
+            text << indented << "return mProto->writeTaggedBytes(" << tag << ", val, size);" << endl;
+            text << indent << "}" << endl;
+            return;
+        case FieldDescriptorProto::TYPE_MESSAGE:
+            text << indent << "uint64_t start" << name << "() {" << endl;
+            text << indented << "return mProto->start(" << make_constant_name(field.name()) << ");"
+                    << endl;
+            text << indent << "}" << endl;
+            return;
+        default:
+            // Groups, which ProtoOutputStream can't write either.
+            text << indent << "// not supported by ProtoOutputStream" << endl;
+            return;
+    }
+
+    text << indent << "template<typename T>" << endl;
+    text << indent << "bool write" << name << "(T val) {" << endl;
+    text << indented << "static_assert(" << value_check << ", " << check << ");" << endl;
+    text << indented << "return mProto->" << call << ";" << endl;
+    text << indent << "}" << endl;
+}
+
+/**
+ * Writes the Writer class of a message, with a typed write function per field.
+ */
+static void
+write_typed_writer(stringstream& text, const DescriptorProto& message, const string& indent)
+{
+    for (int i=0; i<message.nested_type_size(); i++) {
+        if (message.nested_type(i).name() == "Writer") {
+            ERRORS.Add(UNKNOWN_FILE, UNKNOWN_LINE,
+                    "Message '%s' has a nested message called Writer, which conflicts with its "
+                    "typed writer.", message.name().c_str());
+        }
+    }
+    for (int i=0; i<message.enum_type_size(); i++) {
+        if (message.enum_type(i).name() == "Writer") {
+            ERRORS.Add(UNKNOWN_FILE, UNKNOWN_LINE,
+                    "Message '%s' has an enum called Writer, which conflicts with its "
+                    "typed writer.", message.name().c_str());
+        }
+    }
+
+    const string indented = indent + INDENT;
+    text << indent << "// Writes the fields of a " << message.name()
+            << " to a ProtoOutputStream, with their tags encoded already." << endl;
+    text << indent << "class Writer {" << endl;
+    text << indent << "public:" << endl;
+    text << indented << "explicit Writer(::android::util::ProtoOutputStream* proto) "
+            << ": mProto(proto) {}" << endl;
+    text << endl;
+
+    const int N = message.field_size();
+    for (int i=0; i<N; i++) {
+        const FieldDescriptorProto& field = message.field(i);
+        text << indented << "// " << get_proto_type(field) << " " << field.name() << " = "
+                << field.number() << endl;
+        write_typed_field_writer(text, field, indented);
+        text << endl;
+    }
+
+    text << indented << "void end(uint64_t token) {" << endl;
+    text << indented << INDENT << "mProto->end(token);" << endl;
+    text << indented << "}" << endl;
+    text << endl;
+    text << indent << "private:" << endl;
+    text << indented << "::android::util::ProtoOutputStream* mProto;" << endl;
+    text << indent << "};" << endl;
+    text << endl;
+}
+
+static void
+write_message(stringstream& text, const DescriptorProto& message, const string& indent,
+              const Options& options)
+{
+    int N;
+    const string indented = indent + INDENT;
+
+    text << indent << "// message " << message.name() << endl;
+    text << indent << "namespace " << message.name() << " {" << endl;
+
+    // Enums
+    N = message.enum_type_size();
+    for (int i=0; i<N; i++) {
+        write_enum(text, message.enum_type(i), indented);
+    }
+
+    // Nested classes
+    N = message.nested_type_size();
+    for (int i=0; i<N; i++) {
+        write_message(text, message.nested_type(i), indented, options);
+    }
+
+    // Fields
+    N = message.field_size();
+    for (int i=0; i<N; i++) {
+        write_field(text, message.field(i), indented);
+    }
+
+    if (GENERATE_MAPPING) {
+        N = message.field_size();
+        text << indented << "static const int _FIELD_COUNT = " << N << ";" << endl;
+        text << indented << "static const char* _FIELD_NAMES[" << N << "] = {" << endl;
+        for (int i=0; i<N; i++) {
+            text << indented << INDENT << "\"" << message.field(i).name() << "\"," << endl;
+        }
+        text << indented << "};" << endl;
+        text << indented << "static const uint64_t _FIELD_IDS[" << N << "] = {" << endl;
+        for (int i=0; i<N; i++) {
+            text << indented << INDENT << make_constant_name(message.field(i).name()) << "," << endl;
+        }
+        text << indented << "};" << endl;
+        write_field_name_table(text, message, indented);
+        text << endl;
+    }
+
+    if (options.typed_writers) {
+        write_typed_writer(text, message, indented);
+    }
+
+    text << indent << "} //" << message.name() << endl;
+    text << endl;
+}
+
+/**
+ * Writes what the generated code uses to look up the _FIELD_HASH tables. Every generated header
+ * has it, so it is guarded to be defined only once.
+ */
+static void
+write_field_name_lookup(stringstream& text)
+{
+    text << "#ifndef ANDROID_STREAM_PROTO_FIELD_NAME_LOOKUP" << endl;
+    text << "#define ANDROID_STREAM_PROTO_FIELD_NAME_LOOKUP" << endl;
+    text << "namespace android {" << endl;
+    text << "namespace stream_proto {" << endl;
+    text << "// The hash protoc-gen-cppstream built the _FIELD_HASH tables with." << endl;
+    text << "inline uint32_t field_name_hash(const char* name, size_t size, uint32_t seed) {" << endl;
+    text << INDENT << "uint32_t hash = 2166136261u ^ seed;" << endl;
+    text << INDENT << "for (size_t i = 0; i < size; i++) {" << endl;
+    text << INDENT << INDENT << "hash ^= (uint8_t)name[i];" << endl;
+    text << INDENT << INDENT << "hash *= 16777619u;" << endl;
+    text << INDENT << "}" << endl;
+    text << INDENT << "return hash;" << endl;
+    text << "}" << endl;
+    text << "// Returns the index of the field called name in the tables of a message, or -1." << endl;
+    text << "inline int find_field_name(const char* name, size_t size, const char* const names[]," << endl;
+    text << INDENT << INDENT << "const uint32_t seeds[], size_t seedCount, const int slots[], "
+            << "size_t slotCount) {" << endl;
+    text << INDENT << "const uint32_t seed = seeds[field_name_hash(name, size, 0) % seedCount];" << endl;
+    text << INDENT << "const int i = slots[field_name_hash(name, size, seed) % slotCount];" << endl;
+    text << INDENT << "return i >= 0 && strncmp(names[i], name, size) == 0 && names[i][size] == '\\0'"
+            << " ? i : -1;" << endl;
+    text << "}" << endl;
+    text << "} // stream_proto" << endl;
+    text << "} // android" << endl;
+    text << "#endif // ANDROID_STREAM_PROTO_FIELD_NAME_LOOKUP" << endl;
+    text << endl;
+}
+
+static void write_header_file(const string& request_parameter, CodeGeneratorResponse* response,
+                              const FileDescriptorProto& file_descriptor, const Options& options) {
+    stringstream text;
+
+    text << "// Generated by protoc-gen-cppstream. DO NOT MODIFY." << endl;
+    text << "// source: " << file_descriptor.name() << endl << endl;
+
+    string header = "ANDROID_" + replace_string(file_descriptor.name(), '/', '_');
+    header = replace_string(header, '.', '_') + "_stream_h";
+    header = make_constant_name(header);
+
+    text << "#ifndef " << header << endl;
+    text << "#define " << header << endl;
+    text << endl;
+
+    text << "#include <stddef.h>" << endl;
+    text << "#include <stdint.h>" << endl;
+    text << "#include <string.h>" << endl;
+    if (options.typed_writers) {
+        text << endl;
+        text << "#include <string_view>" << endl;
+        text << "#include <android/util/ProtoOutputStream.h>" << endl;
+    }
+    text << endl;
+
+    if (GENERATE_MAPPING) {
+        write_field_name_lookup(text);
+    }
+
+    vector<string> namespaces = split(file_descriptor.package(), '.');
+    for (vector<string>::iterator it = namespaces.begin(); it != namespaces.end(); it++) {
+        text << "namespace " << *it << " {" << endl;
+    }
+    text << endl;
+
+    size_t N;
+    N = file_descriptor.enum_type_size();
+    for (size_t i=0; i<N; i++) {
+        write_enum(text, file_descriptor.enum_type(i), "");
+    }
+
+    N = file_descriptor.message_type_size();
+    for (size_t i=0; i<N; i++) {
+        write_message(text, file_descriptor.message_type(i), "", options);
+    }
+
+    for (vector<string>::reverse_iterator it = namespaces.rbegin(); it != namespaces.rend(); it++) {
+        text << "} // " << *it << endl;
+    }
+
+    text << endl;
+    text << "#endif // " << header << endl;
+
+    if (request_parameter.find("experimental_allow_proto3_optional") != string::npos) {
+        response->set_supported_features(CodeGeneratorResponse::FEATURE_PROTO3_OPTIONAL);
+    }
+    CodeGeneratorResponse::File* file_response = response->add_file();
+    file_response->set_name(make_filename(file_descriptor));
+    file_response->set_content(text.str());
+}
+
+CodeGeneratorResponse generate_cpp_protostream_code(CodeGeneratorRequest request) {
+    CodeGeneratorResponse response;
+
+    Options options;
+    options.typed_writers = request.parameter().find("typed_writers") != string::npos;
+
+    // Build the files we need.
+    const int N = request.proto_file_size();
+    for (int i=0; i<N; i++) {
+        const FileDescriptorProto& file_descriptor = request.proto_file(i);
+        if (should_generate_for_file(request, file_descriptor.name())) {
+            write_header_file(request.parameter(), &response, file_descriptor, options);
+        }
+    }
+
+    return response;
+}
@@ -1,5 +1,7 @@
 #include "stream_proto_utils.h"
 
+#include <algorithm>
+
 namespace android {
 namespace stream_proto {
 
@@ -96,5 +98,74 @@ should_generate_for_file(const CodeGeneratorRequest& request, const string& file
     return false;
 }
 
+uint32_t
+field_name_hash(const string& name, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name) {
+        hash ^= (uint8_t)c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+FieldNameTable
+build_field_name_table(const vector<string>& names)
+{
+    // Hash and displace: sort the names into buckets of about four, and then, from the
+    // fullest bucket down, find a seed that sends all of its names to free slots.
+    const size_t N = names.size();
+    for (size_t slotCount = max<size_t>(N + N / 4, 1); ; slotCount += slotCount / 4 + 1) {
+        FieldNameTable table;
+        table.seeds.assign(max<size_t>((N + 3) / 4, 1), 0);
+        table.slots.assign(slotCount, -1);
+
+        vector<vector<int>> buckets(table.seeds.size());
+        for (size_t i=0; i<N; i++) {
+            buckets[field_name_hash(names[i], 0) % buckets.size()].push_back(i);
+        }
+        vector<size_t> order(buckets.size());
+        for (size_t i=0; i<order.size(); i++) {
+            order[i] = i;
+        }
+        stable_sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        bool placed = true;
+        for (size_t b : order) {
+            const vector<int>& bucket = buckets[b];
+            if (bucket.empty()) {
+                break;
+            }
+            placed = false;
+            for (uint32_t seed = 1; seed < (1u << 16) && !placed; seed++) {
+                vector<size_t> slots;
+                for (int i : bucket) {
+                    size_t slot = field_name_hash(names[i], seed) % slotCount;
+                    if (table.slots[slot] != -1
+                            || find(slots.begin(), slots.end(), slot) != slots.end()) {
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (slots.size() == bucket.size()) {
+                    for (size_t j=0; j<slots.size(); j++) {
+                        table.slots[slots[j]] = bucket[j];
+                    }
+                    table.seeds[b] = seed;
+                    placed = true;
+                }
+            }
+            if (!placed) {
+                break;
+            }
+        }
+        if (placed) {
+            return table;
+        }
+    }
+}
+
 } // stream_proto
 } // android
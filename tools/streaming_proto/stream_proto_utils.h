@@ -1,5 +1,11 @@
+#ifndef ANDROID_STREAM_PROTO_UTILS_H
+#define ANDROID_STREAM_PROTO_UTILS_H
+
 #include <stdint.h>
 
+#include <string>
+#include <vector>
+
 #include "google/protobuf/compiler/plugin.pb.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 
@@ -25,5 +31,29 @@ string get_proto_type(const FieldDescriptorProto& field);
  */
 bool should_generate_for_file(const CodeGeneratorRequest& request, const string& file);
 
+/**
+ * Hash of a field name, FNV-1a with the seed mixed into its offset basis. The generated
+ * headers compute the same hash to look up their field name tables.
+ */
+uint32_t field_name_hash(const string& name, uint32_t seed);
+
+/**
+ * A perfect hash table of the field names of a message. A name goes into bucket
+ * field_name_hash(name, 0) % seeds.size(), and then into slot
+ * field_name_hash(name, seeds[bucket]) % slots.size(), which holds the index of the name, or -1
+ * if no name goes there.
+ */
+struct FieldNameTable {
+    vector<uint32_t> seeds;
+    vector<int> slots;
+};
+
+/**
+ * Builds the perfect hash table of the given names, which must be distinct.
+ */
+FieldNameTable build_field_name_table(const vector<string>& names);
+
 } // stream_proto
 } // android
+
+#endif // ANDROID_STREAM_PROTO_UTILS_H
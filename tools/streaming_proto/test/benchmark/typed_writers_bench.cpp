@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <string>
+
+#include <android/util/ProtoOutputStream.h>
+#include <benchmark/benchmark.h>
+
+#include "frameworks/base/tools/streaming_proto/test/benchmark/typed_writers.proto.h"
+
+using namespace android::stream_proto_benchmark;
+using android::util::ProtoOutputStream;
+
+constexpr int kProcessCount = 500;
+
+static const char* const kNames[] = {"system_server", "com.android.systemui", "surfaceflinger",
+                                     "com.android.phone"};
+
+// Writes the processes with ProtoOutputStream::write(), which looks at the type in the field id
+// of every write.
+static void BM_WriteProcessesGeneric(benchmark::State& state) {
+    ProtoOutputStream proto;
+    for (auto _ : state) {
+        proto.clear();
+        for (int i = 0; i < kProcessCount; i++) {
+            uint64_t token = proto.start(ProcessListProto::PROCESSES);
+            proto.write(ProcessProto::PID, 1000 + i);
+            proto.write(ProcessProto::UID, 10000 + i % 50);
+            proto.write(ProcessProto::NAME, std::string_view(kNames[i % 4]));
+            proto.write(ProcessProto::RSS_KB, (long long)(i * 1024));
+            proto.write(ProcessProto::PSS_KB, (long long)(i * 700));
+            proto.write(ProcessProto::CPU_PERCENT, i * 0.25f);
+            proto.write(ProcessProto::FOREGROUND, i % 7 == 0);
+            proto.write(ProcessProto::OOM_SCORE, i % 1000 - 500);
+            proto.end(token);
+        }
+        benchmark::DoNotOptimize(proto.bytesWritten());
+    }
+    state.SetItemsProcessed(state.iterations() * kProcessCount);
+}
+BENCHMARK(BM_WriteProcessesGeneric);
+
+// Writes the same processes with the typed writers, which have the tags encoded already.
+static void BM_WriteProcessesTyped(benchmark::State& state) {
+    ProtoOutputStream proto;
+    ProcessListProto::Writer list(&proto);
+    ProcessProto::Writer process(&proto);
+    for (auto _ : state) {
+        proto.clear();
+        for (int i = 0; i < kProcessCount; i++) {
+            uint64_t token = list.startProcesses();
+            process.writePid(1000 + i);
+            process.writeUid(10000 + i % 50);
+            process.writeName(kNames[i % 4]);
+            process.writeRssKb(i * 1024);
+            process.writePssKb(i * 700);
+            process.writeCpuPercent(i * 0.25f);
+            process.writeForeground(i % 7 == 0);
+            process.writeOomScore(i % 1000 - 500);
+            list.end(token);
+        }
+        benchmark::DoNotOptimize(proto.bytesWritten());
+    }
+    state.SetItemsProcessed(state.iterations() * kProcessCount);
+}
+BENCHMARK(BM_WriteProcessesTyped);
+
+// Looks up field names as incident_helper does when it parses a table header.
+static void BM_FindFieldByName(benchmark::State& state) {
+    for (auto _ : state) {
+        for (int i = 0; i < ProcessProto::_FIELD_COUNT; i++) {
+            const char* name = ProcessProto::_FIELD_NAMES[i];
+            benchmark::DoNotOptimize(ProcessProto::_FIELD_ID(name, strlen(name)));
+        }
+    }
+}
+BENCHMARK(BM_FindFieldByName);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "cpp/cpp_proto_stream_code_generator.h"
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+static CodeGeneratorRequest create_simple_request() {
+    CodeGeneratorRequest request;
+
+    request.add_file_to_generate("MyTestProtoFile");
+
+    FileDescriptorProto* file_desc = request.add_proto_file();
+    file_desc->set_name("MyTestProtoFile");
+    file_desc->set_package("test.package");
+
+    auto* message = file_desc->add_message_type();
+    message->set_name("MyTestMessage");
+
+    auto* field = message->add_field();
+    field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+    field->set_type(FieldDescriptorProto::TYPE_INT32);
+    field->set_name("my_test_field");
+    field->set_number(1);
+
+    field = message->add_field();
+    field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+    field->set_type(FieldDescriptorProto::TYPE_STRING);
+    field->set_name("my_other_test_field");
+    field->set_number(2);
+
+    field = message->add_field();
+    field->set_label(FieldDescriptorProto::LABEL_REPEATED);
+    field->set_type(FieldDescriptorProto::TYPE_SINT64);
+    field->set_name("my_far_test_field");
+    field->set_number(300);
+
+    return request;
+}
+
+TEST(StreamingProtoCppTest, FieldIds) {
+    CodeGeneratorResponse response = generate_cpp_protostream_code(create_simple_request());
+
+    ASSERT_EQ(response.file_size(), 1);
+    EXPECT_EQ(response.file(0).name(), "MyTestProtoFile.h");
+    const std::string& content = response.file(0).content();
+    EXPECT_THAT(content, HasSubstr("namespace MyTestMessage {"));
+    EXPECT_THAT(content, HasSubstr("const uint64_t MY_TEST_FIELD = 0x0000010500000001LL;"));
+    EXPECT_THAT(content, HasSubstr("const uint64_t MY_FAR_TEST_FIELD = 0x000002120000012cLL;"));
+    EXPECT_THAT(content, HasSubstr("static const char* _FIELD_NAMES[3]"));
+    EXPECT_THAT(content, HasSubstr("static inline uint64_t _FIELD_ID(const char* name, size_t size)"));
+    EXPECT_THAT(content, Not(HasSubstr("class Writer")));
+    EXPECT_THAT(content, Not(HasSubstr("ProtoOutputStream.h")));
+}
+
+TEST(StreamingProtoCppTest, TypedWriters) {
+    CodeGeneratorRequest request = create_simple_request();
+    request.set_parameter("typed_writers");
+    CodeGeneratorResponse response = generate_cpp_protostream_code(request);
+
+    ASSERT_EQ(response.file_size(), 1);
+    const std::string& content = response.file(0).content();
+    EXPECT_THAT(content, HasSubstr("#include <android/util/ProtoOutputStream.h>"));
+    EXPECT_THAT(content, HasSubstr("class Writer {"));
+    EXPECT_THAT(content, HasSubstr("bool writeMyTestField(T val) {"));
+    EXPECT_THAT(content, HasSubstr("mProto->writeTaggedVarint(0x8, 1, (uint32_t)val)"));
+    EXPECT_THAT(content, HasSubstr("bool writeMyOtherTestField(std::string_view val) {"));
+    EXPECT_THAT(content, HasSubstr("mProto->writeTaggedBytes(0x12, 1, val.data(), val.size())"));
+    // Field 300 with the varint wire type is the tag 0xe0 0x12.
+    EXPECT_THAT(content, HasSubstr("mProto->writeTaggedVarint(0x12e0, 2, "));
+}
+
+TEST(StreamingProtoCppTest, FieldNameTableFindsEveryName) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; i++) {
+        names.push_back("field_" + std::to_string(i));
+    }
+    FieldNameTable table = build_field_name_table(names);
+
+    for (size_t i = 0; i < names.size(); i++) {
+        uint32_t seed = table.seeds[field_name_hash(names[i], 0) % table.seeds.size()];
+        int slot = table.slots[field_name_hash(names[i], seed) % table.slots.size()];
+        ASSERT_EQ(slot, (int)i) << names[i];
+    }
+}